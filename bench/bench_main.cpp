@@ -0,0 +1,922 @@
+// Microbenchmarks for the load, save and lookup paths.
+//
+//   ./wms_bench --benchmark_out=results.json --benchmark_out_format=json
+//   python3 compare.py baseline.json results.json
+//
+// Set WMS_BENCH_SCALE to multiply every dataset size.
+
+#include <benchmark/benchmark.h>
+#include "product.h"
+#include "order.h"
+#include "staff.h"
+#include "supplier.h"
+#include "reports.h"
+#include "metrics.h"
+#include "data_generator.h"
+#include "codec.h"
+#include "order_export.h"
+#include "product_index.h"
+#include "order_store.h"
+#include "warehouse_stock.h"
+#include "fulfillment.h"
+#include "event_log.h"
+#include <thread>
+#include "storage.h"
+#include "id_sequence.h"
+#include <filesystem>
+#include <random>
+#include <sstream>
+
+using namespace std;
+
+static DataGenerator generator;
+
+// Dataset sizes 1k, 10k and 100k, times WMS_BENCH_SCALE
+static void scaledSizes(benchmark::internal::Benchmark* bench) {
+    for (long size : {1000L, 10000L, 100000L}) bench->Arg(size * DataGenerator::scale());
+}
+
+// Orders carry three items each, so keep the order datasets smaller
+static void orderSizes(benchmark::internal::Benchmark* bench) {
+    for (long size : {1000L, 5000L, 20000L}) bench->Arg(size * DataGenerator::scale());
+}
+
+// ========== Load paths ==========
+static void BM_ProductLoadAll(benchmark::State& state) {
+    string filename = generator.products(state.range(0));
+    for (auto _ : state) {
+        vector<Product> products = Product::loadAllFromFile(filename);
+        benchmark::DoNotOptimize(products.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ProductLoadAll)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_OrderLoadAll(benchmark::State& state) {
+    string filename = generator.orders(state.range(0));
+    string itemsFilename = generator.orderItems(state.range(0));
+    for (auto _ : state) {
+        vector<Order> orders = Order::loadAllFromFile(filename, itemsFilename);
+        benchmark::DoNotOptimize(orders.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OrderLoadAll)->Apply(orderSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_StaffLoadAll(benchmark::State& state) {
+    string filename = generator.staff(state.range(0));
+    for (auto _ : state) {
+        vector<Staff> staffList = Staff::loadAllFromFile(filename);
+        benchmark::DoNotOptimize(staffList.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StaffLoadAll)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_SupplierLoadAll(benchmark::State& state) {
+    string filename = generator.suppliers(state.range(0));
+    for (auto _ : state) {
+        vector<Supplier> suppliers = Supplier::loadAllFromFile(filename);
+        benchmark::DoNotOptimize(suppliers.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SupplierLoadAll)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+// ========== Lookup paths ==========
+static void BM_SearchByName(benchmark::State& state) {
+    vector<Product> products = Product::loadAllFromFile(generator.products(state.range(0)));
+    for (auto _ : state) {
+        vector<Product> results = Product::searchByName(products, "premium drill");
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SearchByName)->Apply(scaledSizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_FindProductIndexByID(benchmark::State& state) {
+    vector<Product> products = Product::loadAllFromFile(generator.products(state.range(0)));
+    int lastID = products.back().getID();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Product::findIndexByID(products, lastID));
+    }
+}
+BENCHMARK(BM_FindProductIndexByID)->Apply(scaledSizes)->Unit(benchmark::kMicrosecond);
+
+// ========== On-disk product indexes ==========
+
+// Opening a catalog whose indexes are current: a stat and two header reads
+static void BM_ProductIndexOpen(benchmark::State& state) {
+    string filename = generator.products(state.range(0));
+    ProductIndex(filename).size();  // build once, outside the timing
+    for (auto _ : state) {
+        ProductIndex index(filename);
+        benchmark::DoNotOptimize(index.size());
+    }
+}
+BENCHMARK(BM_ProductIndexOpen)->Apply(scaledSizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_ProductIndexFindByID(benchmark::State& state) {
+    ProductIndex index(generator.products(state.range(0)));
+    mt19937 random(42);
+    uniform_int_distribution<int> pick(1, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        Product product;
+        benchmark::DoNotOptimize(index.findByID(pick(random), product));
+    }
+    state.counters["hit_ratio"] = static_cast<double>(index.cacheHits()) / (index.cacheHits() + index.cacheMisses());
+}
+BENCHMARK(BM_ProductIndexFindByID)->Apply(scaledSizes)->Unit(benchmark::kMicrosecond);
+
+// The indexed counterpart of BM_SearchByName, by name prefix
+static void BM_ProductIndexNamePrefix(benchmark::State& state) {
+    ProductIndex index(generator.products(state.range(0)));
+    for (auto _ : state) {
+        vector<Product> results;
+        index.scanNamePrefix("premium drill", [&results](Product& product) {
+            results.push_back(move(product));
+            return true;
+        });
+        benchmark::DoNotOptimize(results.data());
+    }
+}
+BENCHMARK(BM_ProductIndexNamePrefix)->Apply(scaledSizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_StaffFindByUsername(benchmark::State& state) {
+    string filename = generator.staff(state.range(0));
+    string lastUser = "user" + to_string(state.range(0));
+    for (auto _ : state) {
+        Staff staff = Staff::findByUsername(filename, lastUser);
+        benchmark::DoNotOptimize(staff.getID());
+    }
+}
+BENCHMARK(BM_StaffFindByUsername)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_SupplierFindByUsername(benchmark::State& state) {
+    string filename = generator.suppliers(state.range(0));
+    string lastUser = "supplier" + to_string(state.range(0));
+    for (auto _ : state) {
+        Supplier supplier = Supplier::findByUsername(filename, lastUser);
+        benchmark::DoNotOptimize(supplier.getID());
+    }
+}
+BENCHMARK(BM_SupplierFindByUsername)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+// ========== Rewrite paths ==========
+static void BM_ProductSaveAll(benchmark::State& state) {
+    vector<Product> products = Product::loadAllFromFile(generator.products(state.range(0)));
+    string scratch = generator.scratch("products");
+    for (auto _ : state) {
+        Product::saveAllToFile(scratch, products);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ProductSaveAll)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+// The operator<< rewrite the entities used before CsvWriter
+static void BM_ProductSaveAllByHand(benchmark::State& state) {
+    vector<Product> products = Product::loadAllFromFile(generator.products(state.range(0)));
+    string scratch = generator.scratch("products");
+    for (auto _ : state) {
+        ofstream file(scratch);
+        for (const auto& p : products) {
+            file << p.getID() << "," << p.getName() << "," << p.getPrice() << "," << p.getQuantity() << ","
+                 << p.getCategory() << "," << p.getDescription() << "\n";
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ProductSaveAllByHand)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_OrderSaveAll(benchmark::State& state) {
+    vector<Order> orders = Order::loadAllFromFile(generator.orders(state.range(0)), generator.orderItems(state.range(0)));
+    string scratch = generator.scratch("orders");
+    for (auto _ : state) {
+        Order::saveAllToFile(scratch, orders);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OrderSaveAll)->Apply(orderSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_StaffSaveAll(benchmark::State& state) {
+    vector<Staff> staffList = Staff::loadAllFromFile(generator.staff(state.range(0)));
+    string scratch = generator.scratch("staff");
+    for (auto _ : state) {
+        Staff::saveAllToFile(scratch, staffList);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StaffSaveAll)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_SupplierSaveAll(benchmark::State& state) {
+    vector<Supplier> suppliers = Supplier::loadAllFromFile(generator.suppliers(state.range(0)));
+    string scratch = generator.scratch("suppliers");
+    for (auto _ : state) {
+        Supplier::saveAllToFile(scratch, suppliers);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SupplierSaveAll)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+// ========== Codecs (in memory, no file I/O) ==========
+// The hand-written operator<< / getline+stoi row code the entities used
+// before the field tables, kept here as the reference point
+static void writeProductByHand(ostream& out, const Product& p) {
+    out << p.getID() << "," << p.getName() << "," << p.getPrice() << "," << p.getQuantity() << ","
+        << p.getCategory() << "," << p.getDescription() << "\n";
+}
+
+static void readProductByHand(const string& line, string& name, float& price, int& quantity, string& category, string& description) {
+    stringstream ss(line);
+    string field;
+    getline(ss, field, ',');
+    benchmark::DoNotOptimize(stoi(field));
+    getline(ss, name, ',');
+    getline(ss, field, ',');
+    price = stof(field);
+    getline(ss, field, ',');
+    quantity = stoi(field);
+    getline(ss, category, ',');
+    getline(ss, description);
+}
+
+template <typename WriteAll>
+static void encodeProducts(benchmark::State& state, WriteAll writeAll) {
+    vector<Product> products = Product::loadAllFromFile(generator.products(state.range(0)));
+    for (auto _ : state) {
+        ostringstream out;
+        writeAll(out, products);
+        benchmark::DoNotOptimize(out.tellp());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ProductEncodeByHand(benchmark::State& state) {
+    encodeProducts(state, [](ostream& out, const vector<Product>& products) {
+        for (const auto& product : products) writeProductByHand(out, product);
+    });
+}
+BENCHMARK(BM_ProductEncodeByHand)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_ProductEncodeCsv(benchmark::State& state) {
+    encodeProducts(state, CsvFormat::writeAll<Product>);
+}
+BENCHMARK(BM_ProductEncodeCsv)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_ProductEncodeBinary(benchmark::State& state) {
+    encodeProducts(state, BinaryFormat::writeAll<Product>);
+}
+BENCHMARK(BM_ProductEncodeBinary)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+template <typename Format>
+static string encodedProducts(size_t count) {
+    ostringstream out;
+    Format::template writeAll<Product>(out, Product::loadAllFromFile(generator.products(count)));
+    return out.str();
+}
+
+static void BM_ProductDecodeByHand(benchmark::State& state) {
+    string encoded = encodedProducts<CsvFormat>(state.range(0));
+    string name, category, description;
+    float price;
+    int quantity;
+    for (auto _ : state) {
+        istringstream in(encoded);
+        string line;
+        while (getline(in, line)) {
+            readProductByHand(line, name, price, quantity, category, description);
+            benchmark::DoNotOptimize(quantity);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ProductDecodeByHand)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+template <typename Format>
+static void decodeProducts(benchmark::State& state) {
+    string encoded = encodedProducts<Format>(state.range(0));
+    Product product;
+    for (auto _ : state) {
+        istringstream in(encoded);
+        typename Format::Reader reader(in);
+        while (reader.template read<Product>(product) != READ_END) {
+            benchmark::DoNotOptimize(product.getQuantity());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ProductDecodeCsv(benchmark::State& state) {
+    decodeProducts<CsvFormat>(state);
+}
+BENCHMARK(BM_ProductDecodeCsv)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_ProductDecodeBinary(benchmark::State& state) {
+    decodeProducts<BinaryFormat>(state);
+}
+BENCHMARK(BM_ProductDecodeBinary)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+// ========== CSV parsing throughput ==========
+// Generated products as CSV text; with `quoted`, every description holds
+// commas and escaped quotes so each row takes the quoted path
+static string productsCsv(size_t count, bool quoted) {
+    vector<Product> products = Product::loadAllFromFile(generator.products(count));
+    if (quoted) {
+        for (auto& product : products) product.setDescription("Box of 12, \"heavy duty\", " + product.getDescription());
+    }
+    ostringstream out;
+    CsvFormat::writeAll(out, products);
+    return out.str();
+}
+
+static void parseCsv(benchmark::State& state, bool quoted) {
+    string text = productsCsv(state.range(0), quoted);
+    for (auto _ : state) {
+        istringstream in(text);
+        CsvReader reader(in);
+        size_t fields = 0;
+        while (reader.next()) fields += reader.size();
+        benchmark::DoNotOptimize(fields);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+static void BM_CsvParseUnquoted(benchmark::State& state) {
+    parseCsv(state, false);
+}
+BENCHMARK(BM_CsvParseUnquoted)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_CsvParseQuoted(benchmark::State& state) {
+    parseCsv(state, true);
+}
+BENCHMARK(BM_CsvParseQuoted)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+// The getline splitting the loaders used before CsvReader
+static void BM_CsvParseGetline(benchmark::State& state) {
+    string text = productsCsv(state.range(0), false);
+    for (auto _ : state) {
+        istringstream in(text);
+        string line, field;
+        size_t fields = 0;
+        while (getline(in, line)) {
+            stringstream ss(line);
+            while (getline(ss, field, ',')) ++fields;
+        }
+        benchmark::DoNotOptimize(fields);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_CsvParseGetline)->Apply(scaledSizes)->Unit(benchmark::kMillisecond);
+
+// ========== Storage backends ==========
+
+// Dataset sizes 1k and 10k: the CSV backend answers every lookup with a scan
+static void storageSizes(benchmark::internal::Benchmark* bench) {
+    for (long size : {1000L, 10000L}) bench->Arg(size * DataGenerator::scale());
+}
+
+// Batches of 100 operations on the staff table: 60 lookups by ID, 20 by
+// username (the login path) and 20 appends. Appends accumulate, so later
+// iterations see a slightly larger table on both backends.
+static void mixedWorkload(benchmark::State& state, StorageBackend<Staff>& backend) {
+    size_t count = state.range(0);
+    mt19937 random(42);
+    uniform_int_distribution<int> pick(1, static_cast<int>(count));
+    Staff newcomer("newcomer", "secret", "New Staff", "555-0000", "new@bms.com", STAFF);
+
+    for (auto _ : state) {
+        for (int op = 0; op < 100; ++op) {
+            Staff record;
+            if (op % 5 < 3) {
+                benchmark::DoNotOptimize(backend.findByKey(pick(random), record));
+            } else if (op % 5 == 3) {
+                benchmark::DoNotOptimize(backend.findBy("username", "user" + to_string(pick(random)), record));
+            } else {
+                backend.append(newcomer);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 100);
+}
+
+static void BM_StorageMixedCsv(benchmark::State& state) {
+    string filename = generator.scratch("storage");
+    filesystem::copy_file(generator.staff(state.range(0)), filename, filesystem::copy_options::overwrite_existing);
+    CsvBackend<Staff> backend(filename);
+    mixedWorkload(state, backend);
+}
+BENCHMARK(BM_StorageMixedCsv)->Apply(storageSizes)->Unit(benchmark::kMillisecond);
+
+#ifdef WMS_SQLITE
+static void BM_StorageMixedSqlite(benchmark::State& state) {
+    SqliteDatabase db;
+    db.open(generator.scratch("storage", ".db"));
+    SqliteBackend<Staff> backend(db, "staff");
+    backend.saveAll(Staff::loadAllFromFile(generator.staff(state.range(0))));
+    mixedWorkload(state, backend);
+}
+BENCHMARK(BM_StorageMixedSqlite)->Apply(storageSizes)->Unit(benchmark::kMillisecond);
+#endif
+
+static void BM_StorageSaveAllCsv(benchmark::State& state) {
+    vector<Staff> staffList = Staff::loadAllFromFile(generator.staff(state.range(0)));
+    CsvBackend<Staff> backend(generator.scratch("storage"));
+    for (auto _ : state) {
+        backend.saveAll(staffList);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StorageSaveAllCsv)->Apply(storageSizes)->Unit(benchmark::kMillisecond);
+
+#ifdef WMS_SQLITE
+static void BM_StorageSaveAllSqlite(benchmark::State& state) {
+    vector<Staff> staffList = Staff::loadAllFromFile(generator.staff(state.range(0)));
+    SqliteDatabase db;
+    db.open(generator.scratch("storage", ".db"));
+    SqliteBackend<Staff> backend(db, "staff");
+    for (auto _ : state) {
+        backend.saveAll(staffList);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StorageSaveAllSqlite)->Apply(storageSizes)->Unit(benchmark::kMillisecond);
+#endif
+
+// The CSV counterpart is BM_StaffLoadAll
+#ifdef WMS_SQLITE
+static void BM_StorageLoadAllSqlite(benchmark::State& state) {
+    SqliteDatabase db;
+    db.open(generator.scratch("storage", ".db"));
+    SqliteBackend<Staff> backend(db, "staff");
+    backend.saveAll(Staff::loadAllFromFile(generator.staff(state.range(0))));
+    for (auto _ : state) {
+        vector<Staff> staffList = backend.loadAll();
+        benchmark::DoNotOptimize(staffList.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StorageLoadAllSqlite)->Apply(storageSizes)->Unit(benchmark::kMillisecond);
+#endif
+
+// ========== LSM order history ==========
+
+// Order counts 100k and 1M, times WMS_BENCH_SCALE
+static void lsmSizes(benchmark::internal::Benchmark* bench) {
+    for (long size : {100000L, 1000000L}) bench->Arg(size * DataGenerator::scale());
+}
+
+// A store holding the generated order headers, built on first use and kept
+// in the scratch directory between runs. Status updates rewrite orders
+// in place, so the contents stay the same size.
+static LsmStore& orderHistory(size_t count) {
+    static map<size_t, unique_ptr<LsmStore>> stores;
+    auto found = stores.find(count);
+    if (found != stores.end()) return *found->second;
+
+    unique_ptr<LsmStore> store(new LsmStore());
+    store->open(generator.scratch("lsm_orders_" + to_string(count), ""));
+    Order last;
+    LsmBackend<Order> backend(*store);
+    if (!backend.findByKey(static_cast<int>(count), last)) {
+        store->clear();
+        backend.appendAll(CsvBackend<Order>(generator.orders(count)).loadAll());
+        store->compact();
+    }
+    return *stores.emplace(count, move(store)).first->second;
+}
+
+// Write amplification of appending the history from empty: bytes logged,
+// flushed and compacted per byte of order data
+static void BM_LsmAppendOrders(benchmark::State& state) {
+    vector<Order> orders = CsvBackend<Order>(generator.orders(state.range(0))).loadAll();
+    LsmStore store;
+    store.open(generator.scratch("lsm_append", ""));
+    LsmBackend<Order> backend(store);
+    for (auto _ : state) {
+        state.PauseTiming();
+        store.clear();
+        state.ResumeTiming();
+        for (size_t first = 0; first < orders.size(); first += 1000) {
+            vector<Order> batch(orders.begin() + first, orders.begin() + min(orders.size(), first + 1000));
+            backend.appendAll(batch);
+        }
+    }
+    LsmStats stats = store.stats();
+    state.counters["write_amp"] = stats.writeAmplification();
+    state.counters["runs"] = static_cast<double>(stats.runs);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LsmAppendOrders)->Apply(lsmSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_LsmFindOrder(benchmark::State& state) {
+    LsmBackend<Order> backend(orderHistory(state.range(0)));
+    mt19937 random(42);
+    uniform_int_distribution<int> pick(1, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        Order order;
+        benchmark::DoNotOptimize(backend.findByKey(pick(random), order));
+    }
+}
+BENCHMARK(BM_LsmFindOrder)->Apply(lsmSizes)->Unit(benchmark::kMicrosecond);
+
+// Lookups of IDs past the end, answered by the bloom filters
+static void BM_LsmFindMissingOrder(benchmark::State& state) {
+    LsmBackend<Order> backend(orderHistory(state.range(0)));
+    int next = static_cast<int>(state.range(0)) + 1;
+    for (auto _ : state) {
+        Order order;
+        benchmark::DoNotOptimize(backend.findByKey(next++, order));
+    }
+}
+BENCHMARK(BM_LsmFindMissingOrder)->Apply(lsmSizes)->Unit(benchmark::kMicrosecond);
+
+// 100 consecutive orders from a random starting ID
+static void BM_LsmScanOrders(benchmark::State& state) {
+    LsmStore& store = orderHistory(state.range(0));
+    mt19937 random(42);
+    uniform_int_distribution<int> pick(1, static_cast<int>(state.range(0)) - 100);
+    for (auto _ : state) {
+        int first = pick(random);
+        size_t seen = 0;
+        store.scan(LsmBackend<Order>::storeKey(first, 0), LsmBackend<Order>::storeKey(first + 100, 0), [&seen](uint64_t, string_view) {
+            ++seen;
+            return true;
+        });
+        benchmark::DoNotOptimize(seen);
+    }
+    state.SetItemsProcessed(state.iterations() * 100);
+}
+BENCHMARK(BM_LsmScanOrders)->Apply(lsmSizes)->Unit(benchmark::kMicrosecond);
+
+// A status change is one small write to the LSM store, where the CSV file
+// is rewritten whole
+static void statusUpdates(benchmark::State& state, StorageBackend<Order>& backend) {
+    mt19937 random(42);
+    uniform_int_distribution<int> pick(1, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        Order order;
+        backend.findByKey(pick(random), order);
+        order.setStatus(static_cast<OrderStatus>(1 + random() % 5));
+        benchmark::DoNotOptimize(backend.update(order));
+    }
+}
+
+static void BM_OrderStatusUpdateCsv(benchmark::State& state) {
+    string filename = generator.scratch("status");
+    filesystem::copy_file(generator.orders(state.range(0)), filename, filesystem::copy_options::overwrite_existing);
+    CsvBackend<Order> backend(filename);
+    statusUpdates(state, backend);
+}
+BENCHMARK(BM_OrderStatusUpdateCsv)->Apply(storageSizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_OrderStatusUpdateLsm(benchmark::State& state) {
+    LsmBackend<Order> backend(orderHistory(state.range(0)));
+    statusUpdates(state, backend);
+}
+BENCHMARK(BM_OrderStatusUpdateLsm)->Apply(lsmSizes)->Unit(benchmark::kMicrosecond);
+
+// ========== Order cache ==========
+
+// Random lookups after touching every order once; with a budget of 0 each
+// one faults in from the indexed files, the default keeps them all resident
+static void findOrders(benchmark::State& state, size_t budgetBytes) {
+    string filename = generator.orders(state.range(0));
+    OrderStore store(filename, generator.orderItems(state.range(0)), budgetBytes);
+    mt19937 random(42);
+    uniform_int_distribution<int> pick(1, static_cast<int>(state.range(0)));
+    for (int id = 1; id <= state.range(0); ++id) store.find(id);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(store.find(pick(random)));
+    }
+}
+
+static void BM_OrderStoreFindCold(benchmark::State& state) {
+    findOrders(state, 0);
+}
+BENCHMARK(BM_OrderStoreFindCold)->Apply(orderSizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_OrderStoreFindHot(benchmark::State& state) {
+    findOrders(state, ORDER_CACHE_BYTES);
+}
+BENCHMARK(BM_OrderStoreFindHot)->Apply(orderSizes)->Unit(benchmark::kMicrosecond);
+
+// Status changes overwrite the row in place and keep the indexes
+static void BM_OrderStoreStatusUpdate(benchmark::State& state) {
+    string filename = generator.scratch("store_status");
+    filesystem::copy_file(generator.orders(state.range(0)), filename, filesystem::copy_options::overwrite_existing);
+    OrderStore store(filename, generator.orderItems(state.range(0)));
+    mt19937 random(42);
+    uniform_int_distribution<int> pick(1, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        Order order = *store.find(pick(random));
+        order.setStatus(static_cast<OrderStatus>(1 + random() % 5));
+        benchmark::DoNotOptimize(store.update(order));
+    }
+}
+BENCHMARK(BM_OrderStoreStatusUpdate)->Apply(orderSizes)->Unit(benchmark::kMicrosecond);
+
+// ========== Bulk status updates ==========
+
+const long BULK_ORDERS = 100000;
+
+static string bulkOrders(const char* name) {
+    string filename = generator.scratch(name);
+    filesystem::copy_file(generator.orders(BULK_ORDERS * DataGenerator::scale()), filename,
+                          filesystem::copy_options::overwrite_existing);
+    return filename;
+}
+
+// Every order given a new status one update() at a time, as the menus did:
+// a lookup, then an in-place write and an index restamp per order
+static void BM_StatusUpdatesPerOrder(benchmark::State& state) {
+    long count = BULK_ORDERS * DataGenerator::scale();
+    OrderStore store(bulkOrders("bulk_single"), generator.orderItems(count));
+    int round = 0;
+    for (auto _ : state) {
+        OrderStatus status = static_cast<OrderStatus>(1 + round++ % 5);
+        for (int id = 1; id <= count; ++id) {
+            Order order = *store.find(id);
+            order.setStatus(status);
+            benchmark::DoNotOptimize(store.update(order));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_StatusUpdatesPerOrder)->Unit(benchmark::kMillisecond);
+
+// The same changes in one setStatuses() batch
+static void BM_StatusUpdatesBulk(benchmark::State& state) {
+    long count = BULK_ORDERS * DataGenerator::scale();
+    OrderStore store(bulkOrders("bulk_batch"), generator.orderItems(count));
+    vector<pair<int, OrderStatus>> changes(count);
+    int round = 0;
+    for (auto _ : state) {
+        OrderStatus status = static_cast<OrderStatus>(1 + round++ % 5);
+        for (int id = 1; id <= count; ++id) changes[id - 1] = {id, status};
+        benchmark::DoNotOptimize(store.setStatuses(changes));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_StatusUpdatesBulk)->Unit(benchmark::kMillisecond);
+
+// ========== Export ==========
+
+// Streams the orders joined with their items straight from disk
+static void exportOrders(benchmark::State& state, ExportFormat format) {
+    string orders = generator.orders(state.range(0));
+    string items = generator.orderItems(state.range(0));
+    string scratch = generator.scratch("export");
+    for (auto _ : state) {
+        ExportStats stats = OrderExport::run(orders, items, scratch, format);
+        benchmark::DoNotOptimize(stats.itemsExported);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_OrderExportCsv(benchmark::State& state) {
+    exportOrders(state, EXPORT_CSV);
+}
+BENCHMARK(BM_OrderExportCsv)->Apply(orderSizes)->Unit(benchmark::kMillisecond);
+
+static void BM_OrderExportJsonl(benchmark::State& state) {
+    exportOrders(state, EXPORT_JSONL);
+}
+BENCHMARK(BM_OrderExportJsonl)->Apply(orderSizes)->Unit(benchmark::kMillisecond);
+
+// ========== Reports (thread scaling) ==========
+static void BM_ReportTopProducts(benchmark::State& state) {
+    static vector<Order> orders = Order::loadAllFromFile(generator.orders(20000 * DataGenerator::scale()),
+                                                         generator.orderItems(20000 * DataGenerator::scale()));
+    for (auto _ : state) {
+        vector<ProductSales> top = Reports::topProducts(orders, 10, state.range(0));
+        benchmark::DoNotOptimize(top.data());
+    }
+    state.SetItemsProcessed(state.iterations() * orders.size());
+}
+BENCHMARK(BM_ReportTopProducts)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ========== Warehouse stock ==========
+
+const int BENCH_WAREHOUSES = 8;
+
+// `count` products spread over BENCH_WAREHOUSES sites on a line
+static WarehouseStock& stockMatrix(size_t count) {
+    static map<size_t, unique_ptr<WarehouseStock>> matrices;
+    auto found = matrices.find(count);
+    if (found != matrices.end()) return *found->second;
+
+    unique_ptr<WarehouseStock> stock(new WarehouseStock());
+    for (int w = 1; w <= BENCH_WAREHOUSES; ++w) stock->addWarehouse(Warehouse{w, "Site " + to_string(w), 10.0f * w, 0.0f});
+    for (size_t id = 1; id <= count; ++id) {
+        for (int w = 1; w <= BENCH_WAREHOUSES; ++w) stock->receive(static_cast<int>(id), w, static_cast<int>((id * w) % 50));
+    }
+    return *matrices.emplace(count, move(stock)).first->second;
+}
+
+// Every product's total over all sites: one vector add per site
+static void BM_StockTotals(benchmark::State& state) {
+    WarehouseStock& stock = stockMatrix(state.range(0));
+    vector<int> productIDs;
+    vector<int32_t> quantities;
+    for (auto _ : state) {
+        stock.totals(productIDs, quantities);
+        benchmark::DoNotOptimize(quantities.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * BENCH_WAREHOUSES);
+}
+BENCHMARK(BM_StockTotals)->Apply(scaledSizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_StockNearestWithStock(benchmark::State& state) {
+    WarehouseStock& stock = stockMatrix(state.range(0));
+    mt19937 random(42);
+    uniform_int_distribution<int> pick(1, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stock.nearestWithStock(pick(random), 20, 1));
+    }
+}
+BENCHMARK(BM_StockNearestWithStock)->Apply(scaledSizes)->Unit(benchmark::kNanosecond);
+
+// Each thread moves stock at its own warehouse; shards keep them apart
+static void BM_StockTakeReceive(benchmark::State& state) {
+    WarehouseStock& stock = stockMatrix(10000);
+    int warehouse = 1 + state.thread_index() % BENCH_WAREHOUSES;
+    mt19937 random(state.thread_index());
+    uniform_int_distribution<int> pick(1, 10000);
+    for (auto _ : state) {
+        int id = pick(random);
+        stock.receive(id, warehouse, 1);
+        benchmark::DoNotOptimize(stock.take(id, warehouse, 1));
+    }
+}
+BENCHMARK(BM_StockTakeReceive)->ThreadRange(1, 4)->UseRealTime();
+
+// ========== Fulfillment pipeline ==========
+
+// In-memory throughput: each iteration moves 100k fresh orders from
+// Pending to Processing, split over `producers` threads, and waits for the
+// worker to hand every event to a handler that only counts them
+static void BM_FulfillmentTransitions(benchmark::State& state) {
+    const int batch = 100000;
+    int producers = static_cast<int>(state.range(0));
+    FulfillmentPipeline pipeline;
+    atomic<uint64_t> handled(0);
+    pipeline.subscribe([&handled](const vector<StatusEvent>& events) { handled += events.size(); });
+    pipeline.start();
+
+    int next = 1;
+    for (auto _ : state) {
+        if (next > numeric_limits<int>::max() - batch) {
+            state.SkipWithError("ran out of order IDs");
+            break;
+        }
+        vector<thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&pipeline, p, producers, next]() {
+                for (int id = next + p; id < next + batch; id += producers) {
+                    pipeline.track(id, ORDER_PENDING);
+                    pipeline.transition(id, ORDER_PROCESSING);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        pipeline.flush();
+        next += batch;
+    }
+    benchmark::DoNotOptimize(handled.load());
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_FulfillmentTransitions)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ========== Event log ==========
+
+const long LEDGER_EVENTS = 1000000;
+const time_t LEDGER_START = 1704067200;  // 2024-01-01
+const time_t LEDGER_SPAN = 365 * 86400;
+
+// A year of trading, spread evenly: each order is created, takes its items
+// off the shelf and moves through its statuses, with restocks in between
+static void ledgerEvents(long index, vector<LedgerEvent>& events) {
+    int orderID = static_cast<int>(index / 8 + 1);
+    int productID = static_cast<int>(index % 997 + 1);
+    switch (index % 8) {
+        case 0: events.push_back(EventLog::orderCreated(orderID)); break;
+        case 1: case 2: case 3: events.push_back(EventLog::stockChanged(productID, -2, orderID)); break;
+        case 4: events.push_back(EventLog::statusChanged(orderID, ORDER_PROCESSING)); break;
+        case 5: events.push_back(EventLog::statusChanged(orderID, ORDER_SHIPPED)); break;
+        case 6: events.push_back(EventLog::statusChanged(orderID, ORDER_DELIVERED)); break;
+        default: events.push_back(EventLog::stockChanged(productID, 6)); break;
+    }
+}
+
+// Written once per dataset size and kept between runs
+static string ledgerDirectory() {
+    long count = LEDGER_EVENTS * DataGenerator::scale();
+    string directory = generator.scratch("ledger_" + to_string(count), "");
+    {
+        EventLog existing;
+        if (existing.open(directory) && existing.lastSequence() == static_cast<uint64_t>(count)) return directory;
+    }
+    filesystem::remove_all(directory);
+    EventLog log;
+    log.open(directory);
+    vector<LedgerEvent> batch;
+    for (long i = 0; i < count; i += 64) {
+        batch.clear();
+        for (long j = i; j < min(i + 64, count); ++j) ledgerEvents(j, batch);
+        log.append(batch, LEDGER_START + static_cast<time_t>(LEDGER_SPAN * i / count));
+    }
+    return directory;
+}
+
+// Batches of 64 events, each written out together
+static void BM_EventLogAppend(benchmark::State& state) {
+    string directory = generator.scratch("ledger_append", "");
+    filesystem::remove_all(directory);
+    EventLog log;
+    log.open(directory);
+    vector<LedgerEvent> batch;
+    long index = 0;
+    for (auto _ : state) {
+        batch.clear();
+        for (int j = 0; j < 64; ++j) ledgerEvents(index++, batch);
+        benchmark::DoNotOptimize(log.append(batch));
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_EventLogAppend)->Unit(benchmark::kMicrosecond);
+
+// Stock and statuses at a random moment of the year: the nearest snapshot
+// before it plus the events after
+static void BM_EventLogStateAt(benchmark::State& state) {
+    EventLog log;
+    log.open(ledgerDirectory());
+    mt19937 random(42);
+    uint64_t replayed = 0;
+    for (auto _ : state) {
+        LedgerState past;
+        ReplayStats stats;
+        benchmark::DoNotOptimize(log.stateAt(LEDGER_START + random() % LEDGER_SPAN, past, &stats));
+        replayed += stats.eventsReplayed;
+    }
+    state.counters["replayed"] = benchmark::Counter(static_cast<double>(replayed) / state.iterations());
+}
+BENCHMARK(BM_EventLogStateAt)->Unit(benchmark::kMillisecond);
+
+// The same without snapshots: every event up to the moment, from the start
+static void BM_EventLogReplayAll(benchmark::State& state) {
+    string directory = generator.scratch("ledger_nosnap", "");
+    filesystem::remove_all(directory);
+    filesystem::create_directories(directory);
+    for (const auto& entry : filesystem::directory_iterator(ledgerDirectory())) {
+        string name = entry.path().filename().string();
+        if (name.rfind("segment-", 0) == 0) filesystem::copy(entry.path(), directory + "/" + name);
+    }
+    EventLog log;
+    log.open(directory);
+    mt19937 random(42);
+    uint64_t replayed = 0;
+    for (auto _ : state) {
+        LedgerState past;
+        ReplayStats stats;
+        benchmark::DoNotOptimize(log.stateAt(LEDGER_START + random() % LEDGER_SPAN, past, &stats));
+        replayed += stats.eventsReplayed;
+    }
+    state.counters["replayed"] = benchmark::Counter(static_cast<double>(replayed) / state.iterations());
+}
+BENCHMARK(BM_EventLogReplayAll)->Unit(benchmark::kMillisecond);
+
+// ========== ID allocation ==========
+
+// Threads share one sequence; most calls are a compare-and-swap, one in
+// ID_BLOCK syncs a lease to the sequence file
+static void BM_IdSequenceNext(benchmark::State& state) {
+    static IdSequence sequence;
+    static bool bound = [] {
+        sequence.bind(generator.scratch("sequence", ".ids"), [] { return 0; });
+        return true;
+    }();
+    benchmark::DoNotOptimize(bound);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sequence.next());
+    }
+}
+BENCHMARK(BM_IdSequenceNext)->ThreadRange(1, 4);
+
+// ========== Metrics overhead ==========
+static void BM_CounterIncrement(benchmark::State& state) {
+    static Counter counter("wms_bench_increments_total", "Benchmark counter");
+    for (auto _ : state) {
+        counter.increment();
+    }
+}
+BENCHMARK(BM_CounterIncrement)->ThreadRange(1, 4);
+
+static void BM_ScopedTimer(benchmark::State& state) {
+    static Histogram histogram("wms_bench_seconds", "Benchmark histogram");
+    for (auto _ : state) {
+        ScopedTimer timer(histogram);
+    }
+}
+BENCHMARK(BM_ScopedTimer)->ThreadRange(1, 4);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON result files.
+
+usage: compare.py BASELINE.json RESULTS.json [--threshold PERCENT]
+
+Prints the change in real time for every benchmark present in both files and
+exits with status 1 if any benchmark is slower than the threshold (default 10%).
+"""
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        runs = json.load(f)["benchmarks"]
+    return {run["name"]: run["real_time"] for run in runs if run.get("run_type", "iteration") == "iteration"}
+
+
+def main(argv):
+    if len(argv) < 3:
+        print(__doc__)
+        return 2
+    threshold = float(argv[argv.index("--threshold") + 1]) if "--threshold" in argv else 10.0
+    baseline, results = load(argv[1]), load(argv[2])
+
+    regressions = 0
+    print(f"{'benchmark':45} {'baseline':>12} {'current':>12} {'change':>8}")
+    for name, old in baseline.items():
+        if name not in results:
+            continue
+        new = results[name]
+        change = (new - old) / old * 100 if old else 0.0
+        flag = " REGRESSION" if change > threshold else ""
+        regressions += bool(flag)
+        print(f"{name:45} {old:12.3f} {new:12.3f} {change:+7.1f}%{flag}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
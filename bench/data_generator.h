@@ -0,0 +1,121 @@
+#ifndef DATA_GENERATOR_H
+#define DATA_GENERATOR_H
+
+#include <string>
+#include <fstream>
+#include <random>
+#include <cstdlib>
+#include <filesystem>
+
+using namespace std;
+
+// Synthetic CSV data in the on-disk formats of products.csv, orders.csv,
+// order_items.csv, staff.csv and suppliers.csv. Files are generated once
+// per size under the system temp directory and reused between benchmarks.
+class DataGenerator {
+private:
+    string directory;
+
+    static const char* pick(mt19937& rng, const char* const* words, size_t count) {
+        return words[rng() % count];
+    }
+
+    string path(const string& name, size_t count) const {
+        return directory + "/" + name + "_" + to_string(count) + ".csv";
+    }
+
+    static bool exists(const string& filename) {
+        return filesystem::exists(filename);
+    }
+
+public:
+    DataGenerator() {
+        directory = (filesystem::temp_directory_path() / "wms_bench").string();
+        filesystem::create_directories(directory);
+    }
+
+    // Multiplier applied to every benchmark size (WMS_BENCH_SCALE, default 1)
+    static long scale() {
+        const char* value = getenv("WMS_BENCH_SCALE");
+        long parsed = value ? atol(value) : 1;
+        return parsed > 0 ? parsed : 1;
+    }
+
+    string products(size_t count) {
+        string filename = path("products", count);
+        if (exists(filename)) return filename;
+
+        static const char* const adjectives[] = {"Steel", "Plastic", "Heavy", "Compact", "Premium", "Basic", "Wireless", "Industrial"};
+        static const char* const nouns[] = {"Bolt", "Crate", "Pallet", "Drill", "Cable", "Shelf", "Scanner", "Label"};
+        static const char* const categories[] = {"Hardware", "Storage", "Tools", "Electrical", "Packaging", "Electronics"};
+        mt19937 rng(42);
+        ofstream file(filename);
+        for (size_t id = 1; id <= count; ++id) {
+            file << id << "," << pick(rng, adjectives, 8) << " " << pick(rng, nouns, 8) << " " << id << ","
+                 << (rng() % 100000) / 100.0 << "," << rng() % 1000 << ","
+                 << pick(rng, categories, 6) << ",Synthetic product " << id << "\n";
+        }
+        return filename;
+    }
+
+    // Orders file with `count` orders; orderItems(count) holds their items
+    string orders(size_t count, size_t itemsPerOrder = 3, size_t productCount = 1000) {
+        string filename = path("orders", count);
+        string itemsFilename = orderItems(count);
+        if (exists(filename) && exists(itemsFilename)) return filename;
+
+        mt19937 rng(7);
+        ofstream file(filename);
+        ofstream itemsFile(itemsFilename);
+        for (size_t id = 1; id <= count; ++id) {
+            float total = 0.0f;
+            for (size_t i = 0; i < itemsPerOrder; ++i) {
+                size_t productID = 1 + rng() % productCount;
+                float price = (rng() % 10000) / 100.0f;
+                int quantity = 1 + rng() % 5;
+                total += price * quantity;
+                itemsFile << id << "," << productID << ",Product " << productID << ","
+                          << price << "," << quantity << "," << price * quantity << "\n";
+            }
+            file << id << "," << 1 + rng() % 5000 << ",Customer " << id % 5000 << ","
+                 << total << "," << 1700000000 + id * 60 << "," << 1 + rng() % 5 << "\n";
+        }
+        return filename;
+    }
+
+    string orderItems(size_t orderCount) const {
+        return path("order_items", orderCount);
+    }
+
+    string staff(size_t count) {
+        string filename = path("staff", count);
+        if (exists(filename)) return filename;
+
+        ofstream file(filename);
+        for (size_t id = 1; id <= count; ++id) {
+            file << id << ",user" << id << ",pass" << id << ",Staff Member " << id << ",555-"
+                 << 1000 + id % 9000 << ",user" << id << "@bms.com," << 1 + id % 3 << "\n";
+        }
+        return filename;
+    }
+
+    string suppliers(size_t count) {
+        string filename = path("suppliers", count);
+        if (exists(filename)) return filename;
+
+        ofstream file(filename);
+        for (size_t id = 1; id <= count; ++id) {
+            file << id << ",Supplier " << id << ",Contact " << id << ",555-" << 1000 + id % 9000
+                 << ",supplier" << id << "@mail.com," << id << " Market St,supplier" << id
+                 << ",secret" << id << ",1\n";
+        }
+        return filename;
+    }
+
+    // Scratch file for rewrite benchmarks
+    string scratch(const string& name, const string& extension = ".csv") const {
+        return directory + "/" + name + "_scratch" + extension;
+    }
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+// Blocking FIFO between pipeline stages. push() waits while the queue is
+// full, so a fast producer cannot run ahead of its consumer by more than
+// `capacity` items. close() ends the stream: pop() drains what is left and
+// then returns false, and further pushes are refused.
+template <typename T>
+class BoundedQueue {
+private:
+    deque<T> items;
+    size_t capacity;
+    bool closed;
+    mutex lock;
+    condition_variable notFull;
+    condition_variable notEmpty;
+
+public:
+    explicit BoundedQueue(size_t maxItems) : capacity(maxItems), closed(false) {}
+
+    bool push(T item) {
+        unique_lock<mutex> guard(lock);
+        notFull.wait(guard, [this]() { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    bool pop(T& item) {
+        unique_lock<mutex> guard(lock);
+        notEmpty.wait(guard, [this]() { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        item = move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        lock_guard<mutex> guard(lock);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+};
+
+#endif
@@ -0,0 +1,220 @@
+#include "btree.h"
+#include <cstring>
+#include <cstdio>
+
+namespace {
+
+const uint32_t BTREE_MAGIC = 0x31544257;  // "WBT1"
+const size_t NODE_HEADER = 8;
+const uint8_t NODE_LEAF = 1;
+const uint8_t NODE_INNER = 2;
+
+template <typename N>
+void put(vector<char>& page, size_t at, N value) {
+    memcpy(page.data() + at, &value, sizeof(value));
+}
+
+template <typename N>
+N get(const string& page, size_t at) {
+    N value;
+    memcpy(&value, page.data() + at, sizeof(value));
+    return value;
+}
+
+// Node header: kind, padding, entry count, next leaf
+void putHeader(vector<char>& page, uint8_t kind, uint16_t count, uint32_t next) {
+    page[0] = static_cast<char>(kind);
+    page[1] = 0;
+    put(page, 2, count);
+    put(page, 4, next);
+}
+
+}  // namespace
+
+// ========== Building ==========
+
+bool BTreeBuilder::open(const string& filename, size_t size) {
+    path = filename;
+    pageBytes = size;
+    out.open(path + ".tmp", ios::out | ios::binary | ios::trunc);
+    if (!out.is_open()) return false;
+
+    leaf.assign(pageBytes, 0);
+    leafUsed = NODE_HEADER;
+    leafCount = 0;
+    nextPage = 1;
+    entries = 0;
+    level.clear();
+    failed = false;
+    writePage(vector<char>(pageBytes, 0));  // the header, filled in by finish()
+    return true;
+}
+
+void BTreeBuilder::writePage(const vector<char>& page) {
+    out.write(page.data(), page.size());
+    if (!out) failed = true;
+}
+
+void BTreeBuilder::finishLeaf(uint32_t next) {
+    putHeader(leaf, NODE_LEAF, leafCount, next);
+    writePage(leaf);
+    level.emplace_back(move(leafFirstKey), nextPage++);
+    leaf.assign(pageBytes, 0);
+    leafUsed = NODE_HEADER;
+    leafCount = 0;
+    leafFirstKey.clear();
+}
+
+void BTreeBuilder::add(string_view key, RecordRef ref) {
+    key = key.substr(0, BTREE_MAX_KEY);
+    size_t size = 2 + key.size() + 12;
+    if (leafCount > 0 && (leafUsed + size > pageBytes || leafCount == UINT16_MAX)) finishLeaf(nextPage + 1);
+    if (leafCount == 0) leafFirstKey.assign(key);
+
+    put(leaf, leafUsed, static_cast<uint16_t>(key.size()));
+    memcpy(leaf.data() + leafUsed + 2, key.data(), key.size());
+    put(leaf, leafUsed + 2 + key.size(), ref.offset);
+    put(leaf, leafUsed + 10 + key.size(), ref.length);
+    leafUsed += size;
+    ++leafCount;
+    ++entries;
+}
+
+bool BTreeBuilder::finish(const SourceStamp& stamp) {
+    if (!out.is_open()) return false;
+    finishLeaf(0);
+
+    // Pack each level into inner nodes until one node is left: the root
+    uint32_t height = 1;
+    while (level.size() > 1) {
+        vector<pair<string, uint32_t>> parents;
+        vector<char> node(pageBytes, 0);
+        size_t used = NODE_HEADER;
+        uint16_t count = 0;
+        string firstKey;
+        for (auto& child : level) {
+            size_t size = 2 + child.first.size() + 4;
+            if (count > 0 && (used + size > pageBytes || count == UINT16_MAX)) {
+                putHeader(node, NODE_INNER, count, 0);
+                writePage(node);
+                parents.emplace_back(move(firstKey), nextPage++);
+                node.assign(pageBytes, 0);
+                used = NODE_HEADER;
+                count = 0;
+            }
+            if (count == 0) firstKey = child.first;
+            put(node, used, static_cast<uint16_t>(child.first.size()));
+            memcpy(node.data() + used + 2, child.first.data(), child.first.size());
+            put(node, used + 2 + child.first.size(), child.second);
+            used += size;
+            ++count;
+        }
+        putHeader(node, NODE_INNER, count, 0);
+        writePage(node);
+        parents.emplace_back(move(firstKey), nextPage++);
+        level = move(parents);
+        ++height;
+    }
+
+    vector<char> header(pageBytes, 0);
+    put(header, 0, BTREE_MAGIC);
+    put(header, 4, static_cast<uint32_t>(pageBytes));
+    put(header, 8, level.front().second);
+    put(header, 12, height);
+    put(header, 16, entries);
+    put(header, 24, stamp.bytes);
+    put(header, 32, stamp.modified);
+    out.seekp(0);
+    writePage(header);
+    out.close();
+    if (failed || !out) {
+        remove((path + ".tmp").c_str());
+        return false;
+    }
+    return rename((path + ".tmp").c_str(), path.c_str()) == 0;
+}
+
+// ========== Reading ==========
+
+bool BTreeIndex::open(const string& filename, size_t cachePages) {
+    path = filename;
+    if (!pages.open(filename, 4096, 1)) return false;
+    string header;
+    if (!pages.read(0, 40, header) || get<uint32_t>(header, 0) != BTREE_MAGIC) {
+        pages.close();
+        return false;
+    }
+    pageBytes = get<uint32_t>(header, 4);
+    root = get<uint32_t>(header, 8);
+    height = get<uint32_t>(header, 12);
+    entries = get<uint64_t>(header, 16);
+    source.bytes = get<uint64_t>(header, 24);
+    source.modified = get<uint64_t>(header, 32);
+    if (pageBytes < 1024 || height == 0) {
+        pages.close();
+        return false;
+    }
+    // Reopen with the file's own page size and the full budget
+    return pages.open(filename, pageBytes, cachePages);
+}
+
+bool BTreeIndex::restamp(const SourceStamp& stamp) {
+    fstream file(path, ios::in | ios::out | ios::binary);
+    if (!file.is_open()) return false;
+    file.seekp(24);
+    file.write(reinterpret_cast<const char*>(&stamp.bytes), sizeof(stamp.bytes));
+    file.write(reinterpret_cast<const char*>(&stamp.modified), sizeof(stamp.modified));
+    if (!file) return false;
+    source = stamp;
+    return true;
+}
+
+bool BTreeIndex::readPage(uint32_t number, string& page) {
+    return number != 0 && pages.read(static_cast<uint64_t>(number) * pageBytes, pageBytes, page);
+}
+
+void BTreeIndex::scanFrom(string_view from, const function<bool(string_view, RecordRef)>& visit) {
+    string page;
+    uint32_t number = root;
+
+    // Descend to the leftmost leaf that can hold `from`: the last child whose
+    // first key is below it, since equal keys may start in the child before
+    for (uint32_t depth = height; depth > 1; --depth) {
+        if (!readPage(number, page) || page[0] != static_cast<char>(NODE_INNER)) return;
+        uint16_t count = get<uint16_t>(page, 2);
+        size_t at = NODE_HEADER;
+        uint32_t child = 0;
+        for (uint16_t i = 0; i < count; ++i) {
+            uint16_t length = get<uint16_t>(page, at);
+            if (at + 2 + length + 4 > pageBytes) return;
+            string_view key(page.data() + at + 2, length);
+            if (i > 0 && key >= from) break;
+            child = get<uint32_t>(page, at + 2 + length);
+            at += 2 + length + 4;
+        }
+        number = child;
+    }
+
+    while (number != 0) {
+        if (!readPage(number, page) || page[0] != static_cast<char>(NODE_LEAF)) return;
+        uint16_t count = get<uint16_t>(page, 2);
+        size_t at = NODE_HEADER;
+        for (uint16_t i = 0; i < count; ++i) {
+            uint16_t length = get<uint16_t>(page, at);
+            if (at + 2 + length + 12 > pageBytes) return;
+            string_view key(page.data() + at + 2, length);
+            if (key >= from) {
+                RecordRef ref{get<uint64_t>(page, at + 2 + length), get<uint32_t>(page, at + 10 + length)};
+                if (!visit(key, ref)) return;
+            }
+            at += 2 + length + 12;
+        }
+        number = get<uint32_t>(page, 4);
+    }
+}
+
+void BTreeIndex::scanPrefix(string_view prefix, const function<bool(string_view, RecordRef)>& visit) {
+    scanFrom(prefix, [&](string_view key, RecordRef ref) {
+        return key.substr(0, prefix.size()) == prefix && visit(key, ref);
+    });
+}
@@ -0,0 +1,102 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+#include "page_cache.h"
+
+using namespace std;
+
+// Where a record lies in its data file
+struct RecordRef {
+    uint64_t offset;
+    uint32_t length;
+};
+
+// Identifies the version of the data file an index was built from
+struct SourceStamp {
+    uint64_t bytes;
+    uint64_t modified;  // file time in the filesystem clock's ticks
+
+    bool operator==(const SourceStamp& other) const { return bytes == other.bytes && modified == other.modified; }
+    bool operator!=(const SourceStamp& other) const { return !(*this == other); }
+};
+
+// Keys are compared as raw bytes; longer keys are cut to this length, so
+// callers that need exact matches on long keys recheck the record
+const size_t BTREE_MAX_KEY = 512;
+
+// Writes a B+-tree file from keys given in ascending order (duplicates
+// allowed). Leaves are filled completely and chained left to right; the
+// inner levels are built bottom up once the leaves are written. The file
+// appears under its final name only when finish() succeeds.
+//
+// Page 0 is the header. Every other page is a node: a kind byte, an entry
+// count and, in leaves, the next leaf; then entries of a uint16 key length,
+// the key, and either a RecordRef (leaves) or a child page number (inner
+// nodes, where the key is the first key under that child).
+class BTreeBuilder {
+private:
+    string path;
+    ofstream out;
+    size_t pageBytes;
+    vector<char> leaf;
+    size_t leafUsed;
+    uint16_t leafCount;
+    string leafFirstKey;
+    uint32_t nextPage;
+    uint64_t entries;
+    vector<pair<string, uint32_t>> level;  // first key and page of each finished node
+    bool failed;
+
+    void writePage(const vector<char>& page);
+    void finishLeaf(uint32_t next);
+
+public:
+    BTreeBuilder() : pageBytes(4096), leafUsed(0), leafCount(0), nextPage(1), entries(0), failed(false) {}
+
+    bool open(const string& filename, size_t size = 4096);
+    void add(string_view key, RecordRef ref);
+    bool finish(const SourceStamp& stamp);
+};
+
+// Reads a B+-tree file through a page cache, so a lookup touches the
+// root-to-leaf path and, for repeated lookups, mostly memory
+class BTreeIndex {
+private:
+    string path;
+    PageCache pages;
+    size_t pageBytes;
+    uint32_t root;
+    uint32_t height;
+    uint64_t entries;
+    SourceStamp source;
+
+    bool readPage(uint32_t number, string& page);
+
+public:
+    BTreeIndex() : pageBytes(4096), root(0), height(0), entries(0), source{0, 0} {}
+
+    bool open(const string& filename, size_t cachePages = 64);
+    void close() { pages.close(); }
+    bool isOpen() const { return pages.isOpen(); }
+
+    uint64_t size() const { return entries; }
+    const SourceStamp& stamp() const { return source; }
+    // Record that the index describes a new version of its data file
+    bool restamp(const SourceStamp& stamp);
+    const PageCache& cache() const { return pages; }
+
+    // Entries with keys >= `from`, in key order, to visit(key, ref) until it
+    // returns false
+    void scanFrom(string_view from, const function<bool(string_view, RecordRef)>& visit);
+
+    // Entries whose key starts with `prefix`
+    void scanPrefix(string_view prefix, const function<bool(string_view, RecordRef)>& visit);
+};
+
+#endif
@@ -0,0 +1,180 @@
+#include "catalog_import.h"
+#include "bounded_queue.h"
+#include "storage.h"
+#include "csv.h"
+#include "metrics.h"
+#include "trace.h"
+#include "utils.h"
+
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+const size_t CATALOG_COLUMNS = 5;
+const size_t IMPORT_BATCH_ROWS = 4096;
+const size_t IMPORT_QUEUE_BATCHES = 4;
+
+enum CatalogColumn {
+    COLUMN_NAME = 0,
+    COLUMN_CATEGORY = 1,
+    COLUMN_PRICE = 2,
+    COLUMN_QUANTITY = 3,
+    COLUMN_DESCRIPTION = 4
+};
+
+struct RawRow {
+    string fields[CATALOG_COLUMNS];
+};
+
+struct CatalogRow {
+    string name;
+    string category;
+    string description;
+    float price;
+    int quantity;
+};
+
+static string trimmed(const string& text) {
+    size_t first = text.find_first_not_of(" \t");
+    if (first == string::npos) return "";
+    size_t last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+// Stage 1: split the file into raw rows
+static void parseStage(ifstream& file, BoundedQueue<vector<RawRow>>& out, size_t& rowsRead) {
+    TRACE_SCOPE("import: parse");
+    CsvReader reader(file);
+    vector<RawRow> batch;
+    batch.reserve(IMPORT_BATCH_ROWS);
+    bool firstRow = true;
+
+    while (reader.next(CATALOG_COLUMNS)) {
+        if (firstRow) {
+            firstRow = false;
+            if (toLowerCase(trimmed(string(reader.field(COLUMN_NAME)))) == "name") continue;  // header
+        }
+        RawRow row;
+        for (size_t c = 0; c < CATALOG_COLUMNS; ++c) row.fields[c].assign(reader.field(c));
+        batch.push_back(move(row));
+        ++rowsRead;
+
+        if (batch.size() == IMPORT_BATCH_ROWS) {
+            if (!out.push(move(batch))) break;
+            batch = vector<RawRow>();
+            batch.reserve(IMPORT_BATCH_ROWS);
+        }
+    }
+    if (!batch.empty()) out.push(move(batch));
+    out.close();
+}
+
+static bool validate(RawRow& raw, CatalogRow& row) {
+    row.name = trimmed(raw.fields[COLUMN_NAME]);
+    if (row.name.empty()) return false;
+    if (!parseValue(raw.fields[COLUMN_PRICE], row.price) || !isfinite(row.price) || row.price < 0) return false;
+    if (!parseValue(raw.fields[COLUMN_QUANTITY], row.quantity) || row.quantity < 0) return false;
+
+    row.category = trimmed(raw.fields[COLUMN_CATEGORY]);
+    if (row.category.empty()) row.category = "Uncategorized";
+    row.description = move(raw.fields[COLUMN_DESCRIPTION]);
+    return true;
+}
+
+// Stage 2: type and check each row, dropping the malformed ones
+static void validateStage(BoundedQueue<vector<RawRow>>& in, BoundedQueue<vector<CatalogRow>>& out, size_t& rowsInvalid) {
+    TRACE_SCOPE("import: validate");
+    vector<RawRow> raw;
+    while (in.pop(raw)) {
+        vector<CatalogRow> batch;
+        batch.reserve(raw.size());
+        for (auto& row : raw) {
+            CatalogRow checked;
+            if (validate(row, checked)) {
+                batch.push_back(move(checked));
+            } else {
+                ++rowsInvalid;
+            }
+        }
+        if (!out.push(move(batch))) break;
+    }
+    out.close();
+}
+
+ImportStats CatalogImport::run(const string& catalogFile, vector<Product>& inventory, const string& productsFile) {
+    TRACE_SCOPE("CatalogImport::run");
+    static Histogram importTime("wms_import_seconds", "Time to import a supplier catalog");
+    static Counter rowsImported("wms_import_rows_total", "Catalog rows by import outcome", "result=\"imported\"");
+    static Counter rowsInvalid("wms_import_rows_total", "Catalog rows by import outcome", "result=\"invalid\"");
+    static Counter rowsDuplicate("wms_import_rows_total", "Catalog rows by import outcome", "result=\"duplicate\"");
+    ScopedTimer timer(importTime);
+    auto start = chrono::steady_clock::now();
+
+    ImportStats stats{0, 0, 0, 0, 0.0, 0, false, false};
+    ifstream file(catalogFile);
+    if (!file.is_open()) return stats;
+    stats.opened = true;
+
+    BoundedQueue<vector<RawRow>> rawRows(IMPORT_QUEUE_BATCHES);
+    BoundedQueue<vector<CatalogRow>> checkedRows(IMPORT_QUEUE_BATCHES);
+    thread parser(parseStage, ref(file), ref(rawRows), ref(stats.rowsRead));
+    thread validator(validateStage, ref(rawRows), ref(checkedRows), ref(stats.rowsInvalid));
+
+    // Stage 3, on this thread: dedupe needs every earlier name, so
+    // products are only ever built here
+    unordered_set<string> names;
+    names.reserve(inventory.size());
+    for (const auto& product : inventory) names.insert(toLowerCase(product.getName()));
+
+    vector<Product> added;
+    vector<CatalogRow> batch;
+    {
+        TRACE_SCOPE("import: dedupe");
+        while (checkedRows.pop(batch)) {
+            for (auto& row : batch) {
+                if (!names.insert(toLowerCase(row.name)).second) {
+                    ++stats.rowsDuplicate;
+                    continue;
+                }
+                added.emplace_back(move(row.name), row.price, row.quantity, move(row.category), move(row.description));
+            }
+        }
+    }
+    parser.join();
+    validator.join();
+
+    // One batched write; the inventory only changes once it succeeded
+    stats.saved = added.empty() || Storage::open<Product>(productsFile)->appendAll(added);
+    if (stats.saved) {
+        stats.rowsImported = added.size();
+        inventory.insert(inventory.end(), make_move_iterator(added.begin()), make_move_iterator(added.end()));
+    }
+
+    rowsImported.increment(stats.rowsImported);
+    rowsInvalid.increment(stats.rowsInvalid);
+    rowsDuplicate.increment(stats.rowsDuplicate);
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.peakMemoryBytes = peakMemoryBytes();
+    return stats;
+}
+
+size_t CatalogImport::peakMemoryBytes() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss;  // bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;  // kilobytes on Linux
+#endif
+#endif
+}
@@ -0,0 +1,45 @@
+#ifndef CATALOG_IMPORT_H
+#define CATALOG_IMPORT_H
+
+#include <string>
+#include <vector>
+#include "product.h"
+
+using namespace std;
+
+struct ImportStats {
+    size_t rowsRead;
+    size_t rowsImported;
+    size_t rowsInvalid;    // missing name, bad price or quantity
+    size_t rowsDuplicate;  // name already in the inventory or earlier in the file
+    double seconds;
+    size_t peakMemoryBytes;  // peak resident set size of the process, 0 if unknown
+    bool opened;             // false if the catalog file could not be read
+    bool saved;              // false if the products file could not be written
+
+    double rowsPerSecond() const { return seconds > 0 ? rowsRead / seconds : 0; }
+};
+
+// Bulk import of a supplier catalog CSV with the columns
+//
+//     name,category,price,quantity,description
+//
+// and an optional header row. The file is streamed through three stages
+// connected by bounded queues, so memory stays flat however large it is:
+//
+//   parse (thread)    CsvReader -> raw rows
+//   validate (thread) raw rows -> typed rows, rejecting malformed ones
+//   insert (caller)   dedupe by name against the inventory and the earlier
+//                     rows, then build the products
+//
+// Accepted products are appended to `productsFile` in a single write and
+// only then added to `inventory`, so a failed write leaves both unchanged.
+class CatalogImport {
+public:
+    static ImportStats run(const string& catalogFile, vector<Product>& inventory, const string& productsFile);
+
+    // Peak resident set size of the process so far, in bytes
+    static size_t peakMemoryBytes();
+};
+
+#endif
@@ -0,0 +1,37 @@
+#include "codec.h"
+
+#include <charconv>
+
+// Skip the blanks and '+' sign that strtol/strtof accepted but from_chars does not
+static const char* numberStart(string_view text) {
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    while (begin != end && (*begin == ' ' || *begin == '\t')) ++begin;
+    if (begin != end && *begin == '+') ++begin;
+    return begin;
+}
+
+bool parseValue(string_view text, string& value) {
+    value.assign(text.data(), text.size());
+    return true;
+}
+
+bool parseValue(string_view text, long long& value) {
+    const char* end = text.data() + text.size();
+    return from_chars(numberStart(text), end, value).ec == errc();
+}
+
+bool parseValue(string_view text, long& value) {
+    const char* end = text.data() + text.size();
+    return from_chars(numberStart(text), end, value).ec == errc();
+}
+
+bool parseValue(string_view text, int& value) {
+    const char* end = text.data() + text.size();
+    return from_chars(numberStart(text), end, value).ec == errc();
+}
+
+bool parseValue(string_view text, float& value) {
+    const char* end = text.data() + text.size();
+    return from_chars(numberStart(text), end, value).ec == errc();
+}
@@ -0,0 +1,347 @@
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <type_traits>
+#include "csv.h"
+
+using namespace std;
+
+// Field tables and the record codecs generated from them.
+//
+// Each persisted entity specializes EntityTraits with
+//   fields     - tuple of field("column", &T::member) in file column order;
+//                columns added once files exist go last, as addedField()
+//   keyOf(r)   - the record's primary key, held by the first column
+//   lookup     - optional: another column that is searched often and worth
+//                an index in storage that supports one
+// and declares it a friend so the field table can name private members.
+//
+// A format is a struct of static templates (CsvFormat, BinaryFormat) that
+// walks the field table with a fold expression. The format is a template
+// argument, so each entity/format pair compiles to straight-line code with
+// no virtual calls, and values are converted in place without temporary
+// strings.
+template <typename T>
+struct EntityTraits;
+
+// One column bound to a data member
+template <typename T, typename M>
+struct Field {
+    const char* name;
+    M T::* member;
+    // Records written before the column existed lack it and read it as
+    // zero or empty instead of failing
+    bool added;
+};
+
+template <typename T, typename M>
+constexpr Field<T, M> field(const char* name, M T::* member) {
+    return {name, member, false};
+}
+
+template <typename T, typename M>
+constexpr Field<T, M> addedField(const char* name, M T::* member) {
+    return {name, member, true};
+}
+
+template <typename Traits>
+constexpr size_t fieldCount() {
+    return tuple_size<decay_t<decltype(Traits::fields)>>::value;
+}
+
+// Position of `column` in the field table, or fieldCount if there is none
+template <typename Traits, size_t... I>
+size_t columnIndex(string_view column, index_sequence<I...>) {
+    size_t index = sizeof...(I);
+    ((index == sizeof...(I) && column == get<I>(Traits::fields).name ? (index = I) : 0), ...);
+    return index;
+}
+
+template <typename Traits>
+size_t columnIndex(string_view column) {
+    return columnIndex<Traits>(column, make_index_sequence<fieldCount<Traits>()>());
+}
+
+// Whether column `index` of `record` equals `value`. Text columns compare
+// with strings and numeric columns with integers; other pairs never match.
+template <typename M, typename V>
+bool valueEquals(const M& member, const V& value) {
+    if constexpr (is_same<M, string>::value && is_same<V, string>::value) {
+        return member == value;
+    } else if constexpr ((is_integral<M>::value || is_enum<M>::value) && is_integral<V>::value) {
+        return static_cast<long long>(member) == static_cast<long long>(value);
+    } else {
+        return false;
+    }
+}
+
+template <typename T, typename Traits, typename V, size_t... I>
+bool columnEquals(const T& record, size_t index, const V& value, index_sequence<I...>) {
+    return ((index == I && valueEquals(record.*(get<I>(Traits::fields).member), value)) || ...);
+}
+
+template <typename T, typename Traits = EntityTraits<T>, typename V>
+bool columnEquals(const T& record, size_t index, const V& value) {
+    return columnEquals<T, Traits>(record, index, value, make_index_sequence<fieldCount<Traits>()>());
+}
+
+// Outcome of reading one record from a stream
+enum ReadResult {
+    READ_OK,
+    READ_SKIPPED,  // malformed record, the stream is positioned after it
+    READ_END
+};
+
+// ========== Column conversions ==========
+// Numbers accept what stoi/stof accepted (leading blanks, trailing junk such
+// as '\r'), but a column without any digits fails the row instead of throwing.
+bool parseValue(string_view text, string& value);
+bool parseValue(string_view text, int& value);
+bool parseValue(string_view text, long& value);
+bool parseValue(string_view text, long long& value);
+bool parseValue(string_view text, float& value);
+
+template <typename E>
+typename enable_if<is_enum<E>::value, bool>::type parseValue(string_view text, E& value) {
+    int raw;
+    if (!parseValue(text, raw)) return false;
+    value = static_cast<E>(raw);
+    return true;
+}
+
+// ========== CSV ==========
+// One record per line with RFC 4180 quoting (see csv.h). A quoted field may
+// span lines; an unquoted last column runs to the end of the line.
+struct CsvFormat {
+    static constexpr ios::openmode MODE = ios::openmode();
+
+    template <typename T, typename Traits = EntityTraits<T>>
+    static void write(CsvWriter& writer, const T& record) {
+        writeColumns<T, Traits>(writer, record, make_index_sequence<fieldCount<Traits>()>());
+        writer.endRow();
+    }
+
+    template <typename T, typename Traits = EntityTraits<T>>
+    static void write(ostream& out, const T& record) {
+        CsvWriter writer(out, 512);
+        write<T, Traits>(writer, record);
+    }
+
+    template <typename T, typename Traits = EntityTraits<T>>
+    static void writeAll(ostream& out, const vector<T>& records) {
+        CsvWriter writer(out);
+        for (const auto& record : records) write<T, Traits>(writer, record);
+    }
+
+    // Pulls records out of a stream; missing trailing columns read as empty,
+    // and a malformed numeric column skips the record
+    class Reader {
+    private:
+        CsvReader csv;
+
+        template <typename T, typename Traits, size_t I>
+        bool parseField(T& record) {
+            const auto& column = get<I>(Traits::fields);
+            auto& value = record.*(column.member);
+            // Rows from before an added column end short of it
+            if (column.added && I >= csv.size()) {
+                value = {};
+                return true;
+            }
+            return parseValue(csv.field(I), value);
+        }
+
+        template <typename T, typename Traits, size_t... I>
+        bool parseFields(T& record, index_sequence<I...>) {
+            return (parseField<T, Traits, I>(record) && ...);
+        }
+
+    public:
+        explicit Reader(istream& in, size_t capacity = CSV_READ_BUFFER) : csv(in, capacity) {}
+
+        template <typename T, typename Traits = EntityTraits<T>>
+        ReadResult read(T& record) {
+            if (!csv.next(fieldCount<Traits>())) return READ_END;
+            return parseFields<T, Traits>(record, make_index_sequence<fieldCount<Traits>()>()) ? READ_OK : READ_SKIPPED;
+        }
+
+        // Position and size in the input of the record just read
+        uint64_t offset() const { return csv.offset(); }
+        uint64_t length() const { return csv.length(); }
+    };
+
+private:
+    template <typename T, typename Traits, size_t... I>
+    static void writeColumns(CsvWriter& writer, const T& record, index_sequence<I...>) {
+        (writer.field(record.*(get<I>(Traits::fields).member)), ...);
+    }
+};
+
+// ========== Binary ==========
+// Fields back to back in table order: numbers as fixed-width native-endian
+// values, enums as int32, strings as a uint32 length followed by the bytes.
+// Only decode() knows where a record ends, so only it accepts records that
+// predate an added column; streamed files are caches and get rewritten.
+// Meant for local caches and snapshots, not for exchange between machines.
+struct BinaryFormat {
+    static constexpr ios::openmode MODE = ios::binary;
+
+    // Longer strings are treated as corruption rather than allocated
+    static constexpr uint32_t MAX_STRING_LENGTH = 1 << 24;
+
+    template <typename T, typename Traits = EntityTraits<T>>
+    static void write(ostream& out, const T& record) {
+        writeFields<T, Traits>(out, record, make_index_sequence<fieldCount<Traits>()>());
+    }
+
+    template <typename T, typename Traits = EntityTraits<T>>
+    static void writeAll(ostream& out, const vector<T>& records) {
+        for (const auto& record : records) write<T, Traits>(out, record);
+    }
+
+    class Reader {
+    private:
+        istream& in;
+
+    public:
+        explicit Reader(istream& source) : in(source) {}
+
+        template <typename T, typename Traits = EntityTraits<T>>
+        ReadResult read(T& record) {
+            if (in.peek() == char_traits<char>::eof()) return READ_END;
+            // A truncated record means the file ends mid-write; there is nothing after it
+            return readFields<T, Traits>(in, record, make_index_sequence<fieldCount<Traits>()>()) ? READ_OK : READ_END;
+        }
+    };
+
+    // The same encoding to and from memory, for stores that keep each
+    // record as a byte string
+    template <typename T, typename Traits = EntityTraits<T>>
+    static void encode(string& out, const T& record) {
+        encodeFields<T, Traits>(out, record, make_index_sequence<fieldCount<Traits>()>());
+    }
+
+    // False if `data` ends before the record does
+    template <typename T, typename Traits = EntityTraits<T>>
+    static bool decode(string_view data, T& record) {
+        return decodeFields<T, Traits>(data, record, make_index_sequence<fieldCount<Traits>()>());
+    }
+
+private:
+    template <typename M>
+    static void writeValue(ostream& out, const M& value) {
+        if constexpr (is_same<M, string>::value) {
+            uint32_t length = static_cast<uint32_t>(value.size());
+            out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            out.write(value.data(), length);
+        } else if constexpr (is_enum<M>::value) {
+            int32_t raw = static_cast<int32_t>(value);
+            out.write(reinterpret_cast<const char*>(&raw), sizeof(raw));
+        } else {
+            static_assert(is_arithmetic<M>::value, "BinaryFormat: unsupported field type");
+            out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+
+    template <typename M>
+    static bool readValue(istream& in, M& value) {
+        if constexpr (is_same<M, string>::value) {
+            uint32_t length;
+            if (!in.read(reinterpret_cast<char*>(&length), sizeof(length))) return false;
+            if (length > MAX_STRING_LENGTH) return false;
+            value.resize(length);
+            return static_cast<bool>(in.read(&value[0], length));
+        } else if constexpr (is_enum<M>::value) {
+            int32_t raw;
+            if (!in.read(reinterpret_cast<char*>(&raw), sizeof(raw))) return false;
+            value = static_cast<M>(raw);
+            return true;
+        } else {
+            static_assert(is_arithmetic<M>::value, "BinaryFormat: unsupported field type");
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+        }
+    }
+
+    template <typename M>
+    static void encodeValue(string& out, const M& value) {
+        if constexpr (is_same<M, string>::value) {
+            uint32_t length = static_cast<uint32_t>(value.size());
+            out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            out.append(value);
+        } else if constexpr (is_enum<M>::value) {
+            int32_t raw = static_cast<int32_t>(value);
+            out.append(reinterpret_cast<const char*>(&raw), sizeof(raw));
+        } else {
+            static_assert(is_arithmetic<M>::value, "BinaryFormat: unsupported field type");
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+
+    // Read a fixed-width value off the front of `data`
+    template <typename V>
+    static bool take(string_view& data, V& value) {
+        if (data.size() < sizeof(value)) return false;
+        memcpy(&value, data.data(), sizeof(value));
+        data.remove_prefix(sizeof(value));
+        return true;
+    }
+
+    template <typename M>
+    static bool decodeValue(string_view& data, M& value) {
+        if constexpr (is_same<M, string>::value) {
+            uint32_t length;
+            if (!take(data, length) || length > data.size()) return false;
+            value.assign(data.data(), length);
+            data.remove_prefix(length);
+            return true;
+        } else if constexpr (is_enum<M>::value) {
+            int32_t raw;
+            if (!take(data, raw)) return false;
+            value = static_cast<M>(raw);
+            return true;
+        } else {
+            static_assert(is_arithmetic<M>::value, "BinaryFormat: unsupported field type");
+            return take(data, value);
+        }
+    }
+
+    template <typename T, typename Traits, size_t... I>
+    static void encodeFields(string& out, const T& record, index_sequence<I...>) {
+        (encodeValue(out, record.*(get<I>(Traits::fields).member)), ...);
+    }
+
+    // Values from before an added column end short of it
+    template <typename F, typename M>
+    static bool decodeField(string_view& data, const F& column, M& value) {
+        if (column.added && data.empty()) {
+            value = {};
+            return true;
+        }
+        return decodeValue(data, value);
+    }
+
+    template <typename T, typename Traits, size_t... I>
+    static bool decodeFields(string_view data, T& record, index_sequence<I...>) {
+        return (decodeField(data, get<I>(Traits::fields), record.*(get<I>(Traits::fields).member)) && ...);
+    }
+
+    template <typename T, typename Traits, size_t... I>
+    static void writeFields(ostream& out, const T& record, index_sequence<I...>) {
+        (writeValue(out, record.*(get<I>(Traits::fields).member)), ...);
+    }
+
+    template <typename T, typename Traits, size_t... I>
+    static bool readFields(istream& in, T& record, index_sequence<I...>) {
+        return (readValue(in, record.*(get<I>(Traits::fields).member)) && ...);
+    }
+};
+
+#endif
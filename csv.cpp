@@ -0,0 +1,291 @@
+#include "csv.h"
+
+#include <charconv>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+BufferedWriter::BufferedWriter(ostream& target, size_t capacity) : out(target), buffer(capacity), used(0) {}
+
+BufferedWriter::~BufferedWriter() {
+    flush();
+}
+
+void BufferedWriter::flush() {
+    if (used == 0) return;
+    out.write(buffer.data(), used);
+    used = 0;
+}
+
+void BufferedWriter::appendSlow(const char* text, size_t length) {
+    flush();
+    // Larger than the whole buffer: skip the copy
+    if (length > buffer.size()) {
+        out.write(text, length);
+        return;
+    }
+    memcpy(buffer.data(), text, length);
+    used = length;
+}
+
+CsvWriter::CsvWriter(ostream& target, size_t capacity) : BufferedWriter(target, capacity), rowStart(true) {}
+
+// Nonzero if any byte of `word` equals `c`
+static uint64_t hasByte(uint64_t word, unsigned char c) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    uint64_t x = word ^ (ones * c);
+    return (x - ones) & ~x & (ones << 7);
+}
+
+// Characters that force a field to be quoted: ',', '"', CR and LF.
+// Checked eight bytes at a time, since most fields need no quoting.
+static bool needsQuotes(string_view text) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    for (; end - p >= 8; p += 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        if (hasByte(word, ',') | hasByte(word, '"') | hasByte(word, '\r') | hasByte(word, '\n')) return true;
+    }
+    for (; p != end; ++p) {
+        if (*p == ',' || *p == '"' || *p == '\r' || *p == '\n') return true;
+    }
+    return false;
+}
+
+void CsvWriter::field(string_view text) {
+    separator();
+    if (!needsQuotes(text)) {
+        append(text.data(), text.size());
+        return;
+    }
+
+    append("\"", 1);
+    size_t start = 0;
+    for (size_t quote = text.find('"'); quote != string_view::npos; quote = text.find('"', start)) {
+        append(text.data() + start, quote + 1 - start);  // up to and including the quote
+        append("\"", 1);
+        start = quote + 1;
+    }
+    append(text.data() + start, text.size() - start);
+    append("\"", 1);
+}
+
+template <typename N>
+void CsvWriter::appendNumber(N value) {
+    char text[32];  // longest int64 or shortest-form float
+    char* end = to_chars(text, text + sizeof(text), value).ptr;
+    append(text, end - text);
+}
+
+void CsvWriter::field(int value) {
+    separator();
+    appendNumber(value);
+}
+
+void CsvWriter::field(long value) {
+    separator();
+    appendNumber(value);
+}
+
+void CsvWriter::field(long long value) {
+    separator();
+    appendNumber(value);
+}
+
+namespace {
+
+// Prices and totals almost always have at most two decimals. When the
+// two-decimal text reads back as the same value, print it from integer
+// cents, which is several times cheaper than the general shortest form.
+template <typename V>
+char* formatDecimal(char* first, char* last, V value, V centsLimit) {
+    if (fabs(value) < centsLimit && !(value == 0 && signbit(value))) {
+        long long cents = llround(value * 100.0);
+        if (static_cast<V>(cents / 100.0) == value) {
+            char* end = first;
+            if (cents < 0) {
+                *end++ = '-';
+                cents = -cents;
+            }
+            end = to_chars(end, last, cents / 100).ptr;
+            int fraction = static_cast<int>(cents % 100);
+            if (fraction != 0) {
+                *end++ = '.';
+                *end++ = static_cast<char>('0' + fraction / 10);
+                if (fraction % 10 != 0) *end++ = static_cast<char>('0' + fraction % 10);
+            }
+            return end;
+        }
+    }
+    return to_chars(first, last, value).ptr;
+}
+
+}  // namespace
+
+char* formatFloat(char* first, char* last, float value) {
+    return formatDecimal(first, last, value, 1e7f);
+}
+
+char* formatFloat(char* first, char* last, double value) {
+    return formatDecimal(first, last, value, 1e13);
+}
+
+void CsvWriter::field(float value) {
+    separator();
+    char text[32];
+    char* end = formatFloat(text, text + sizeof(text), value);
+    append(text, end - text);
+}
+
+void CsvWriter::field(double value) {
+    separator();
+    char text[32];
+    char* end = formatFloat(text, text + sizeof(text), value);
+    append(text, end - text);
+}
+
+// ========== Reading ==========
+// First ',' or '\n' in [p, end), or end
+static const char* findSeparator(const char* p, const char* end) {
+#if defined(__SSE2__)
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, newline)));
+        if (mask != 0) return p + __builtin_ctz(mask);
+    }
+#else
+    for (; end - p >= 8; p += 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        if (hasByte(word, ',') | hasByte(word, '\n')) break;
+    }
+#endif
+    for (; p != end; ++p) {
+        if (*p == ',' || *p == '\n') return p;
+    }
+    return end;
+}
+
+CsvReader::CsvReader(istream& source, size_t capacity)
+    : in(source), buffer(capacity), begin(0), end(0), eof(false), base(0), recordStart(0), recordStop(0) {}
+
+// Keep the unconsumed bytes, growing the block if one record fills it, and
+// read more. False once there is nothing new to look at.
+bool CsvReader::refill() {
+    if (eof) return false;
+    if (begin > 0) {
+        base += begin;
+        memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+
+    in.read(buffer.data() + end, buffer.size() - end);
+    end += in.gcount();
+    if (!in) eof = true;
+    return true;
+}
+
+// Split the record at `begin` into spans. False if the block ends before
+// the record does and more input may follow.
+bool CsvReader::parseRecord(size_t columns, size_t& next) {
+    const char* data = buffer.data();
+    spans.clear();
+    unescaped.clear();
+
+    size_t p = begin;
+    for (;;) {
+        if (p < end && data[p] == '"') {
+            size_t from = p + 1;
+            size_t arenaStart = unescaped.size();
+            bool escaped = false;
+            for (;;) {
+                const char* quote = static_cast<const char*>(memchr(data + from, '"', end - from));
+                if (quote == nullptr || (quote + 1 == data + end && !eof)) {
+                    if (!eof) return false;
+                    // Unterminated quote: the field runs to the end of the input
+                    quote = data + end;
+                }
+                size_t q = quote - data;
+                if (q + 1 < end && data[q + 1] == '"') {
+                    unescaped.append(data + from, q + 1 - from);
+                    escaped = true;
+                    from = q + 2;
+                    continue;
+                }
+                if (escaped) {
+                    unescaped.append(data + from, q - from);
+                    spans.push_back({arenaStart, unescaped.size() - arenaStart, true});
+                } else {
+                    spans.push_back({p + 1, q - p - 1, false});
+                }
+                p = q + 1;
+                break;
+            }
+
+            // Anything between the closing quote and the separator is dropped
+            const char* separator = findSeparator(data + min(p, end), data + end);
+            if (separator == data + end) {
+                if (!eof) return false;
+                next = end;
+                return true;
+            }
+            p = separator - data + 1;
+            if (*separator == '\n') {
+                next = p;
+                return true;
+            }
+            continue;
+        }
+
+        bool lastColumn = columns != 0 && spans.size() + 1 == columns;
+        const char* separator;
+        if (lastColumn) {
+            separator = static_cast<const char*>(memchr(data + p, '\n', end - p));
+            if (separator == nullptr) separator = data + end;
+        } else {
+            separator = findSeparator(data + p, data + end);
+        }
+        if (separator == data + end && !eof) return false;
+
+        size_t stop = separator - data;
+        bool recordEnd = separator == data + end || *separator == '\n';
+        size_t length = stop - p;
+        if (recordEnd && length > 0 && data[stop - 1] == '\r') --length;
+        spans.push_back({p, length, false});
+        if (recordEnd) {
+            next = min(stop + 1, end);
+            return true;
+        }
+        p = stop + 1;
+    }
+}
+
+bool CsvReader::next(size_t columns) {
+    for (;;) {
+        // Skip blank lines
+        while (begin < end && (buffer[begin] == '\n' || (buffer[begin] == '\r' && begin + 1 < end && buffer[begin + 1] == '\n'))) {
+            begin += buffer[begin] == '\n' ? 1 : 2;
+        }
+        if (begin < end) {
+            size_t next;
+            if (parseRecord(columns, next)) {
+                recordStart = base + begin;
+                recordStop = base + next;
+                begin = next;
+                return true;
+            }
+        }
+        if (!refill()) {
+            spans.clear();
+            return false;
+        }
+    }
+}
@@ -0,0 +1,149 @@
+#ifndef CSV_H
+#define CSV_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+#include <cstdint>
+
+using namespace std;
+
+// CSV with RFC 4180 quoting: a field containing ',', '"', CR or LF is
+// wrapped in quotes and its quotes are doubled. Everything else is written
+// bare, so files without such characters look exactly as before.
+
+const size_t CSV_WRITE_BUFFER = 1 << 20;
+
+// Write `value` into [first, last) and return the end of the text: the
+// shortest form that reads back to the same float, produced from integer
+// cents when two decimals are enough. `last - first` must be at least 32.
+char* formatFloat(char* first, char* last, float value);
+char* formatFloat(char* first, char* last, double value);
+
+// Formats into a private buffer and hands it to the stream in large
+// chunks; the base of CsvWriter and JsonlWriter. Whatever is buffered is
+// written on flush() and on destruction.
+class BufferedWriter {
+private:
+    ostream& out;
+    vector<char> buffer;
+    size_t used;
+
+    void appendSlow(const char* text, size_t length);
+
+protected:
+    BufferedWriter(ostream& target, size_t capacity);
+    ~BufferedWriter();
+
+    void append(const char* text, size_t length) {
+        if (used + length > buffer.size()) {
+            appendSlow(text, length);
+            return;
+        }
+        memcpy(buffer.data() + used, text, length);
+        used += length;
+    }
+
+public:
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    void flush();
+};
+
+// Writes rows through BufferedWriter. Numbers go through to_chars: no
+// locale, no stream state, and floats use the shortest text that reads
+// back to the same value.
+class CsvWriter : public BufferedWriter {
+private:
+    bool rowStart;
+
+    void separator() {
+        if (!rowStart) append(",", 1);
+        rowStart = false;
+    }
+
+    template <typename N>
+    void appendNumber(N value);
+
+public:
+    explicit CsvWriter(ostream& target, size_t capacity = CSV_WRITE_BUFFER);
+
+    void field(string_view text);
+    void field(int value);
+    void field(long value);
+    void field(long long value);
+    void field(float value);
+    void field(double value);
+
+    template <typename E>
+    typename enable_if<is_enum<E>::value>::type field(E value) {
+        field(static_cast<int>(value));
+    }
+
+    void endRow() {
+        append("\n", 1);
+        rowStart = true;
+    }
+};
+
+// ========== Reading ==========
+const size_t CSV_READ_BUFFER = 1 << 18;
+
+// Splits a stream into records with the RFC 4180 state machine: quoted
+// fields, "" escapes, and line breaks inside quotes. Input is read in
+// blocks. Unquoted text is scanned 16 bytes at a time for the next ',' or
+// '\n', and quoted text with memchr for the closing '"'. Fields are views
+// into the block, so the common unquoted case copies nothing. A CR before
+// the record's LF is dropped.
+class CsvReader {
+private:
+    struct Span {
+        size_t offset;
+        size_t length;
+        bool unescaped;  // offset is into `unescaped` rather than the block
+    };
+
+    istream& in;
+    vector<char> buffer;
+    size_t begin;  // first unconsumed byte
+    size_t end;    // end of the bytes read so far
+    bool eof;
+    uint64_t base;         // input position of buffer[0]
+    uint64_t recordStart;  // input position of the current record
+    uint64_t recordStop;
+    vector<Span> spans;
+    string unescaped;  // quoted fields that contained "" escapes
+
+    bool refill();
+    bool parseRecord(size_t columns, size_t& next);
+
+public:
+    explicit CsvReader(istream& source, size_t capacity = CSV_READ_BUFFER);
+
+    // Advance to the next non-blank record; false at the end of the input.
+    // With `columns` set, an unquoted field in the last column runs to the
+    // end of the line, so older files with bare commas in free text still
+    // read. Views from field() stay valid until the next call.
+    bool next(size_t columns = 0);
+
+    size_t size() const { return spans.size(); }
+
+    // Where the current record lies in the input, counted from where
+    // reading began: its first byte and the byte after its line break
+    uint64_t offset() const { return recordStart; }
+    uint64_t length() const { return recordStop - recordStart; }
+
+    // Field `index` of the current record; empty past the last field
+    string_view field(size_t index) const {
+        if (index >= spans.size()) return string_view();
+        const Span& span = spans[index];
+        const char* base = span.unescaped ? unescaped.data() : buffer.data();
+        return string_view(base + span.offset, span.length);
+    }
+};
+
+#endif
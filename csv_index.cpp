@@ -0,0 +1,124 @@
+#include "csv_index.h"
+#include <filesystem>
+
+IndexedFile::IndexedFile(const string& filename, const vector<string>& indexNames,
+                         function<bool(const SourceStamp&)> builder, size_t cacheBytes)
+    : dataFile(filename), build(move(builder)), current{0, 0}, ready(false) {
+    for (const auto& name : indexNames) {
+        indexFiles.push_back(indexFile(filename, name));
+        indexes.emplace_back(new BTreeIndex());
+    }
+    cachePages = max<size_t>(cacheBytes / 4096 / (indexNames.size() + 1), 4);
+}
+
+bool IndexedFile::stampOf(const string& filename, SourceStamp& stamp) {
+    error_code error;
+    uintmax_t bytes = filesystem::file_size(filename, error);
+    if (error) return false;
+    auto modified = filesystem::last_write_time(filename, error);
+    if (error) return false;
+    stamp.bytes = bytes;
+    stamp.modified = static_cast<uint64_t>(modified.time_since_epoch().count());
+    return true;
+}
+
+bool IndexedFile::openIndexes(const SourceStamp& expected) {
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        if (!indexes[i]->open(indexFiles[i], cachePages) || indexes[i]->stamp() != expected) return false;
+    }
+    return true;
+}
+
+bool IndexedFile::refresh() {
+    SourceStamp stamp;
+    if (!stampOf(dataFile, stamp)) {
+        ready = false;
+        return false;
+    }
+    if (ready && stamp == current) return true;
+
+    ready = false;
+    data.close();
+    if (!openIndexes(stamp)) {
+        for (auto& index : indexes) index->close();
+        if (!build(stamp) || !openIndexes(stamp)) return false;
+    }
+    if (!data.open(dataFile, 4096, cachePages)) return false;
+    current = stamp;
+    ready = true;
+    return true;
+}
+
+bool IndexedFile::overwrite(RecordRef ref, const string& bytes) {
+    return overwriteAll({{ref, bytes}});
+}
+
+bool IndexedFile::overwriteAll(const vector<pair<RecordRef, string>>& records) {
+    if (!refresh()) return false;
+    for (const auto& record : records) {
+        if (record.second.size() != record.first.length) return false;
+    }
+    // In file order, so the writes move forward through the file; a record
+    // given twice ends with its last bytes
+    vector<size_t> order(records.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return records[a].first.offset < records[b].first.offset; });
+    {
+        fstream file(dataFile, ios::in | ios::out | ios::binary);
+        if (!file.is_open()) return false;
+        // Records that follow on from each other go out as one write
+        string run;
+        uint64_t runStart = 0;
+        for (size_t i : order) {
+            const RecordRef& ref = records[i].first;
+            if (!run.empty() && ref.offset != runStart + run.size()) {
+                if (ref.offset >= runStart && ref.offset + ref.length <= runStart + run.size()) {
+                    run.replace(ref.offset - runStart, ref.length, records[i].second);
+                    continue;
+                }
+                file.seekp(static_cast<streamoff>(runStart));
+                file.write(run.data(), run.size());
+                run.clear();
+            }
+            if (run.empty()) runStart = ref.offset;
+            run += records[i].second;
+        }
+        if (!run.empty()) {
+            file.seekp(static_cast<streamoff>(runStart));
+            file.write(run.data(), run.size());
+        }
+        if (!file) return false;
+    }
+    for (const auto& record : records) data.invalidate(record.first.offset, record.first.length);
+
+    // The entries still hold; tell the indexes about the new file time
+    SourceStamp stamp;
+    if (!stampOf(dataFile, stamp)) return false;
+    for (auto& index : indexes) {
+        if (!index->restamp(stamp)) {
+            ready = false;
+            return false;
+        }
+    }
+    current = stamp;
+    return true;
+}
+
+uint64_t IndexedFile::cacheHits() const {
+    uint64_t hits = data.hits();
+    for (const auto& index : indexes) hits += index->cache().hits();
+    return hits;
+}
+
+uint64_t IndexedFile::cacheMisses() const {
+    uint64_t misses = data.misses();
+    for (const auto& index : indexes) misses += index->cache().misses();
+    return misses;
+}
+
+string intKey(int value) {
+    uint32_t bits = static_cast<uint32_t>(value) ^ 0x80000000u;
+    char key[4] = {static_cast<char>(bits >> 24), static_cast<char>(bits >> 16), static_cast<char>(bits >> 8),
+                   static_cast<char>(bits)};
+    return string(key, 4);
+}
@@ -0,0 +1,108 @@
+#ifndef CSV_INDEX_H
+#define CSV_INDEX_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <sstream>
+#include <algorithm>
+#include "btree.h"
+#include "page_cache.h"
+#include "codec.h"
+
+using namespace std;
+
+// A CSV data file with B+-tree indexes beside it, all read through page
+// caches. Each index records the size and modification time of the data
+// file it describes; refresh() checks the file and, when it has changed,
+// calls `build` to rewrite the indexes before reopening them.
+class IndexedFile {
+private:
+    string dataFile;
+    vector<string> indexFiles;
+    function<bool(const SourceStamp&)> build;
+    size_t cachePages;
+    PageCache data;
+    vector<unique_ptr<BTreeIndex>> indexes;
+    SourceStamp current;
+    bool ready;
+
+    bool openIndexes(const SourceStamp& expected);
+
+public:
+    // `cacheBytes` is split evenly between the data file and the indexes
+    IndexedFile(const string& filename, const vector<string>& indexNames, function<bool(const SourceStamp&)> builder,
+                size_t cacheBytes);
+
+    // Open the indexes, rebuilding them if the data file has changed; false
+    // if the data file cannot be read
+    bool refresh();
+
+    // Index `which`, in the order of the names given to the constructor
+    BTreeIndex& index(size_t which) { return *indexes[which]; }
+
+    // The bytes of one record
+    bool read(RecordRef ref, string& bytes) { return data.read(ref.offset, ref.length, bytes); }
+
+    // Replace a record in place with new bytes of the same length and the
+    // same keys, so every index entry stays valid and nothing is rebuilt
+    bool overwrite(RecordRef ref, const string& bytes);
+    // overwrite() for many records, with one open of the file and one
+    // restamp of the indexes; nothing is written if any length differs
+    bool overwriteAll(const vector<pair<RecordRef, string>>& records);
+
+    const string& filename() const { return dataFile; }
+
+    uint64_t cacheHits() const;
+    uint64_t cacheMisses() const;
+
+    static bool stampOf(const string& filename, SourceStamp& stamp);
+    static string indexFile(const string& filename, const string& name) { return filename + "." + name + ".idx"; }
+};
+
+// Index key for an integer: big-endian with the sign bit flipped, so byte
+// order is numeric order
+string intKey(int value);
+
+// Parse one CSV record of T from its bytes
+template <typename T, typename Traits = EntityTraits<T>>
+bool parseRecord(const string& bytes, T& record) {
+    istringstream in(bytes);
+    CsvFormat::Reader reader(in, bytes.size() + 1);
+    return reader.template read<T, Traits>(record) == READ_OK;
+}
+
+// One pass over a CSV file of T writing a B+-tree per key function, for
+// use as an IndexedFile builder. Entries with equal keys keep file order.
+// Keys are sorted in memory.
+template <typename T, typename Traits = EntityTraits<T>>
+bool buildIndexes(const string& dataFile, const vector<pair<string, function<string(const T&)>>>& keys,
+                  const SourceStamp& stamp) {
+    ifstream file(dataFile, ios::in | ios::binary);
+    if (!file.is_open()) return false;
+
+    vector<vector<pair<string, RecordRef>>> entries(keys.size());
+    CsvFormat::Reader reader(file);
+    ReadResult result;
+    do {
+        T record;
+        result = reader.template read<T, Traits>(record);
+        if (result != READ_OK) continue;
+        RecordRef ref{reader.offset(), static_cast<uint32_t>(reader.length())};
+        for (size_t i = 0; i < keys.size(); ++i) entries[i].emplace_back(keys[i].second(record), ref);
+    } while (result != READ_END);
+
+    auto byKey = [](const pair<string, RecordRef>& a, const pair<string, RecordRef>& b) { return a.first < b.first; };
+    for (size_t i = 0; i < keys.size(); ++i) {
+        stable_sort(entries[i].begin(), entries[i].end(), byKey);
+        BTreeBuilder builder;
+        if (!builder.open(IndexedFile::indexFile(dataFile, keys[i].first))) return false;
+        for (const auto& entry : entries[i]) builder.add(entry.first, entry.second);
+        if (!builder.finish(stamp)) return false;
+        vector<pair<string, RecordRef>>().swap(entries[i]);
+    }
+    return true;
+}
+
+#endif
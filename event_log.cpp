@@ -0,0 +1,412 @@
+#include "event_log.h"
+#include "order_store.h"
+#include "codec.h"
+#include "metrics.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+
+namespace {
+
+// IDs past this are not tracked; the state is dense up to the largest ID
+const int MAX_TRACKED_ID = 1 << 26;
+
+// Snapshot files start with this, then the state; see writeSnapshot()
+const char SNAPSHOT_MAGIC[8] = {'W', 'M', 'S', 'S', 'N', 'A', 'P', '1'};
+
+// Events read per disk read while replaying
+const size_t REPLAY_CHUNK_EVENTS = 1 << 14;
+
+size_t recordBytes() {
+    static const size_t bytes = []() {
+        string encoded;
+        BinaryFormat::encode(encoded, LedgerEvent{});
+        return encoded.size();
+    }();
+    return bytes;
+}
+
+template <typename V>
+void writeValue(ostream& out, const V& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename V>
+bool readValue(istream& in, V& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+}  // namespace
+
+void LedgerState::apply(const LedgerEvent& event) {
+    sequence = event.sequence;
+    at = event.at;
+    if (event.kind == EVENT_STOCK) {
+        if (event.productID <= 0 || event.productID >= MAX_TRACKED_ID) return;
+        if (stock.size() <= static_cast<size_t>(event.productID)) stock.resize(event.productID + 1, 0);
+        stock[event.productID] += event.quantity;
+    } else {
+        if (event.orderID <= 0 || event.orderID >= MAX_TRACKED_ID) return;
+        if (orders.size() <= static_cast<size_t>(event.orderID)) orders.resize(event.orderID + 1, 0);
+        orders[event.orderID] = static_cast<uint8_t>(event.status);
+    }
+}
+
+int LedgerState::quantity(int productID) const {
+    return productID > 0 && static_cast<size_t>(productID) < stock.size() ? stock[productID] : 0;
+}
+
+int LedgerState::status(int orderID) const {
+    return orderID > 0 && static_cast<size_t>(orderID) < orders.size() ? orders[orderID] : 0;
+}
+
+EventLog::EventLog(uint64_t snapshotEvery, uint64_t eventsPerSegment)
+    : snapshotInterval(max<uint64_t>(snapshotEvery, 1)),
+      segmentEvents(max<uint64_t>(eventsPerSegment, 1)),
+      opened(false),
+      tailFirst(1) {}
+
+string EventLog::segmentFile(uint64_t first) const {
+    char name[48];
+    snprintf(name, sizeof(name), "segment-%020llu.log", static_cast<unsigned long long>(first));
+    return directory + "/" + name;
+}
+
+string EventLog::snapshotFile(uint64_t sequence) const {
+    char name[48];
+    snprintf(name, sizeof(name), "snapshot-%020llu.snap", static_cast<unsigned long long>(sequence));
+    return directory + "/" + name;
+}
+
+bool EventLog::open(const string& dir) {
+    TRACE_SCOPE("EventLog::open");
+    lock_guard<mutex> guard(lock);
+    directory = dir;
+    error_code error;
+    filesystem::create_directories(directory, error);
+    if (error) return false;
+
+    segments.clear();
+    snapshots.clear();
+    for (const auto& entry : filesystem::directory_iterator(directory, error)) {
+        string name = entry.path().filename().string();
+        unsigned long long number;
+        int length = 0;
+        if (sscanf(name.c_str(), "segment-%llu.log%n", &number, &length) == 1 && length == static_cast<int>(name.size())) {
+            segments.push_back(number);
+        } else if (sscanf(name.c_str(), "snapshot-%llu.snap%n", &number, &length) == 1 &&
+                   length == static_cast<int>(name.size())) {
+            ifstream in(entry.path(), ios::binary);
+            char magic[sizeof(SNAPSHOT_MAGIC)];
+            Snapshot snapshot;
+            int64_t at;
+            if (in.read(magic, sizeof(magic)) && equal(magic, magic + sizeof(magic), SNAPSHOT_MAGIC) &&
+                readValue(in, snapshot.sequence) && readValue(in, at) && snapshot.sequence == number) {
+                snapshot.at = static_cast<time_t>(at);
+                snapshots.push_back(snapshot);
+            }
+        }
+    }
+    if (error) return false;
+    sort(segments.begin(), segments.end());
+    sort(snapshots.begin(), snapshots.end(), [](const Snapshot& a, const Snapshot& b) { return a.sequence < b.sequence; });
+
+    // A torn record at the end of the last segment never happened
+    uint64_t end = 0;
+    if (!segments.empty()) {
+        string last = segmentFile(segments.back());
+        uintmax_t bytes = filesystem::file_size(last, error);
+        if (error) return false;
+        if (bytes % recordBytes() != 0) filesystem::resize_file(last, bytes - bytes % recordBytes(), error);
+        if (error) return false;
+        end = segments.back() + bytes / recordBytes() - 1;
+    }
+    // A snapshot past the end of the log describes events that were lost
+    while (!snapshots.empty() && snapshots.back().sequence > end) {
+        filesystem::remove(snapshotFile(snapshots.back().sequence), error);
+        snapshots.pop_back();
+    }
+
+    LedgerState state;
+    if (!snapshots.empty() && !loadSnapshot(snapshots.back().sequence, state)) return false;
+    if (!replay(state, end, numeric_limits<time_t>::max(), segments)) return false;
+    current = move(state);
+
+    tail.close();
+    tailFirst = segments.empty() ? current.sequence + 1 : segments.back();
+    opened = true;
+    return true;
+}
+
+LedgerEvent EventLog::stockChanged(int productID, int quantity, int orderID) {
+    return LedgerEvent{0, 0, EVENT_STOCK, productID, orderID, quantity, 0};
+}
+
+LedgerEvent EventLog::orderCreated(int orderID) {
+    return LedgerEvent{0, 0, EVENT_ORDER_CREATED, 0, orderID, 0, ORDER_PENDING};
+}
+
+LedgerEvent EventLog::statusChanged(int orderID, OrderStatus status) {
+    return LedgerEvent{0, 0, EVENT_ORDER_STATUS, 0, orderID, 0, status};
+}
+
+bool EventLog::append(vector<LedgerEvent> events, time_t at) {
+    lock_guard<mutex> guard(lock);
+    return appendLocked(events, at);
+}
+
+bool EventLog::appendLocked(vector<LedgerEvent>& events, time_t at) {
+    static Counter appended("wms_events_appended_total", "Events written to the event log");
+    if (!opened || events.empty()) return true;
+
+    time_t now = max(at != 0 ? at : time(nullptr), current.at);
+    string buffer;
+    buffer.reserve(events.size() * recordBytes());
+    // Events reach the state only once they are written, so a failed write
+    // leaves the state matching the log and the next append reuses their
+    // sequence numbers
+    size_t applied = 0;
+    auto commit = [&](size_t end) {
+        if (!writeTail(buffer, current.sequence + 1)) return false;
+        for (; applied < end; ++applied) current.apply(events[applied]);
+        return true;
+    };
+    bool written = true;
+    bool snapshotted = true;
+    for (size_t i = 0; i < events.size() && written; ++i) {
+        uint64_t sequence = current.sequence + 1 + (i - applied);
+        if (sequence - tailFirst >= segmentEvents) {
+            written = commit(i);
+            if (!written) break;
+            tail.close();
+            tailFirst = sequence;
+        }
+        LedgerEvent& event = events[i];
+        event.sequence = sequence;
+        event.at = now;
+        BinaryFormat::encode(buffer, event);
+        // The events a snapshot covers reach the log first
+        if (sequence % snapshotInterval == 0) {
+            written = commit(i + 1);
+            if (written) snapshotted = writeSnapshot() && snapshotted;
+        }
+    }
+    if (written) written = commit(events.size());
+    appended.increment(applied);
+    return written && snapshotted;
+}
+
+// Hand the encoded events, the first numbered `first`, to the OS. Opening
+// the segment cuts off whatever a failed write left past the events
+// already applied. A failed write closes it again.
+bool EventLog::writeTail(string& buffer, uint64_t first) {
+    if (buffer.empty()) return true;
+    if (!tail.is_open()) {
+        string path = segmentFile(tailFirst);
+        uintmax_t expected = (first - tailFirst) * recordBytes();
+        error_code error;
+        uintmax_t bytes = filesystem::exists(path, error) ? filesystem::file_size(path, error) : 0;
+        if (error || bytes < expected) return false;
+        if (bytes > expected) {
+            filesystem::resize_file(path, expected, error);
+            if (error) return false;
+        }
+        tail.open(path, ios::binary | ios::app);
+        if (!tail.is_open()) return false;
+        if (segments.empty() || segments.back() != tailFirst) segments.push_back(tailFirst);
+    }
+    tail.write(buffer.data(), buffer.size());
+    tail.flush();
+    buffer.clear();
+    if (tail) return true;
+    tail.close();
+    tail.clear();
+    return false;
+}
+
+// Magic, sequence, time, then the stock and order arrays, each behind its
+// length. Written aside and renamed into place.
+bool EventLog::writeSnapshot() {
+    TRACE_SCOPE("EventLog::writeSnapshot");
+    static Counter written("wms_event_snapshots_total", "Snapshots of the event log state written");
+    string path = snapshotFile(current.sequence);
+    {
+        ofstream out(path + ".tmp", ios::binary | ios::trunc);
+        out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        writeValue(out, current.sequence);
+        writeValue(out, static_cast<int64_t>(current.at));
+        writeValue(out, static_cast<uint64_t>(current.stock.size()));
+        out.write(reinterpret_cast<const char*>(current.stock.data()), current.stock.size() * sizeof(int32_t));
+        writeValue(out, static_cast<uint64_t>(current.orders.size()));
+        out.write(reinterpret_cast<const char*>(current.orders.data()), current.orders.size());
+        out.close();
+        if (out.fail()) return false;
+    }
+    error_code error;
+    filesystem::rename(path + ".tmp", path, error);
+    if (error) return false;
+    snapshots.push_back(Snapshot{current.sequence, current.at});
+    written.increment();
+    return true;
+}
+
+bool EventLog::loadSnapshot(uint64_t sequence, LedgerState& state) const {
+    ifstream in(snapshotFile(sequence), ios::binary);
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    int64_t at;
+    uint64_t stockCount, orderCount;
+    if (!in.read(magic, sizeof(magic)) || !equal(magic, magic + sizeof(magic), SNAPSHOT_MAGIC) ||
+        !readValue(in, state.sequence) || !readValue(in, at) || !readValue(in, stockCount) ||
+        stockCount > static_cast<uint64_t>(MAX_TRACKED_ID)) {
+        return false;
+    }
+    state.at = static_cast<time_t>(at);
+    state.stock.resize(stockCount);
+    if (!in.read(reinterpret_cast<char*>(state.stock.data()), stockCount * sizeof(int32_t)) ||
+        !readValue(in, orderCount) || orderCount > static_cast<uint64_t>(MAX_TRACKED_ID)) {
+        return false;
+    }
+    state.orders.resize(orderCount);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(state.orders.data()), orderCount));
+}
+
+bool EventLog::replay(LedgerState& state, uint64_t last, time_t until, const vector<uint64_t>& segmentList) const {
+    uint64_t next = state.sequence + 1;
+    // The segment holding `next`: the last one starting at or before it
+    auto segment = upper_bound(segmentList.begin(), segmentList.end(), next);
+    if (segment == segmentList.begin()) return segmentList.empty();
+    --segment;
+
+    size_t bytes = recordBytes();
+    string chunk;
+    for (; segment != segmentList.end() && next <= last; ++segment) {
+        // The segment before ended short of this one: events are missing
+        if (*segment > next) return false;
+        ifstream in(segmentFile(*segment), ios::binary);
+        if (!in.is_open()) return false;
+        in.seekg(static_cast<streamoff>((next - *segment) * bytes));
+        for (;;) {
+            chunk.resize(REPLAY_CHUNK_EVENTS * bytes);
+            in.read(&chunk[0], chunk.size());
+            size_t count = static_cast<size_t>(in.gcount()) / bytes;
+            for (size_t i = 0; i < count; ++i) {
+                LedgerEvent event;
+                if (!BinaryFormat::decode(string_view(chunk.data() + i * bytes, bytes), event)) return false;
+                if (event.sequence != next) return false;
+                if (next > last || event.at > until) return true;
+                state.apply(event);
+                ++next;
+            }
+            if (count < REPLAY_CHUNK_EVENTS) break;
+        }
+    }
+    return true;
+}
+
+size_t EventLog::reconcileStock(const vector<Product>& inventory) {
+    TRACE_SCOPE("EventLog::reconcileStock");
+    lock_guard<mutex> guard(lock);
+    if (!opened) return 0;
+
+    vector<LedgerEvent> events;
+    vector<char> listed(current.stock.size(), 0);
+    for (const auto& product : inventory) {
+        int id = product.getID();
+        if (id > 0 && static_cast<size_t>(id) < listed.size()) listed[id] = 1;
+        int difference = product.getQuantity() - current.quantity(id);
+        if (difference != 0) events.push_back(stockChanged(id, difference));
+    }
+    // Deleted products leave with whatever they held
+    for (size_t id = 1; id < listed.size(); ++id) {
+        if (!listed[id] && current.stock[id] != 0) events.push_back(stockChanged(static_cast<int>(id), -current.stock[id]));
+    }
+    size_t count = events.size();
+    if (!appendLocked(events, 0)) cerr << "Unable to write to the event log in " << directory << "\n";
+    return count;
+}
+
+size_t EventLog::reconcileOrders(OrderStore& store) {
+    TRACE_SCOPE("EventLog::reconcileOrders");
+    lock_guard<mutex> guard(lock);
+    if (!opened) return 0;
+
+    vector<LedgerEvent> events;
+    store.scanHeaders([&](Order& order) {
+        int known = current.status(order.getID());
+        if (known == 0) {
+            events.push_back(orderCreated(order.getID()));
+            if (order.getStatus() != ORDER_PENDING) events.push_back(statusChanged(order.getID(), order.getStatus()));
+        } else if (known != order.getStatus()) {
+            events.push_back(statusChanged(order.getID(), order.getStatus()));
+        }
+        return true;
+    });
+    size_t count = events.size();
+    if (!appendLocked(events, 0)) cerr << "Unable to write to the event log in " << directory << "\n";
+    return count;
+}
+
+LedgerState EventLog::state() const {
+    lock_guard<mutex> guard(lock);
+    return current;
+}
+
+bool EventLog::stateAt(time_t at, LedgerState& state, ReplayStats* stats) const {
+    TRACE_SCOPE("EventLog::stateAt");
+    static Histogram replayTime("wms_event_replay_seconds", "Time to rebuild a past state from the event log");
+    ScopedTimer timer(replayTime);
+    auto start = chrono::steady_clock::now();
+
+    // What the log holds now; later appends are not waited for
+    uint64_t last;
+    uint64_t from = 0;
+    bool latest = false;
+    vector<uint64_t> segmentList;
+    {
+        lock_guard<mutex> guard(lock);
+        if (!opened) return false;
+        last = current.sequence;
+        if (current.at <= at) {
+            // Nothing has happened since: the current state is the answer
+            state = current;
+            from = last;
+            latest = true;
+        } else {
+            segmentList = segments;
+            // The last snapshot taken at or before `at`
+            auto after = upper_bound(snapshots.begin(), snapshots.end(), at,
+                                     [](time_t time, const Snapshot& snapshot) { return time < snapshot.at; });
+            if (after != snapshots.begin()) from = prev(after)->sequence;
+        }
+    }
+
+    if (!latest) {
+        state = LedgerState();
+        if (from > 0 && !loadSnapshot(from, state)) return false;
+        if (!replay(state, last, at, segmentList)) return false;
+    }
+    if (stats) {
+        stats->snapshotSequence = from;
+        stats->eventsReplayed = state.sequence - from;
+        stats->seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    return true;
+}
+
+uint64_t EventLog::lastSequence() const {
+    lock_guard<mutex> guard(lock);
+    return current.sequence;
+}
+
+size_t EventLog::segmentCount() const {
+    lock_guard<mutex> guard(lock);
+    return segments.size();
+}
+
+size_t EventLog::snapshotCount() const {
+    lock_guard<mutex> guard(lock);
+    return snapshots.size();
+}
@@ -0,0 +1,164 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <fstream>
+#include <cstdint>
+#include <ctime>
+#include "order.h"
+#include "product.h"
+#include "repository.h"
+
+using namespace std;
+
+class OrderStore;
+
+enum EventKind {
+    EVENT_STOCK = 1,          // a product's quantity changed
+    EVENT_ORDER_CREATED = 2,
+    EVENT_ORDER_STATUS = 3
+};
+
+// One entry of the event log. Written once, never changed.
+struct LedgerEvent {
+    uint64_t sequence;  // from 1, without gaps
+    time_t at;          // never earlier than the event before
+    EventKind kind;
+    int productID;      // stock events
+    int orderID;        // order events; on a stock event the order behind it, or 0
+    int quantity;       // stock events: units added, negative when removed
+    int status;         // order events: the OrderStatus afterwards
+};
+
+// Stock and order statuses as of one event: the log folded up to it. Kept
+// dense by ID, as the ID sequences hand IDs out from 1.
+struct LedgerState {
+    uint64_t sequence;       // the last event applied, 0 for none
+    time_t at;
+    vector<int32_t> stock;   // by productID
+    vector<uint8_t> orders;  // OrderStatus by orderID, 0 where the order did not exist yet
+
+    LedgerState() : sequence(0), at(0) {}
+
+    void apply(const LedgerEvent& event);
+
+    int quantity(int productID) const;
+    // 0 if the order did not exist
+    int status(int orderID) const;
+};
+
+// How a past state was rebuilt
+struct ReplayStats {
+    uint64_t snapshotSequence;  // where the replay started: a snapshot, the current state, or 0
+    uint64_t eventsReplayed;
+    double seconds;
+};
+
+// Every stock change, new order and status change, as an append-only log
+// of fixed-size binary records. The log is split into segment files of
+// segmentEvents records, each named after its first sequence number. A
+// crash mid-append leaves part of a record at the end of the last segment,
+// and open() cuts it off. A failed write does the same: its events are not
+// applied, and the segment is cut back to the last applied event before
+// the next write.
+//
+// The current state is kept in memory as events are written. Every
+// snapshotInterval events it is also written out as a snapshot. The state
+// at a past time is then the last snapshot taken before it plus at most
+// snapshotInterval events replayed from the segments.
+//
+// The log only knows what happened while it was open. On first use,
+// reconcileStock() and reconcileOrders() record the files as they stand.
+// On later runs they record whatever was changed without the log.
+class EventLog {
+private:
+    struct Snapshot {
+        uint64_t sequence;
+        time_t at;
+    };
+
+    uint64_t snapshotInterval;
+    uint64_t segmentEvents;
+
+    string directory;
+    bool opened;
+    // Guards everything below. Appends come from the menus and from the
+    // fulfillment worker.
+    mutable mutex lock;
+    LedgerState current;
+    vector<uint64_t> segments;  // first sequence of each, ascending
+    vector<Snapshot> snapshots;  // ascending
+    ofstream tail;              // the last segment, once opened for appending
+    uint64_t tailFirst;
+
+    string segmentFile(uint64_t first) const;
+    string snapshotFile(uint64_t sequence) const;
+
+    // With the lock held
+    bool appendLocked(vector<LedgerEvent>& events, time_t at);
+    bool writeTail(string& buffer, uint64_t first);
+    bool writeSnapshot();
+
+    bool loadSnapshot(uint64_t sequence, LedgerState& state) const;
+    // Apply the events after state.sequence, up to and including `last`,
+    // that happened at or before `until`
+    bool replay(LedgerState& state, uint64_t last, time_t until, const vector<uint64_t>& segmentList) const;
+
+public:
+    static const uint64_t SNAPSHOT_INTERVAL = 1 << 18;
+    static const uint64_t SEGMENT_EVENTS = 1 << 20;
+
+    explicit EventLog(uint64_t snapshotEvery = SNAPSHOT_INTERVAL, uint64_t eventsPerSegment = SEGMENT_EVENTS);
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    // Open or create the log in `dir` and rebuild the current state from
+    // the last snapshot and the events after it. Until this succeeds the
+    // log records nothing and every append succeeds.
+    bool open(const string& dir);
+    bool isOpen() const { return opened; }
+
+    static LedgerEvent stockChanged(int productID, int quantity, int orderID = 0);
+    static LedgerEvent orderCreated(int orderID);
+    static LedgerEvent statusChanged(int orderID, OrderStatus status);
+
+    // Stamp the events with their sequence numbers and a time and write
+    // them out together. The time is `at`, or now if 0; it is never earlier
+    // than the last event's.
+    bool append(vector<LedgerEvent> events, time_t at = 0);
+
+    // Record a stock event for every product whose quantity differs from
+    // the log's, and empty any product no longer in `inventory`. Returns
+    // how many events were written.
+    size_t reconcileStock(const vector<Product>& inventory);
+    // The same for the status of every order on file
+    size_t reconcileOrders(OrderStore& store);
+
+    // A copy of the current state
+    LedgerState state() const;
+    // The state after every event up to `at`; false if the log cannot be read
+    bool stateAt(time_t at, LedgerState& state, ReplayStats* stats = nullptr) const;
+
+    uint64_t lastSequence() const;
+    size_t segmentCount() const;
+    size_t snapshotCount() const;
+};
+
+template <>
+struct EntityTraits<LedgerEvent> {
+    static constexpr auto fields = make_tuple(
+        field("sequence", &LedgerEvent::sequence),
+        field("at", &LedgerEvent::at),
+        field("kind", &LedgerEvent::kind),
+        field("productID", &LedgerEvent::productID),
+        field("orderID", &LedgerEvent::orderID),
+        field("quantity", &LedgerEvent::quantity),
+        field("status", &LedgerEvent::status));
+
+    static int keyOf(const LedgerEvent& event) { return static_cast<int>(event.sequence); }
+};
+
+#endif
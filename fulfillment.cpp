@@ -0,0 +1,197 @@
+#include "fulfillment.h"
+#include "metrics.h"
+#include "trace.h"
+
+namespace {
+
+// Allowed moves as a bitmask of target statuses per source status
+const unsigned TRANSITIONS[] = {
+    0,                                                 // (none)
+    1u << ORDER_PROCESSING | 1u << ORDER_CANCELLED,    // Pending
+    1u << ORDER_SHIPPED | 1u << ORDER_CANCELLED,       // Processing
+    1u << ORDER_DELIVERED,                             // Shipped
+    0,                                                 // Delivered
+    0                                                  // Cancelled
+};
+
+}  // namespace
+
+FulfillmentPipeline::FulfillmentPipeline(size_t queueCapacity, size_t batch)
+    : chunks(new atomic<atomic<uint8_t>*>[CHUNK_COUNT]),
+      queue(queueCapacity),
+      batchSize(batch > 0 ? batch : 1),
+      running(false),
+      parked(false),
+      acceptedCount(0),
+      handledCount(0) {
+    for (size_t i = 0; i < CHUNK_COUNT; ++i) chunks[i].store(nullptr, memory_order_relaxed);
+}
+
+FulfillmentPipeline::~FulfillmentPipeline() {
+    stop();
+    for (size_t i = 0; i < CHUNK_COUNT; ++i) delete[] chunks[i].load(memory_order_relaxed);
+}
+
+bool FulfillmentPipeline::allowed(OrderStatus from, OrderStatus to) {
+    if (from < ORDER_PENDING || from > ORDER_CANCELLED) return false;
+    return (TRANSITIONS[from] >> to & 1u) != 0;
+}
+
+atomic<uint8_t>* FulfillmentPipeline::slotFor(int orderID, bool create) {
+    if (orderID < 0) return nullptr;
+    size_t index = static_cast<size_t>(orderID) >> CHUNK_BITS;
+    atomic<uint8_t>* chunk = chunks[index].load(memory_order_acquire);
+    if (!chunk && create) {
+        atomic<uint8_t>* fresh = new atomic<uint8_t>[size_t(1) << CHUNK_BITS];
+        for (size_t i = 0; i < (size_t(1) << CHUNK_BITS); ++i) fresh[i].store(0, memory_order_relaxed);
+        // Another thread may have installed one first; keep theirs
+        if (chunks[index].compare_exchange_strong(chunk, fresh, memory_order_acq_rel)) {
+            chunk = fresh;
+        } else {
+            delete[] fresh;
+        }
+    }
+    return chunk ? &chunk[orderID & ((1 << CHUNK_BITS) - 1)] : nullptr;
+}
+
+void FulfillmentPipeline::track(int orderID, OrderStatus status) {
+    atomic<uint8_t>* slot = slotFor(orderID, true);
+    if (!slot) return;
+    uint8_t untracked = 0;
+    slot->compare_exchange_strong(untracked, static_cast<uint8_t>(status), memory_order_acq_rel);
+}
+
+int FulfillmentPipeline::status(int orderID) {
+    atomic<uint8_t>* slot = slotFor(orderID, false);
+    return slot ? slot->load(memory_order_acquire) & ~BUSY : 0;
+}
+
+TransitionResult FulfillmentPipeline::transition(int orderID, OrderStatus to) {
+    static Counter accepted("wms_order_transitions_total", "Order status changes by outcome", "result=\"accepted\"");
+    static Counter rejected("wms_order_transitions_total", "Order status changes by outcome", "result=\"rejected\"");
+
+    atomic<uint8_t>* slot = slotFor(orderID, false);
+    uint8_t current = slot ? slot->load(memory_order_acquire) : 0;
+    if (current == 0) {
+        rejected.increment();
+        return TRANSITION_UNKNOWN_ORDER;
+    }
+    // The order stays BUSY from the swap until its event is queued, so the
+    // events of one order reach the queue in the order they happened
+    for (;;) {
+        if (current & BUSY) {
+            this_thread::yield();
+            current = slot->load(memory_order_acquire);
+            continue;
+        }
+        if (!allowed(static_cast<OrderStatus>(current), to)) {
+            rejected.increment();
+            return TRANSITION_NOT_ALLOWED;
+        }
+        if (slot->compare_exchange_weak(current, static_cast<uint8_t>(to | BUSY), memory_order_acq_rel)) break;
+    }
+
+    StatusEvent event{orderID, static_cast<OrderStatus>(current), to, time(nullptr)};
+    // A full queue pushes back on the callers until the worker catches up
+    while (!queue.tryPush(event)) this_thread::yield();
+    slot->store(static_cast<uint8_t>(to), memory_order_release);
+    acceptedCount.fetch_add(1, memory_order_release);
+    accepted.increment();
+    // Pairs with the fence in run(): either the worker sees the event or we
+    // see that it is parked
+    atomic_thread_fence(memory_order_seq_cst);
+    if (parked.load(memory_order_relaxed)) {
+        lock_guard<mutex> guard(parkLock);
+        wakeup.notify_one();
+    }
+    return TRANSITION_ACCEPTED;
+}
+
+size_t FulfillmentPipeline::transitionAll(const vector<int>& orderIDs, OrderStatus to, vector<TransitionResult>* results) {
+    TRACE_SCOPE("FulfillmentPipeline::transitionAll");
+    if (results) results->assign(orderIDs.size(), TRANSITION_ACCEPTED);
+    size_t moved = 0;
+    for (size_t i = 0; i < orderIDs.size(); ++i) {
+        TransitionResult result = transition(orderIDs[i], to);
+        if (result == TRANSITION_ACCEPTED) ++moved;
+        if (results) (*results)[i] = result;
+    }
+    return moved;
+}
+
+void FulfillmentPipeline::start() {
+    if (running.exchange(true)) return;
+    worker = thread(&FulfillmentPipeline::run, this);
+}
+
+void FulfillmentPipeline::stop() {
+    if (!running.exchange(false)) return;
+    {
+        lock_guard<mutex> guard(parkLock);
+        wakeup.notify_one();
+    }
+    worker.join();
+    runDeferred();
+}
+
+void FulfillmentPipeline::flush() {
+    uint64_t target = acceptedCount.load(memory_order_acquire);
+    {
+        unique_lock<mutex> guard(doneLock);
+        done.wait(guard, [&] { return handledCount.load(memory_order_acquire) >= target || !running.load(); });
+    }
+    runDeferred();
+}
+
+void FulfillmentPipeline::runDeferred() {
+    vector<vector<StatusEvent>> batches;
+    {
+        lock_guard<mutex> guard(deferredLock);
+        batches.swap(deferredBatches);
+    }
+    for (const auto& batch : batches) {
+        for (const auto& handler : deferredHandlers) handler(batch);
+    }
+}
+
+void FulfillmentPipeline::run() {
+    static Histogram batchTime("wms_fulfillment_batch_seconds", "Time to run the handlers over one batch of status events");
+    vector<StatusEvent> batch;
+    batch.reserve(batchSize);
+    for (;;) {
+        StatusEvent event;
+        while (batch.size() < batchSize && queue.tryPop(event)) batch.push_back(event);
+
+        if (!batch.empty()) {
+            {
+                TRACE_SCOPE("fulfillment: batch");
+                ScopedTimer timer(batchTime);
+                for (const auto& handler : handlers) handler(batch);
+            }
+            if (!deferredHandlers.empty()) {
+                lock_guard<mutex> guard(deferredLock);
+                deferredBatches.push_back(batch);
+            }
+            handledCount.fetch_add(batch.size(), memory_order_release);
+            batch.clear();
+            lock_guard<mutex> guard(doneLock);
+            done.notify_all();
+            continue;
+        }
+
+        // Events still arriving from a transition() racing stop() are
+        // handled before the worker leaves
+        if (!running.load(memory_order_acquire) && handledCount.load() >= acceptedCount.load()) break;
+
+        // Nothing queued: sleep until a producer sees `parked` and wakes us.
+        // Producers notify under parkLock, so the wakeup cannot fall between
+        // the check and the wait.
+        unique_lock<mutex> guard(parkLock);
+        parked.store(true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        wakeup.wait(guard, [this] { return !queue.empty() || !running.load(); });
+        parked.store(false, memory_order_relaxed);
+    }
+    lock_guard<mutex> guard(doneLock);
+    done.notify_all();
+}
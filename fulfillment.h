@@ -0,0 +1,138 @@
+#ifndef FULFILLMENT_H
+#define FULFILLMENT_H
+
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <ctime>
+#include "order.h"
+#include "mpsc_queue.h"
+#include "repository.h"
+
+using namespace std;
+
+// One accepted status change
+struct StatusEvent {
+    int orderID;
+    OrderStatus from;
+    OrderStatus to;
+    time_t at;
+};
+
+enum TransitionResult {
+    TRANSITION_ACCEPTED,
+    TRANSITION_UNKNOWN_ORDER,  // never tracked
+    TRANSITION_NOT_ALLOWED     // not a legal move from the current status
+};
+
+// The order lifecycle:
+//
+//   Pending -> Processing -> Shipped -> Delivered
+//      |           |
+//      +-----------+--> Cancelled
+//
+// transition() checks a move against the order's current status and
+// applies it with one compare-and-swap, so concurrent callers cannot both
+// move the same order out of a status. Accepted moves become StatusEvents
+// on a lock-free queue. One worker thread drains the queue in batches and
+// hands each batch to the subscribed handlers, in subscription order:
+// persisting, patching caches and analytics, restocking.
+//
+// Handlers that touch state the caller owns, and that is not thread-safe,
+// subscribe as deferred instead: the worker sets their batches aside and
+// they run on the thread that calls flush(), after the worker's handlers.
+//
+// The pipeline only knows orders it was told about with track(); statuses
+// changed by other processes are not seen.
+class FulfillmentPipeline {
+public:
+    typedef function<void(const vector<StatusEvent>&)> Handler;
+
+private:
+    // Current status per order ID, 0 if untracked. Chunks of the ID space
+    // are allocated on first use and never freed, so lookups take no lock.
+    static const int CHUNK_BITS = 16;
+    static const size_t CHUNK_COUNT = size_t(1) << (31 - CHUNK_BITS);
+    unique_ptr<atomic<atomic<uint8_t>*>[]> chunks;
+    // Set on a status while its event is being queued
+    static const uint8_t BUSY = 0x80;
+
+    MpscQueue<StatusEvent> queue;
+    size_t batchSize;
+    vector<Handler> handlers;
+    vector<Handler> deferredHandlers;
+    // Handled batches waiting for the deferred handlers
+    mutex deferredLock;
+    vector<vector<StatusEvent>> deferredBatches;
+
+    thread worker;
+    atomic<bool> running;
+    atomic<bool> parked;
+    mutex parkLock;
+    condition_variable wakeup;
+
+    atomic<uint64_t> acceptedCount;
+    atomic<uint64_t> handledCount;
+    mutex doneLock;
+    condition_variable done;
+
+    // Null if `create` is false and the chunk does not exist yet
+    atomic<uint8_t>* slotFor(int orderID, bool create);
+
+    void run();
+    // The deferred handlers over the batches set aside so far
+    void runDeferred();
+
+public:
+    explicit FulfillmentPipeline(size_t queueCapacity = 1 << 16, size_t batch = 4096);
+    ~FulfillmentPipeline();
+
+    FulfillmentPipeline(const FulfillmentPipeline&) = delete;
+    FulfillmentPipeline& operator=(const FulfillmentPipeline&) = delete;
+
+    static bool allowed(OrderStatus from, OrderStatus to);
+
+    // Register before start()
+    void subscribe(Handler handler) { handlers.push_back(move(handler)); }
+    void subscribeDeferred(Handler handler) { deferredHandlers.push_back(move(handler)); }
+    void start();
+    // Handle everything accepted so far, then stop the worker and run the
+    // deferred handlers
+    void stop();
+
+    // Learn an order's status; ignored if the order is already tracked
+    void track(int orderID, OrderStatus status);
+    // The tracked status, or 0 if the order is not tracked
+    int status(int orderID);
+
+    TransitionResult transition(int orderID, OrderStatus to);
+    // transition() for each order in turn, returning how many moved. The
+    // worker picks the events up in batches, so the files are written once
+    // per batch rather than once per order. With `results`, one outcome per
+    // order, in order.
+    size_t transitionAll(const vector<int>& orderIDs, OrderStatus to, vector<TransitionResult>* results = nullptr);
+
+    // Wait until every event accepted before the call has been handled,
+    // then run the deferred handlers on this thread
+    void flush();
+
+    uint64_t accepted() const { return acceptedCount.load(memory_order_relaxed); }
+    uint64_t handled() const { return handledCount.load(memory_order_relaxed); }
+};
+
+template <>
+struct EntityTraits<StatusEvent> {
+    static constexpr auto fields = make_tuple(
+        field("orderID", &StatusEvent::orderID),
+        field("from", &StatusEvent::from),
+        field("to", &StatusEvent::to),
+        field("at", &StatusEvent::at));
+
+    static int keyOf(const StatusEvent& event) { return event.orderID; }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "id_sequence.h"
+#include "metrics.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/file.h>
+#endif
+
+void IdSequence::bind(const string& path, function<int()> highest) {
+    lock_guard<mutex> guard(leaseLock);
+    filename = path;
+    highestInUse = move(highest);
+    // Whatever was leased in memory still counts as used
+    uint64_t current = window.load(memory_order_acquire);
+    uint32_t next = static_cast<uint32_t>(current);
+    window.store(pack(next, next), memory_order_release);
+}
+
+int IdSequence::next() {
+    uint64_t current = window.load(memory_order_acquire);
+    for (;;) {
+        uint32_t id = static_cast<uint32_t>(current);
+        uint32_t end = static_cast<uint32_t>(current >> 32);
+        if (id < end) {
+            if (window.compare_exchange_weak(current, pack(id + 1, end), memory_order_acq_rel)) return static_cast<int>(id);
+            continue;
+        }
+        lease(current);
+        current = window.load(memory_order_acquire);
+    }
+}
+
+void IdSequence::lease(uint64_t seen) {
+    static Counter leases("wms_id_leases_total", "ID blocks leased from the sequence files");
+    lock_guard<mutex> guard(leaseLock);
+    if (window.load(memory_order_acquire) != seen) return;
+
+    uint32_t floor = static_cast<uint32_t>(seen >> 32);
+    uint32_t first = floor;
+    if (!filename.empty() && !reserve(floor, blockSize, first)) {
+        // Carry on in memory rather than refuse to create records
+        cerr << "Unable to lease IDs from " << filename << "; new IDs may repeat after a restart\n";
+    }
+    leases.increment();
+    window.store(pack(first, first + blockSize), memory_order_release);
+}
+
+#ifdef _WIN32
+// No file lock here: leases are only exclusive within the process
+bool IdSequence::reserve(uint32_t floor, uint32_t count, uint32_t& first) {
+    int fd = _open(filename.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, 0644);
+    if (fd < 0) return false;
+    char text[32] = {0};
+    int length = _read(fd, text, sizeof(text) - 1);
+    bool fresh = length <= 0;
+    uint32_t start = fresh ? static_cast<uint32_t>(highestInUse ? highestInUse() : 0) + 1
+                           : static_cast<uint32_t>(strtoul(text, nullptr, 10));
+    first = max(start, floor);
+    string end = to_string(first + count) + "\n";
+    bool written = _lseek(fd, 0, SEEK_SET) == 0 && _chsize(fd, 0) == 0 &&
+                   _write(fd, end.data(), static_cast<unsigned>(end.size())) == static_cast<int>(end.size()) &&
+                   _commit(fd) == 0;
+    _close(fd);
+    return written;
+}
+#else
+bool IdSequence::reserve(uint32_t floor, uint32_t count, uint32_t& first) {
+    error_code error;
+    filesystem::path parent = filesystem::path(filename).parent_path();
+    if (!parent.empty()) filesystem::create_directories(parent, error);
+
+    int fd = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    if (flock(fd, LOCK_EX) != 0) {
+        close(fd);
+        return false;
+    }
+
+    char text[32] = {0};
+    ssize_t length = pread(fd, text, sizeof(text) - 1, 0);
+    // An empty file is a new sequence: start after the records already there
+    bool fresh = length <= 0;
+    uint32_t start = fresh ? static_cast<uint32_t>(highestInUse ? highestInUse() : 0) + 1
+                           : static_cast<uint32_t>(strtoul(text, nullptr, 10));
+    first = max(start, floor);
+
+    // Fixed width, so the rewrite never leaves a longer old value behind
+    char end[16];
+    int endLength = snprintf(end, sizeof(end), "%010u\n", first + count);
+    bool written = pwrite(fd, end, endLength, 0) == endLength && fsync(fd) == 0;
+    flock(fd, LOCK_UN);
+    close(fd);
+    return written;
+}
+#endif
@@ -0,0 +1,55 @@
+#ifndef ID_SEQUENCE_H
+#define ID_SEQUENCE_H
+
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+
+using namespace std;
+
+// IDs handed out from a block at a time
+const int ID_BLOCK = 64;
+
+// Record IDs for one entity that stay unique across restarts and between
+// processes writing the same files. The sequence file holds the end of the
+// last block leased from it; leasing a block takes the file lock, moves the
+// end on and syncs it, so two writers never get the same range. Within the
+// process IDs come from the current block with a compare-and-swap, and only
+// the thread that exhausts a block goes back to the file.
+//
+// IDs left in a block at exit are never used, so sequences have gaps. A
+// sequence file that does not exist yet starts after highestInUse(), which
+// covers data written before there were sequence files. Until bind() is
+// called the sequence only lives in memory and starts at 1.
+class IdSequence {
+private:
+    // Next ID in the low 32 bits, end of the leased block in the high 32
+    atomic<uint64_t> window;
+    mutex leaseLock;
+    string filename;
+    function<int()> highestInUse;
+    int blockSize;
+
+    static uint64_t pack(uint32_t next, uint32_t end) { return static_cast<uint64_t>(end) << 32 | next; }
+
+    // Replace the exhausted window `seen` with a fresh block, unless another
+    // thread already has
+    void lease(uint64_t seen);
+    // Reserve `count` IDs in the sequence file, returning the first
+    bool reserve(uint32_t floor, uint32_t count, uint32_t& first);
+
+public:
+    explicit IdSequence(int block = ID_BLOCK) : window(pack(1, 1)), blockSize(block > 0 ? block : 1) {}
+
+    IdSequence(const IdSequence&) = delete;
+    IdSequence& operator=(const IdSequence&) = delete;
+
+    // Lease later blocks from `path`; the rest of the current block is dropped
+    void bind(const string& path, function<int()> highest);
+
+    int next();
+};
+
+#endif
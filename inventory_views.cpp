@@ -0,0 +1,85 @@
+#include "inventory_views.h"
+
+#include <algorithm>
+
+bool InventoryViews::less(SortKey key, size_t a, size_t b) const {
+    const Product& x = inventory[a];
+    const Product& y = inventory[b];
+    switch (key) {
+        case SORT_BY_NAME:
+            if (x.getName() != y.getName()) return x.getName() < y.getName();
+            break;
+        case SORT_BY_PRICE:
+            if (x.getPrice() != y.getPrice()) return x.getPrice() < y.getPrice();
+            break;
+        case SORT_BY_QUANTITY:
+            if (x.getQuantity() != y.getQuantity()) return x.getQuantity() < y.getQuantity();
+            break;
+        case SORT_BY_CATEGORY:
+            if (x.getCategory() != y.getCategory()) return x.getCategory() < y.getCategory();
+            break;
+        default:
+            break;
+    }
+    return x.getID() < y.getID();
+}
+
+void InventoryViews::rebuild(SortKey key) {
+    vector<size_t>& order = orderings[key];
+    order.resize(inventory.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    sort(order.begin(), order.end(), [this, key](size_t a, size_t b) { return less(key, a, b); });
+    valid[key] = true;
+}
+
+void InventoryViews::insertSorted(SortKey key, size_t index) {
+    vector<size_t>& order = orderings[key];
+    auto pos = upper_bound(order.begin(), order.end(), index,
+                           [this, key](size_t a, size_t b) { return less(key, a, b); });
+    order.insert(pos, index);
+}
+
+void InventoryViews::erase(SortKey key, size_t index) {
+    vector<size_t>& order = orderings[key];
+    auto pos = find(order.begin(), order.end(), index);
+    if (pos != order.end()) order.erase(pos);
+}
+
+const vector<size_t>& InventoryViews::ordering(SortKey key) {
+    if (!valid[key]) rebuild(key);
+    return orderings[key];
+}
+
+void InventoryViews::onProductAdded(size_t index) {
+    for (int k = 0; k < SORT_KEY_COUNT; ++k) {
+        if (valid[k]) insertSorted(static_cast<SortKey>(k), index);
+    }
+}
+
+void InventoryViews::onProductUpdated(size_t index) {
+    for (int k = 0; k < SORT_KEY_COUNT; ++k) {
+        if (!valid[k]) continue;
+        erase(static_cast<SortKey>(k), index);
+        insertSorted(static_cast<SortKey>(k), index);
+    }
+}
+
+void InventoryViews::onProductRemoved(size_t index) {
+    for (int k = 0; k < SORT_KEY_COUNT; ++k) {
+        if (!valid[k]) continue;
+        erase(static_cast<SortKey>(k), index);
+        for (size_t& i : orderings[k]) {
+            if (i > index) --i;
+        }
+    }
+}
+
+const char* InventoryViews::keyLabel(SortKey key) {
+    switch (key) {
+        case SORT_BY_NAME: return "Name";
+        case SORT_BY_PRICE: return "Price";
+        case SORT_BY_QUANTITY: return "Quantity";
+        case SORT_BY_CATEGORY: return "Category";
+        default: return "Unknown";
+    }
+}
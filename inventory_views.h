@@ -0,0 +1,60 @@
+#ifndef INVENTORY_VIEWS_H
+#define INVENTORY_VIEWS_H
+
+#include <vector>
+#include "product.h"
+
+using namespace std;
+
+enum SortKey {
+    SORT_BY_NAME = 0,
+    SORT_BY_PRICE = 1,
+    SORT_BY_QUANTITY = 2,
+    SORT_BY_CATEGORY = 3,
+    SORT_KEY_COUNT = 4
+};
+
+// Cached sorted orderings of the inventory, one index permutation per sort
+// key. An ordering is built on first use and then patched as products are
+// added, updated or removed, so repeated sorted views never re-sort.
+// Bulk changes can invalidate a key instead; it is rebuilt lazily.
+class InventoryViews {
+private:
+    const vector<Product>& inventory;
+    vector<size_t> orderings[SORT_KEY_COUNT];
+    bool valid[SORT_KEY_COUNT];
+
+    // Order by the key, ties broken by product ID
+    bool less(SortKey key, size_t a, size_t b) const;
+
+    void rebuild(SortKey key);
+    void insertSorted(SortKey key, size_t index);
+    void erase(SortKey key, size_t index);
+
+public:
+    explicit InventoryViews(const vector<Product>& source) : inventory(source) {
+        invalidateAll();
+    }
+
+    // Sorted permutation of inventory indices for `key`
+    const vector<size_t>& ordering(SortKey key);
+
+    // inventory[index] was just appended
+    void onProductAdded(size_t index);
+
+    // inventory[index] had one or more fields changed
+    void onProductUpdated(size_t index);
+
+    // inventory[index] was just erased; later indices shift down by one
+    void onProductRemoved(size_t index);
+
+    void invalidate(SortKey key) { valid[key] = false; }
+
+    void invalidateAll() {
+        for (int k = 0; k < SORT_KEY_COUNT; ++k) valid[k] = false;
+    }
+
+    static const char* keyLabel(SortKey key);
+};
+
+#endif
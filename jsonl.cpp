@@ -0,0 +1,72 @@
+#include "jsonl.h"
+
+#include <charconv>
+#include <cmath>
+
+JsonlWriter::JsonlWriter(ostream& target, size_t capacity) : BufferedWriter(target, capacity), rowStart(true) {}
+
+void JsonlWriter::key(string_view name) {
+    append(rowStart ? "{\"" : ",\"", 2);
+    rowStart = false;
+    append(name.data(), name.size());
+    append("\":", 2);
+}
+
+void JsonlWriter::appendString(string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+    append("\"", 1);
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        append(text.data() + start, i - start);
+        start = i + 1;
+        switch (c) {
+            case '"': append("\\\"", 2); break;
+            case '\\': append("\\\\", 2); break;
+            case '\n': append("\\n", 2); break;
+            case '\r': append("\\r", 2); break;
+            case '\t': append("\\t", 2); break;
+            default: {
+                char escape[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+                append(escape, sizeof(escape));
+            }
+        }
+    }
+    append(text.data() + start, text.size() - start);
+    append("\"", 1);
+}
+
+void JsonlWriter::field(string_view name, string_view text) {
+    key(name);
+    appendString(text);
+}
+
+void JsonlWriter::field(string_view name, int value) {
+    field(name, static_cast<long long>(value));
+}
+
+void JsonlWriter::field(string_view name, long long value) {
+    key(name);
+    char text[24];
+    char* end = to_chars(text, text + sizeof(text), value).ptr;
+    append(text, end - text);
+}
+
+void JsonlWriter::field(string_view name, float value) {
+    key(name);
+    // JSON has no spelling for NaN or infinity
+    if (!isfinite(value)) {
+        append("null", 4);
+        return;
+    }
+    char text[32];
+    char* end = formatFloat(text, text + sizeof(text), value);
+    append(text, end - text);
+}
+
+void JsonlWriter::null(string_view name) {
+    key(name);
+    append("null", 4);
+}
@@ -0,0 +1,39 @@
+#ifndef JSONL_H
+#define JSONL_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "csv.h"
+
+using namespace std;
+
+// JSON Lines: one flat object per line, written through BufferedWriter
+// like CsvWriter. Numbers go through to_chars and floats use formatFloat.
+// Strings are escaped per RFC 8259; bytes from 0x80 up are passed through,
+// so UTF-8 stays as is.
+class JsonlWriter : public BufferedWriter {
+private:
+    bool rowStart;
+
+    // Separator, then the quoted key and its colon
+    void key(string_view name);
+    void appendString(string_view text);
+
+public:
+    explicit JsonlWriter(ostream& target, size_t capacity = CSV_WRITE_BUFFER);
+
+    // Keys are written as given and must not need escaping
+    void field(string_view name, string_view text);
+    void field(string_view name, int value);
+    void field(string_view name, long long value);
+    void field(string_view name, float value);
+    void null(string_view name);
+
+    void endRow() {
+        append(rowStart ? "{}\n" : "}\n", rowStart ? 3 : 2);
+        rowStart = true;
+    }
+};
+
+#endif
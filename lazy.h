@@ -0,0 +1,32 @@
+#ifndef LAZY_H
+#define LAZY_H
+
+#include <functional>
+#include <optional>
+
+using namespace std;
+
+// A value produced by `load` the first time it is asked for and kept from
+// then on, so later uses share the one copy. Not thread-safe. Neither
+// copyable nor movable: loaders may hold references into other Lazy values.
+template <typename T>
+class Lazy {
+private:
+    function<T()> load;
+    optional<T> value;
+
+public:
+    explicit Lazy(function<T()> loader) : load(move(loader)) {}
+
+    Lazy(const Lazy&) = delete;
+    Lazy& operator=(const Lazy&) = delete;
+
+    T& get() {
+        if (!value) value.emplace(load());
+        return *value;
+    }
+
+    bool loaded() const { return value.has_value(); }
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+using namespace std;
+
+// Least-recently-used cache of shared values under a byte budget. Keys are
+// spread over shards, each with its own lock, list and budget share, so
+// threads only contend when they touch the same shard. Values are handed
+// out as shared_ptr: an entry evicted while in use stays alive for its
+// holders.
+template <typename K, typename V, typename Hash = hash<K>>
+class ShardedLruCache {
+private:
+    struct Entry {
+        K key;
+        shared_ptr<V> value;
+        size_t charge;
+    };
+
+    struct Shard {
+        mutex lock;
+        list<Entry> entries;  // most recently used first
+        unordered_map<K, typename list<Entry>::iterator, Hash> byKey;
+        size_t bytes = 0;
+    };
+
+    unique_ptr<Shard[]> shards;
+    size_t shardCount;
+    atomic<size_t> shardBudget;
+    atomic<uint64_t> hitCount;
+    atomic<uint64_t> missCount;
+
+    Shard& shardFor(const K& key) { return shards[Hash()(key) % shardCount]; }
+
+    // With the shard locked
+    static void evict(Shard& shard, size_t budget) {
+        while (shard.bytes > budget && !shard.entries.empty()) {
+            shard.bytes -= shard.entries.back().charge;
+            shard.byKey.erase(shard.entries.back().key);
+            shard.entries.pop_back();
+        }
+    }
+
+public:
+    explicit ShardedLruCache(size_t budgetBytes, size_t shardTotal = 16)
+        : shards(new Shard[shardTotal > 0 ? shardTotal : 1]),
+          shardCount(shardTotal > 0 ? shardTotal : 1),
+          shardBudget(budgetBytes / shardCount),
+          hitCount(0),
+          missCount(0) {}
+
+    ShardedLruCache(const ShardedLruCache&) = delete;
+    ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+    // The value for `key`, now the most recently used; null on a miss
+    shared_ptr<V> find(const K& key) {
+        Shard& shard = shardFor(key);
+        lock_guard<mutex> guard(shard.lock);
+        auto found = shard.byKey.find(key);
+        if (found == shard.byKey.end()) {
+            missCount.fetch_add(1, memory_order_relaxed);
+            return nullptr;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+        hitCount.fetch_add(1, memory_order_relaxed);
+        return found->second->value;
+    }
+
+    // The value for `key` if resident, without counting a lookup or
+    // changing its recency
+    shared_ptr<V> peek(const K& key) {
+        Shard& shard = shardFor(key);
+        lock_guard<mutex> guard(shard.lock);
+        auto found = shard.byKey.find(key);
+        return found == shard.byKey.end() ? nullptr : found->second->value;
+    }
+
+    // Add or replace the value for `key`, costing `charge` bytes of the
+    // budget, and evict the coldest entries of its shard to make room
+    void insert(const K& key, shared_ptr<V> value, size_t charge) {
+        Shard& shard = shardFor(key);
+        lock_guard<mutex> guard(shard.lock);
+        auto found = shard.byKey.find(key);
+        if (found != shard.byKey.end()) {
+            shard.bytes -= found->second->charge;
+            shard.entries.erase(found->second);
+            shard.byKey.erase(found);
+        }
+        // A value larger than the whole shard is not kept at all
+        size_t budget = shardBudget.load(memory_order_relaxed);
+        if (charge > budget) return;
+        shard.entries.push_front(Entry{key, move(value), charge});
+        shard.byKey[key] = shard.entries.begin();
+        shard.bytes += charge;
+        evict(shard, budget);
+    }
+
+    void erase(const K& key) {
+        Shard& shard = shardFor(key);
+        lock_guard<mutex> guard(shard.lock);
+        auto found = shard.byKey.find(key);
+        if (found == shard.byKey.end()) return;
+        shard.bytes -= found->second->charge;
+        shard.entries.erase(found->second);
+        shard.byKey.erase(found);
+    }
+
+    void clear() {
+        for (size_t i = 0; i < shardCount; ++i) {
+            lock_guard<mutex> guard(shards[i].lock);
+            shards[i].entries.clear();
+            shards[i].byKey.clear();
+            shards[i].bytes = 0;
+        }
+    }
+
+    // Change the budget, evicting at once if it shrank
+    void setBudget(size_t budgetBytes) {
+        size_t budget = budgetBytes / shardCount;
+        shardBudget.store(budget, memory_order_relaxed);
+        for (size_t i = 0; i < shardCount; ++i) {
+            lock_guard<mutex> guard(shards[i].lock);
+            evict(shards[i], budget);
+        }
+    }
+
+    size_t size() {
+        size_t total = 0;
+        for (size_t i = 0; i < shardCount; ++i) {
+            lock_guard<mutex> guard(shards[i].lock);
+            total += shards[i].entries.size();
+        }
+        return total;
+    }
+
+    size_t bytes() {
+        size_t total = 0;
+        for (size_t i = 0; i < shardCount; ++i) {
+            lock_guard<mutex> guard(shards[i].lock);
+            total += shards[i].bytes;
+        }
+        return total;
+    }
+
+    uint64_t hits() const { return hitCount.load(memory_order_relaxed); }
+    uint64_t misses() const { return missCount.load(memory_order_relaxed); }
+};
+
+#endif
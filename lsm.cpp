@@ -0,0 +1,755 @@
+#include "lsm.h"
+
+#include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+#include <iterator>
+
+// Entries in the log and in run blocks: key (u64), tombstone flag (u8),
+// value length (u32), value bytes. Native byte order, like BinaryFormat.
+const size_t ENTRY_HEADER = sizeof(uint64_t) + 1 + sizeof(uint32_t);
+// Bookkeeping charged per memtable entry on top of its value
+const size_t MEMTABLE_ENTRY_OVERHEAD = 64;
+const uint64_t RUN_MAGIC = 0x314e5552534d4c57ULL;
+const size_t RUN_FOOTER = 6 * sizeof(uint64_t) + sizeof(uint32_t);
+const size_t BLOCK_HANDLE = 2 * sizeof(uint64_t) + sizeof(uint32_t);
+
+template <typename V>
+static void appendRaw(string& out, V value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename V>
+static V readRaw(const char* data) {
+    V value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static void appendEntry(string& out, uint64_t key, string_view value, bool tombstone) {
+    appendRaw(out, key);
+    out.push_back(tombstone ? 1 : 0);
+    appendRaw(out, static_cast<uint32_t>(value.size()));
+    out.append(value.data(), value.size());
+}
+
+// The entry at `position`, which is moved past it. False if it is cut short.
+static bool parseEntry(string_view data, size_t& position, uint64_t& key, bool& tombstone, string_view& value) {
+    if (data.size() - position < ENTRY_HEADER) return false;
+    key = readRaw<uint64_t>(data.data() + position);
+    tombstone = data[position + sizeof(uint64_t)] != 0;
+    uint32_t length = readRaw<uint32_t>(data.data() + position + sizeof(uint64_t) + 1);
+    if (data.size() - position - ENTRY_HEADER < length) return false;
+    value = data.substr(position + ENTRY_HEADER, length);
+    position += ENTRY_HEADER + length;
+    return true;
+}
+
+// ========== Bloom filters ==========
+// Double hashing over one 64-bit mix of the key (Kirsch-Mitzenmacher)
+static uint64_t mixKey(uint64_t key) {
+    key += 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+static void bloomAdd(vector<uint64_t>& words, uint32_t hashes, uint64_t key) {
+    uint64_t bits = words.size() * 64;
+    uint64_t hash = mixKey(key);
+    uint64_t delta = (hash >> 33) | (hash << 31);
+    for (uint32_t i = 0; i < hashes; ++i, hash += delta) {
+        uint64_t bit = hash % bits;
+        words[bit / 64] |= 1ULL << (bit % 64);
+    }
+}
+
+static bool bloomTest(const vector<uint64_t>& words, uint32_t hashes, uint64_t key) {
+    uint64_t bits = words.size() * 64;
+    uint64_t hash = mixKey(key);
+    uint64_t delta = (hash >> 33) | (hash << 31);
+    for (uint32_t i = 0; i < hashes; ++i, hash += delta) {
+        uint64_t bit = hash % bits;
+        if ((words[bit / 64] & (1ULL << (bit % 64))) == 0) return false;
+    }
+    return true;
+}
+
+// ========== Runs ==========
+// A run file is its data blocks, then the block index (first key, offset,
+// size per block), then the bloom filter words, then a fixed footer.
+struct BlockHandle {
+    uint64_t firstKey;
+    uint64_t offset;
+    uint32_t size;
+};
+
+class RunBuilder {
+private:
+    ofstream out;
+    size_t blockBytes;
+    string block;
+    uint64_t blockFirstKey;
+    uint64_t offset;
+    vector<BlockHandle> index;
+    vector<uint64_t> bloom;
+    uint32_t hashes;
+    uint64_t entries;
+
+    void finishBlock() {
+        if (block.empty()) return;
+        out.write(block.data(), block.size());
+        index.push_back({blockFirstKey, offset, static_cast<uint32_t>(block.size())});
+        offset += block.size();
+        block.clear();
+    }
+
+public:
+    RunBuilder(const string& path, size_t expectedEntries, const LsmOptions& options)
+        : out(path, ios::binary | ios::trunc), blockBytes(options.blockBytes), blockFirstKey(0), offset(0), entries(0) {
+        size_t bits = max<size_t>(64, expectedEntries * options.bloomBitsPerKey);
+        bloom.assign((bits + 63) / 64, 0);
+        // k = bits per key * ln 2 minimizes the false positive rate
+        hashes = static_cast<uint32_t>(max<size_t>(1, min<size_t>(30, options.bloomBitsPerKey * 69 / 100)));
+        block.reserve(blockBytes + 256);
+    }
+
+    uint64_t size() const { return entries; }
+
+    void add(uint64_t key, string_view value, bool tombstone) {
+        if (block.empty()) blockFirstKey = key;
+        appendEntry(block, key, value, tombstone);
+        bloomAdd(bloom, hashes, key);
+        ++entries;
+        if (block.size() >= blockBytes) finishBlock();
+    }
+
+    bool finish(uint64_t& bytesWritten) {
+        finishBlock();
+        string tail;
+        uint64_t indexOffset = offset;
+        for (const auto& handle : index) {
+            appendRaw(tail, handle.firstKey);
+            appendRaw(tail, handle.offset);
+            appendRaw(tail, handle.size);
+        }
+        uint64_t bloomOffset = indexOffset + tail.size();
+        tail.append(reinterpret_cast<const char*>(bloom.data()), bloom.size() * sizeof(uint64_t));
+
+        appendRaw(tail, indexOffset);
+        appendRaw(tail, static_cast<uint64_t>(index.size()));
+        appendRaw(tail, bloomOffset);
+        appendRaw(tail, static_cast<uint64_t>(bloom.size()));
+        appendRaw(tail, hashes);
+        appendRaw(tail, entries);
+        appendRaw(tail, RUN_MAGIC);
+        out.write(tail.data(), tail.size());
+        out.close();
+        bytesWritten = offset + tail.size();
+        return !out.fail();
+    }
+};
+
+class SortedRun {
+private:
+    mutable ifstream file;
+    mutable mutex fileLock;
+
+public:
+    uint64_t number;
+    string path;
+    vector<BlockHandle> index;
+    vector<uint64_t> bloom;
+    uint32_t hashes;
+    uint64_t entries;
+    uint64_t bytes;
+    atomic<bool> obsolete;  // merged away: delete the file once the last reader lets go
+
+    SortedRun(const string& filename, uint64_t runNumber)
+        : file(filename, ios::binary), number(runNumber), path(filename), hashes(0), entries(0), bytes(0), obsolete(false) {}
+
+    ~SortedRun() {
+        file.close();
+        if (obsolete) {
+            error_code ignored;
+            filesystem::remove(path, ignored);
+        }
+    }
+
+    static shared_ptr<SortedRun> open(const string& path, uint64_t number) {
+        auto run = make_shared<SortedRun>(path, number);
+        ifstream& in = run->file;
+        if (!in.is_open()) return nullptr;
+
+        in.seekg(0, ios::end);
+        uint64_t size = static_cast<uint64_t>(in.tellg());
+        if (size < RUN_FOOTER) return nullptr;
+        string footer(RUN_FOOTER, '\0');
+        in.seekg(size - RUN_FOOTER);
+        if (!in.read(&footer[0], RUN_FOOTER)) return nullptr;
+
+        const char* p = footer.data();
+        uint64_t indexOffset = readRaw<uint64_t>(p);
+        uint64_t indexCount = readRaw<uint64_t>(p + 8);
+        uint64_t bloomOffset = readRaw<uint64_t>(p + 16);
+        uint64_t bloomWords = readRaw<uint64_t>(p + 24);
+        run->hashes = readRaw<uint32_t>(p + 32);
+        run->entries = readRaw<uint64_t>(p + 36);
+        if (readRaw<uint64_t>(p + 44) != RUN_MAGIC) return nullptr;
+        if (bloomWords == 0 || indexOffset + indexCount * BLOCK_HANDLE != bloomOffset ||
+            bloomOffset + bloomWords * sizeof(uint64_t) + RUN_FOOTER != size) {
+            return nullptr;
+        }
+
+        string table(indexCount * BLOCK_HANDLE, '\0');
+        in.seekg(indexOffset);
+        if (!in.read(&table[0], table.size())) return nullptr;
+        run->index.resize(indexCount);
+        for (uint64_t i = 0; i < indexCount; ++i) {
+            const char* handle = table.data() + i * BLOCK_HANDLE;
+            run->index[i] = {readRaw<uint64_t>(handle), readRaw<uint64_t>(handle + 8), readRaw<uint32_t>(handle + 16)};
+        }
+        run->bloom.resize(bloomWords);
+        if (!in.read(reinterpret_cast<char*>(run->bloom.data()), bloomWords * sizeof(uint64_t))) return nullptr;
+        run->bytes = size;
+        return run;
+    }
+
+    bool mayContain(uint64_t key) const {
+        return bloomTest(bloom, hashes, key);
+    }
+
+    // Last block whose first key is <= key, or index.size() if there is none
+    size_t blockFor(uint64_t key) const {
+        auto after = upper_bound(index.begin(), index.end(), key,
+                                 [](uint64_t k, const BlockHandle& handle) { return k < handle.firstKey; });
+        if (after == index.begin()) return index.size();
+        return (after - index.begin()) - 1;
+    }
+
+    bool readBlock(size_t i, string& out) const {
+        lock_guard<mutex> guard(fileLock);
+        out.resize(index[i].size);
+        file.clear();
+        file.seekg(index[i].offset);
+        return static_cast<bool>(file.read(&out[0], out.size()));
+    }
+};
+
+// ========== Cursors ==========
+// Forward iteration over one source; a merge reads several side by side
+class Cursor {
+public:
+    virtual ~Cursor() {}
+    virtual bool valid() const = 0;
+    virtual uint64_t key() const = 0;
+    virtual string_view value() const = 0;
+    virtual bool tombstone() const = 0;
+    virtual void next() = 0;
+};
+
+// Entries copied out of the memtable, so the lock need not be held
+class VectorCursor : public Cursor {
+private:
+    struct Entry {
+        uint64_t key;
+        string value;
+        bool tombstone;
+    };
+    vector<Entry> entries;
+    size_t position;
+
+public:
+    VectorCursor() : position(0) {}
+
+    void add(uint64_t key, const string& value, bool tombstone) { entries.push_back({key, value, tombstone}); }
+
+    bool valid() const override { return position < entries.size(); }
+    uint64_t key() const override { return entries[position].key; }
+    string_view value() const override { return entries[position].value; }
+    bool tombstone() const override { return entries[position].tombstone; }
+    void next() override { ++position; }
+};
+
+class RunCursor : public Cursor {
+private:
+    shared_ptr<SortedRun> run;
+    size_t blockIndex;
+    string block;
+    size_t position;
+    bool current;
+    uint64_t currentKey;
+    string_view currentValue;
+    bool currentTombstone;
+
+    void loadBlock(size_t i) {
+        blockIndex = i;
+        position = 0;
+        block.clear();
+        if (i >= run->index.size() || !run->readBlock(i, block)) {
+            current = false;
+            return;
+        }
+        next();
+    }
+
+public:
+    explicit RunCursor(shared_ptr<SortedRun> source)
+        : run(move(source)), blockIndex(0), position(0), current(false), currentKey(0), currentTombstone(false) {}
+
+    // Position on the first entry with key >= from
+    void seek(uint64_t from) {
+        size_t i = run->blockFor(from);
+        loadBlock(i == run->index.size() ? 0 : i);
+        while (current && currentKey < from) next();
+    }
+
+    bool valid() const override { return current; }
+    uint64_t key() const override { return currentKey; }
+    string_view value() const override { return currentValue; }
+    bool tombstone() const override { return currentTombstone; }
+
+    void next() override {
+        if (position < block.size()) {
+            current = parseEntry(block, position, currentKey, currentTombstone, currentValue);
+            return;
+        }
+        loadBlock(blockIndex + 1);
+    }
+};
+
+// The newest version of each key below `to`, in key order. Cursors come
+// newest source first, so on equal keys the lowest index wins.
+static void mergeCursors(vector<unique_ptr<Cursor>>& cursors, uint64_t to,
+                         const function<bool(uint64_t, string_view, bool)>& visit) {
+    for (;;) {
+        Cursor* best = nullptr;
+        for (auto& cursor : cursors) {
+            if (cursor->valid() && cursor->key() < to && (best == nullptr || cursor->key() < best->key())) {
+                best = cursor.get();
+            }
+        }
+        if (best == nullptr) return;
+
+        uint64_t key = best->key();
+        bool more = visit(key, best->value(), best->tombstone());
+        for (auto& cursor : cursors) {
+            if (cursor->valid() && cursor->key() == key) cursor->next();
+        }
+        if (!more) return;
+    }
+}
+
+// ========== Store ==========
+LsmStore::LsmStore()
+    : memtableBytes(0), nextRunNumber(1), walSize(0), counters(), opened(false), stopping(false), compacting(false) {}
+
+LsmStore::~LsmStore() {
+    close();
+}
+
+string LsmStore::runPath(uint64_t number) const {
+    char name[32];
+    snprintf(name, sizeof(name), "run-%06llu.sst", static_cast<unsigned long long>(number));
+    return directory + "/" + name;
+}
+
+bool LsmStore::open(const string& path, const LsmOptions& settings) {
+    close();
+    lock_guard<mutex> guard(lock);
+    directory = path;
+    options = settings;
+    counters = LsmStats();
+    nextRunNumber = 1;
+
+    error_code error;
+    filesystem::create_directories(directory, error);
+    if (error) return false;
+
+    // MANIFEST: "nextRun <n>", then the live run numbers, newest first
+    vector<uint64_t> live;
+    ifstream manifest(directory + "/MANIFEST");
+    string word;
+    if (manifest >> word >> nextRunNumber) {
+        uint64_t number;
+        while (manifest >> number) live.push_back(number);
+    }
+    for (uint64_t number : live) {
+        auto run = SortedRun::open(runPath(number), number);
+        if (!run) {
+            resetLocked();
+            return false;
+        }
+        runs.push_back(run);
+    }
+
+    // Runs left behind by a merge or flush that never reached the manifest
+    for (const auto& entry : filesystem::directory_iterator(directory, error)) {
+        string name = entry.path().filename().string();
+        unsigned long long number;
+        if (sscanf(name.c_str(), "run-%llu.sst", &number) != 1) continue;
+        if (find(live.begin(), live.end(), number) == live.end()) filesystem::remove(entry.path(), error);
+    }
+
+    // Replay what was written after the last flush; a torn final entry is dropped
+    string walPath = directory + "/wal.log";
+    ifstream log(walPath, ios::binary);
+    string pending((istreambuf_iterator<char>(log)), istreambuf_iterator<char>());
+    size_t position = 0;
+    uint64_t key;
+    bool tombstone;
+    string_view value;
+    while (parseEntry(pending, position, key, tombstone, value)) {
+        MemEntry& entry = memtable[key];
+        entry.value.assign(value.data(), value.size());
+        entry.tombstone = tombstone;
+    }
+    for (const auto& entry : memtable) memtableBytes += entry.second.value.size() + MEMTABLE_ENTRY_OVERHEAD;
+
+    // Entries appended after a torn one would never be replayed, so a torn
+    // log has to go. What it held is flushed into a run first, and
+    // flushLocked() only truncates the log once the manifest names the run;
+    // if that fails the log is left as it was for the next attempt.
+    bool torn = position != pending.size();
+    if ((torn || memtableBytes >= options.memtableBytes) && !flushLocked()) {
+        resetLocked();
+        return false;
+    }
+    if (!wal.is_open()) {
+        wal.open(walPath, ios::binary | (torn ? ios::trunc : ios::app));
+        walSize = torn ? 0 : pending.size();
+    }
+    if (!wal.is_open()) {
+        resetLocked();
+        return false;
+    }
+    opened = true;
+    stopping = false;
+    compactor = thread(&LsmStore::compactionLoop, this);
+    return true;
+}
+
+void LsmStore::close() {
+    {
+        lock_guard<mutex> guard(lock);
+        if (!opened) return;
+        stopping = true;
+    }
+    compactionWanted.notify_all();
+    if (compactor.joinable()) compactor.join();
+
+    lock_guard<mutex> guard(lock);
+    resetLocked();
+}
+
+void LsmStore::resetLocked() {
+    wal.close();
+    walBuffer.clear();
+    walSize = 0;
+    memtable.clear();
+    memtableBytes = 0;
+    runs.clear();
+    opened = false;
+}
+
+void LsmStore::applyEntry(uint64_t key, string_view value, bool tombstone) {
+    counters.userBytes += sizeof(key) + value.size();
+
+    auto inserted = memtable.try_emplace(key);
+    MemEntry& entry = inserted.first->second;
+    if (inserted.second) memtableBytes += MEMTABLE_ENTRY_OVERHEAD;
+    else memtableBytes -= entry.value.size();
+    memtableBytes += value.size();
+    entry.value.assign(value.data(), value.size());
+    entry.tombstone = tombstone;
+}
+
+// Hand the buffered log entries to the OS. Callers apply them to the
+// memtable only if this succeeds. A failed write closes the log, and the
+// next commit cuts off what it left before appending, so a partial entry
+// never hides the ones after it.
+bool LsmStore::commitWal() {
+    string walPath = directory + "/wal.log";
+    if (!wal.is_open()) {
+        error_code error;
+        if (filesystem::exists(walPath, error)) filesystem::resize_file(walPath, walSize, error);
+        if (!error) wal.open(walPath, ios::binary | ios::app);
+    }
+    size_t bytes = walBuffer.size();
+    if (wal.is_open()) {
+        wal.write(walBuffer.data(), bytes);
+        wal.flush();
+    }
+    walBuffer.clear();
+    if (!wal.is_open() || !wal) {
+        wal.close();
+        wal.clear();
+        return false;
+    }
+    walSize += bytes;
+    counters.walBytes += bytes;
+    return true;
+}
+
+bool LsmStore::flushIfFull() {
+    return memtableBytes < options.memtableBytes || flushLocked();
+}
+
+bool LsmStore::put(uint64_t key, string_view value) {
+    lock_guard<mutex> guard(lock);
+    if (!opened) return false;
+    appendEntry(walBuffer, key, value, false);
+    if (!commitWal()) return false;
+    applyEntry(key, value, false);
+    return flushIfFull();
+}
+
+bool LsmStore::putAll(const vector<pair<uint64_t, string>>& entries) {
+    lock_guard<mutex> guard(lock);
+    if (!opened) return false;
+    for (const auto& entry : entries) appendEntry(walBuffer, entry.first, entry.second, false);
+    if (!commitWal()) return false;
+    for (const auto& entry : entries) applyEntry(entry.first, entry.second, false);
+    return flushIfFull();
+}
+
+bool LsmStore::remove(uint64_t key) {
+    lock_guard<mutex> guard(lock);
+    if (!opened) return false;
+    appendEntry(walBuffer, key, string_view(), true);
+    if (!commitWal()) return false;
+    applyEntry(key, string_view(), true);
+    return flushIfFull();
+}
+
+bool LsmStore::get(uint64_t key, string& value) const {
+    vector<shared_ptr<SortedRun>> snapshot;
+    {
+        lock_guard<mutex> guard(lock);
+        auto found = memtable.find(key);
+        if (found != memtable.end()) {
+            if (found->second.tombstone) return false;
+            value = found->second.value;
+            return true;
+        }
+        snapshot = runs;
+    }
+
+    string block;
+    for (const auto& run : snapshot) {
+        if (!run->mayContain(key)) continue;
+        size_t i = run->blockFor(key);
+        if (i == run->index.size() || !run->readBlock(i, block)) continue;
+
+        size_t position = 0;
+        uint64_t entryKey;
+        bool tombstone;
+        string_view entryValue;
+        while (parseEntry(block, position, entryKey, tombstone, entryValue) && entryKey <= key) {
+            if (entryKey < key) continue;
+            if (tombstone) return false;
+            value.assign(entryValue.data(), entryValue.size());
+            return true;
+        }
+    }
+    return false;
+}
+
+void LsmStore::scan(uint64_t from, uint64_t to, const function<bool(uint64_t, string_view)>& visit) const {
+    vector<unique_ptr<Cursor>> cursors;
+    {
+        lock_guard<mutex> guard(lock);
+        auto memory = make_unique<VectorCursor>();
+        for (auto it = memtable.lower_bound(from); it != memtable.end() && it->first < to; ++it) {
+            memory->add(it->first, it->second.value, it->second.tombstone);
+        }
+        cursors.push_back(move(memory));
+        for (const auto& run : runs) cursors.push_back(make_unique<RunCursor>(run));
+    }
+    for (size_t i = 1; i < cursors.size(); ++i) static_cast<RunCursor*>(cursors[i].get())->seek(from);
+
+    mergeCursors(cursors, to, [&visit](uint64_t key, string_view value, bool tombstone) {
+        return tombstone || visit(key, value);
+    });
+}
+
+bool LsmStore::flushLocked() {
+    if (memtable.empty()) return true;
+
+    uint64_t number = nextRunNumber++;
+    RunBuilder builder(runPath(number), memtable.size(), options);
+    for (const auto& entry : memtable) builder.add(entry.first, entry.second.value, entry.second.tombstone);
+    uint64_t bytes;
+    if (!builder.finish(bytes)) return false;
+
+    auto run = SortedRun::open(runPath(number), number);
+    if (!run) return false;
+    runs.insert(runs.begin(), run);
+    if (!writeManifest()) {
+        runs.erase(runs.begin());
+        run->obsolete = true;
+        return false;
+    }
+    counters.flushBytes += bytes;
+
+    // The run holds everything the log did
+    memtable.clear();
+    memtableBytes = 0;
+    wal.close();
+    wal.open(directory + "/wal.log", ios::binary | ios::trunc);
+    walSize = 0;
+    compactionWanted.notify_one();
+    return wal.is_open();
+}
+
+bool LsmStore::flush() {
+    lock_guard<mutex> guard(lock);
+    return opened && flushLocked();
+}
+
+bool LsmStore::writeManifest() {
+    string path = directory + "/MANIFEST";
+    {
+        ofstream out(path + ".tmp", ios::trunc);
+        out << "nextRun " << nextRunNumber << "\n";
+        for (const auto& run : runs) out << run->number << "\n";
+        out.close();
+        if (out.fail()) return false;
+    }
+    error_code error;
+    filesystem::rename(path + ".tmp", path, error);
+    return !error;
+}
+
+// Size-tiered: the newest window of compactionTrigger adjacent runs whose
+// sizes are within 2x of each other. If runs pile up without such a window,
+// the newest ones are merged anyway to bound the cost of a lookup.
+bool LsmStore::pickCompaction(size_t& first, size_t& count) const {
+    size_t window = max<size_t>(2, options.compactionTrigger);
+    if (runs.size() < window) return false;
+    for (size_t i = 0; i + window <= runs.size(); ++i) {
+        uint64_t smallest = runs[i]->bytes;
+        uint64_t largest = runs[i]->bytes;
+        for (size_t j = i; j < i + window; ++j) {
+            smallest = min(smallest, runs[j]->bytes);
+            largest = max(largest, runs[j]->bytes);
+        }
+        if (largest <= 2 * smallest) {
+            first = i;
+            count = window;
+            return true;
+        }
+    }
+    if (runs.size() >= 3 * window) {
+        first = 0;
+        count = window;
+        return true;
+    }
+    return false;
+}
+
+// Merge runs[first, first + count) into one. Drops the lock while merging;
+// flushes may add newer runs in front meanwhile.
+void LsmStore::compactRuns(unique_lock<mutex>& guard, size_t first, size_t count) {
+    vector<shared_ptr<SortedRun>> inputs(runs.begin() + first, runs.begin() + first + count);
+    bool includesOldest = first + count == runs.size();
+    uint64_t number = nextRunNumber++;
+    compacting = true;
+    guard.unlock();
+
+    uint64_t expected = 0;
+    vector<unique_ptr<Cursor>> cursors;
+    for (const auto& run : inputs) {
+        expected += run->entries;
+        auto cursor = make_unique<RunCursor>(run);
+        cursor->seek(0);
+        cursors.push_back(move(cursor));
+    }
+    RunBuilder builder(runPath(number), expected, options);
+    mergeCursors(cursors, UINT64_MAX, [&](uint64_t key, string_view value, bool tombstone) {
+        // Nothing older can be shadowed once the oldest run is part of the merge
+        if (!(tombstone && includesOldest)) builder.add(key, value, tombstone);
+        return true;
+    });
+    uint64_t bytes = 0;
+    bool built = builder.finish(bytes);
+    shared_ptr<SortedRun> output;
+    if (built && builder.size() > 0) output = SortedRun::open(runPath(number), number);
+
+    guard.lock();
+    if (built && (output || builder.size() == 0)) {
+        size_t at = find(runs.begin(), runs.end(), inputs.front()) - runs.begin();
+        runs.erase(runs.begin() + at, runs.begin() + at + count);
+        if (output) runs.insert(runs.begin() + at, output);
+        if (writeManifest()) {
+            for (auto& run : inputs) run->obsolete = true;
+            counters.compactionBytes += bytes;
+            ++counters.compactions;
+        } else {
+            // Put the inputs back; the unused output is deleted with its last reference
+            if (output) {
+                runs.erase(runs.begin() + at);
+                output->obsolete = true;
+            }
+            runs.insert(runs.begin() + at, inputs.begin(), inputs.end());
+        }
+    }
+    if (!output) {
+        error_code ignored;
+        filesystem::remove(runPath(number), ignored);
+    }
+    compacting = false;
+    compactionIdle.notify_all();
+}
+
+void LsmStore::compactionLoop() {
+    unique_lock<mutex> guard(lock);
+    while (!stopping) {
+        size_t first, count;
+        if (!compacting && pickCompaction(first, count)) {
+            size_t before = counters.compactions;
+            compactRuns(guard, first, count);
+            if (counters.compactions != before) continue;
+        }
+        compactionWanted.wait(guard);
+    }
+}
+
+void LsmStore::compact() {
+    unique_lock<mutex> guard(lock);
+    if (!opened) return;
+    compactionIdle.wait(guard, [this]() { return !compacting; });
+    flushLocked();
+    if (runs.size() > 1) compactRuns(guard, 0, runs.size());
+}
+
+bool LsmStore::clear() {
+    unique_lock<mutex> guard(lock);
+    if (!opened) return false;
+    compactionIdle.wait(guard, [this]() { return !compacting; });
+
+    vector<shared_ptr<SortedRun>> dropped;
+    dropped.swap(runs);
+    if (!writeManifest()) {
+        runs.swap(dropped);
+        return false;
+    }
+    for (auto& run : dropped) run->obsolete = true;
+    memtable.clear();
+    memtableBytes = 0;
+    walBuffer.clear();
+    wal.close();
+    wal.open(directory + "/wal.log", ios::binary | ios::trunc);
+    walSize = 0;
+    return wal.is_open();
+}
+
+LsmStats LsmStore::stats() const {
+    lock_guard<mutex> guard(lock);
+    LsmStats result = counters;
+    result.runs = runs.size();
+    result.memtableEntries = memtable.size();
+    return result;
+}
@@ -0,0 +1,136 @@
+#ifndef LSM_H
+#define LSM_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <fstream>
+#include <cstdint>
+
+using namespace std;
+
+struct LsmOptions {
+    size_t memtableBytes;      // flush the memtable into a run past this size
+    size_t blockBytes;         // target size of a data block in a run
+    size_t bloomBitsPerKey;
+    size_t compactionTrigger;  // merge this many runs of similar size into one
+
+    LsmOptions() : memtableBytes(4 << 20), blockBytes(4096), bloomBitsPerKey(10), compactionTrigger(4) {}
+};
+
+struct LsmStats {
+    uint64_t userBytes;        // keys and values handed to put and remove
+    uint64_t walBytes;         // written to the write-ahead log
+    uint64_t flushBytes;       // written by memtable flushes
+    uint64_t compactionBytes;  // written by compactions
+    size_t runs;
+    size_t compactions;
+    size_t memtableEntries;
+
+    // Bytes that reached the disk per byte written by the caller
+    double writeAmplification() const {
+        return userBytes > 0 ? static_cast<double>(walBytes + flushBytes + compactionBytes) / userBytes : 0;
+    }
+};
+
+class SortedRun;
+
+// Log-structured key-value store with 64-bit keys and byte-string values.
+//
+// Writes go to the write-ahead log and a sorted in-memory table. When the
+// memtable passes memtableBytes it is written out as an immutable sorted
+// run: data blocks, a sparse index of the first key in each block, and a
+// bloom filter over the keys. A lookup checks the memtable, then the runs
+// from newest to oldest, and the bloom filters let it skip the runs that
+// cannot hold the key, so a miss rarely touches the disk.
+//
+// A background thread merges runs of similar size (size-tiered
+// compaction), so a record is rewritten about log(N / memtable) times
+// over its life. Deleted and overwritten entries are dropped when the
+// oldest run takes part in a merge.
+//
+// The MANIFEST file lists the live runs. It is replaced atomically, so a
+// crash leaves either the old or the new set of runs, and the log replays
+// whatever had not been flushed yet.
+class LsmStore {
+private:
+    struct MemEntry {
+        string value;
+        bool tombstone;
+    };
+
+    string directory;
+    LsmOptions options;
+    map<uint64_t, MemEntry> memtable;
+    size_t memtableBytes;
+    vector<shared_ptr<SortedRun>> runs;  // newest first
+    uint64_t nextRunNumber;
+    ofstream wal;
+    string walBuffer;
+    uint64_t walSize;  // bytes of whole entries in the log
+    LsmStats counters;
+    bool opened;
+
+    mutable mutex lock;
+    condition_variable compactionWanted;
+    condition_variable compactionIdle;
+    thread compactor;
+    bool stopping;
+    bool compacting;
+
+    // With the lock held
+    void applyEntry(uint64_t key, string_view value, bool tombstone);
+    bool commitWal();
+    bool flushIfFull();
+    bool flushLocked();
+    bool writeManifest();
+    // Drop everything open() or the writes built up; the files stay
+    void resetLocked();
+    bool pickCompaction(size_t& first, size_t& count) const;
+    void compactRuns(unique_lock<mutex>& guard, size_t first, size_t count);
+
+    void compactionLoop();
+    string runPath(uint64_t number) const;
+
+public:
+    LsmStore();
+    ~LsmStore();
+
+    LsmStore(const LsmStore&) = delete;
+    LsmStore& operator=(const LsmStore&) = delete;
+
+    // Open or create the store in `path`, replaying its write-ahead log
+    bool open(const string& path, const LsmOptions& settings = LsmOptions());
+    void close();
+    bool isOpen() const { return opened; }
+
+    bool put(uint64_t key, string_view value);
+    // Several puts with one log write
+    bool putAll(const vector<pair<uint64_t, string>>& entries);
+    bool remove(uint64_t key);
+
+    bool get(uint64_t key, string& value) const;
+
+    // Live entries with from <= key < to, in key order, to visit(key, value)
+    // until it returns false
+    void scan(uint64_t from, uint64_t to, const function<bool(uint64_t, string_view)>& visit) const;
+
+    // Drop every entry
+    bool clear();
+
+    // Write the memtable out as a run
+    bool flush();
+
+    // Merge every run into one, waiting for a background merge to finish first
+    void compact();
+
+    LsmStats stats() const;
+};
+
+#endif
@@ -2,7 +2,10 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <sstream>
 #include <limits>
+#include <iomanip>
 #include <ctime>
 #include <cstdlib>
 #include "utils.h"
@@ -11,6 +14,21 @@
 #include "product.h"
 #include "order.h"
 #include "auth.h"
+#include "sales_analytics.h"
+#include "reports.h"
+#include "pager.h"
+#include "inventory_views.h"
+#include "catalog_import.h"
+#include "order_export.h"
+#include "product_index.h"
+#include "order_store.h"
+#include "warehouse_stock.h"
+#include "fulfillment.h"
+#include "event_log.h"
+#include "storage.h"
+#include "lazy.h"
+#include "metrics.h"
+#include "trace.h"
 
 using namespace std;
 
@@ -20,16 +38,160 @@ const string SUPPLIERS_FILE = "suppliers.csv";
 const string STAFF_FILE = "staff.csv";
 const string ORDERS_FILE = "orders.csv";
 const string ORDER_ITEMS_FILE = "order_items.csv";
+const string METRICS_FILE = "metrics.prom";
+const string DATABASE_FILE = "wms.db";
+const string LSM_DIRECTORY = "wms_lsm";
+const string WAREHOUSES_FILE = "warehouses.csv";
+const string STOCK_FILE = "stock.csv";
+const string ORDER_EVENTS_FILE = "order_events.csv";
+
+// B+-tree indexes over products.csv, rebuilt when the file changes
+ProductIndex productIndex(PRODUCTS_FILE);
+
+// IDs for warehouses, which have no class of their own
+IdSequence warehouseIDs;
+
+// Lease new IDs from sequence files kept with the records, so they carry
+// on where the last run (or another running copy) left off
+void bindIdSequences() {
+    Product::ids.bind(Storage::sequenceFile(PRODUCTS_FILE), [] { return Storage::highestKey<Product>(PRODUCTS_FILE); });
+    Supplier::ids.bind(Storage::sequenceFile(SUPPLIERS_FILE), [] { return Storage::highestKey<Supplier>(SUPPLIERS_FILE); });
+    Staff::ids.bind(Storage::sequenceFile(STAFF_FILE), [] { return Storage::highestKey<Staff>(STAFF_FILE); });
+    Order::ids.bind(Storage::sequenceFile(ORDERS_FILE), [] { return Storage::highestKey<Order>(ORDERS_FILE); });
+    warehouseIDs.bind(Storage::sequenceFile(WAREHOUSES_FILE), [] { return Storage::highestKey<Warehouse>(WAREHOUSES_FILE); });
+}
+
+// What the menus work on. Nothing is read at startup: each file is loaded
+// the first time a screen needs it and then shared by every later visit.
+struct Workspace {
+    Lazy<vector<Product>> inventory;
+    Lazy<vector<Supplier>> suppliers;
+    Lazy<vector<Order>> orders;
+    Lazy<vector<Staff>> staffList;
+    Lazy<InventoryViews> views;
+    Lazy<SalesAnalytics> analytics;
+    // Per-warehouse stock, matched to the inventory's quantities on load
+    Lazy<WarehouseStock> stock;
+    // Single orders by ID, without the whole history
+    OrderStore orderStore;
+    // Every stock change, new order and status change; only written when
+    // opened with --event-log
+    EventLog events;
+    // Status changes; declared last so its worker stops before the rest goes
+    FulfillmentPipeline fulfillment;
+
+    explicit Workspace(size_t orderCacheBytes)
+        : inventory([this]() {
+              vector<Product> loaded = Product::loadAllFromFile(PRODUCTS_FILE);
+              events.reconcileStock(loaded);
+              return loaded;
+          }),
+          suppliers([]() { return Supplier::loadAllFromFile(SUPPLIERS_FILE); }),
+          orders([]() { return Order::loadAllFromFile(ORDERS_FILE, ORDER_ITEMS_FILE); }),
+          staffList([]() { return Staff::loadAllFromFile(STAFF_FILE); }),
+          views([this]() { return InventoryViews(inventory.get()); }),
+          analytics([this]() {
+              SalesAnalytics sales;
+              sales.rebuildFromHistory(orders.get(), inventory.get());
+              return sales;
+          }),
+          stock([this]() {
+              WarehouseStock loaded;
+              size_t skipped = 0;
+              if (!loaded.load(WAREHOUSES_FILE, STOCK_FILE, skipped)) cerr << "Unable to write " << WAREHOUSES_FILE << "\n";
+              if (skipped > 0) cerr << "Ignored " << skipped << " stock levels for unknown warehouses in " << STOCK_FILE << "\n";
+              if (loaded.reconcile(inventory.get()) > 0) loaded.save(STOCK_FILE);
+              return loaded;
+          }),
+          orderStore(ORDERS_FILE, ORDER_ITEMS_FILE, orderCacheBytes) {}
+};
+
+// The fulfillment worker applies each batch of status changes to the files.
+// What the menus have loaded is not thread-safe, so it is patched by
+// deferred handlers on the main thread, when the menu calls flush().
+void startFulfillment(Workspace& data) {
+    // The status history and the event log, one append each, then each
+    // order's latest status
+    data.fulfillment.subscribe([&data](const vector<StatusEvent>& batch) {
+        if (!Storage::open<StatusEvent>(ORDER_EVENTS_FILE)->appendAll(batch)) {
+            cerr << "Unable to append to " << ORDER_EVENTS_FILE << "\n";
+        }
+        vector<LedgerEvent> logged;
+        for (const auto& event : batch) logged.push_back(EventLog::statusChanged(event.orderID, event.to));
+        if (!data.events.append(move(logged))) cerr << "Unable to write to the event log\n";
+        unordered_map<int, OrderStatus> latest;
+        for (const auto& event : batch) latest[event.orderID] = event.to;
+        vector<pair<int, OrderStatus>> changes(latest.begin(), latest.end());
+        if (!data.orderStore.setStatuses(changes)) cerr << "Unable to save every order in a batch of " << changes.size() << "\n";
+    });
+    
+    // The loaded history and the analytics built from it
+    data.fulfillment.subscribeDeferred([&data](const vector<StatusEvent>& batch) {
+        if (data.orders.loaded()) {
+            unordered_map<int, OrderStatus> latest;
+            for (const auto& event : batch) latest[event.orderID] = event.to;
+            for (auto& order : data.orders.get()) {
+                auto change = latest.find(order.getID());
+                if (change != latest.end()) order.setStatus(change->second);
+            }
+        }
+        if (data.analytics.loaded()) {
+            for (const auto& event : batch) {
+                shared_ptr<const Order> order = data.orderStore.find(event.orderID);
+                if (order) data.analytics.get().recordStatusChange(*order, event.from, event.to);
+            }
+        }
+    });
+    
+    // Cancelled orders go back on the shelf, at the warehouse each item was
+    // taken from, or the default one for items from before warehouses
+    data.fulfillment.subscribeDeferred([&data](const vector<StatusEvent>& batch) {
+        vector<shared_ptr<const Order>> cancelled;
+        for (const auto& event : batch) {
+            if (event.to != ORDER_CANCELLED) continue;
+            shared_ptr<const Order> order = data.orderStore.find(event.orderID);
+            if (order) cancelled.push_back(order);
+        }
+        if (cancelled.empty()) return;
+        
+        vector<Product>& inventory = data.inventory.get();
+        // Loaded before the quantities change, so its reconcile does not put
+        // the returned units at the default warehouse
+        WarehouseStock& stock = data.stock.get();
+        unordered_map<int, size_t> byID;
+        for (size_t i = 0; i < inventory.size(); ++i) byID[inventory[i].getID()] = i;
+        vector<LedgerEvent> restocked;
+        for (const auto& order : cancelled) {
+            for (const auto& item : order->getItems()) {
+                auto product = byID.find(item.productID);
+                if (product == byID.end()) continue;
+                inventory[product->second].addStock(item.quantity);
+                restocked.push_back(EventLog::stockChanged(item.productID, item.quantity, order->getID()));
+                if (!stock.receive(item.productID, item.warehouseID, item.quantity)) {
+                    stock.receive(item.productID, stock.defaultWarehouse(), item.quantity);
+                }
+            }
+        }
+        if (data.views.loaded()) data.views.get().invalidate(SORT_BY_QUANTITY);
+        Product::saveAllToFile(PRODUCTS_FILE, inventory);
+        stock.save(STOCK_FILE);
+        if (!data.events.append(move(restocked))) cerr << "Unable to write to the event log\n";
+    });
+    
+    data.fulfillment.start();
+}
 
 // Function prototypes
-void handleProductMenu(vector<Product>& inventory);
+void handleProductMenu(Workspace& data);
+void handleWarehouseMenu(Workspace& data);
 void handleSupplierMenu(vector<Supplier>& suppliers, const Staff& currentUser);
-void handleOrderMenu(vector<Order>& orders, vector<Product>& inventory);
+void handleOrderMenu(Workspace& data);
 void handleStaffMenu(vector<Staff>& staffList, const Staff& currentUser);
-void handleSupplierDashboard(Supplier& currentSupplier, vector<Product>& inventory);
+void handleSupplierDashboard(Supplier& currentSupplier, Workspace& data);
 
 // Product management functions
-void addProduct(vector<Product>& inventory) {
+void addProduct(vector<Product>& inventory, InventoryViews& views, EventLog& events) {
+    TRACE_SCOPE("addProduct");
     displayMenuHeader("ADD NEW PRODUCT");
     
     string name, category, description;
@@ -66,30 +228,45 @@ void addProduct(vector<Product>& inventory) {
     loadingScreen("Adding new product");
     
     inventory.push_back(newProduct);
-    newProduct.saveToFile(PRODUCTS_FILE);
+    views.onProductAdded(inventory.size() - 1);
+    if (newProduct.saveToFile(PRODUCTS_FILE) && quantity != 0 &&
+        !events.append({EventLog::stockChanged(newProduct.getID(), quantity)})) {
+        cerr << "Unable to write to the event log\n";
+    }
     
     showSuccess("Product added successfully!");
 }
 
-void viewProducts(const vector<Product>& inventory) {
-    displayMenuHeader("PRODUCT INVENTORY");
-    
+// Pager over the inventory with name/category filter and sort keys
+void browseProducts(const vector<Product>& inventory, InventoryViews& views, const string& title) {
+    TRACE_SCOPE("browseProducts");
+    Pager<Product> pager(inventory, title);
+    pager.setFilter([](const Product& p, const string& term) {
+        return toLowerCase(p.getName()).find(term) != string::npos ||
+               toLowerCase(p.getCategory()).find(term) != string::npos;
+    });
+    pager.addSortKey("ID", [](const Product& a, const Product& b) { return a.getID() < b.getID(); });
+    for (int k = 0; k < SORT_KEY_COUNT; ++k) {
+        SortKey key = static_cast<SortKey>(k);
+        pager.addCachedSortKey(InventoryViews::keyLabel(key), [&views, key]() -> const vector<size_t>& {
+            return views.ordering(key);
+        });
+    }
+    pager.run();
+}
+
+void viewProducts(const vector<Product>& inventory, InventoryViews& views) {
+    TRACE_SCOPE("viewProducts");
     if (inventory.empty()) {
         showWarning("No products available.");
         return;
     }
     
-    cout << CYAN << BOLD << "Total Products: " << RESET << inventory.size() << "\n\n";
-    
-    for (const auto& p : inventory) {
-        p.display();
-        cout << "\n";
-    }
-    
-    waitForAnyKey();
+    browseProducts(inventory, views, "PRODUCT INVENTORY");
 }
 
-void updateProduct(vector<Product>& inventory) {
+void updateProduct(vector<Product>& inventory, InventoryViews& views, EventLog& events) {
+    TRACE_SCOPE("updateProduct");
     displayMenuHeader("UPDATE PRODUCT");
     
     int updateID;
@@ -105,6 +282,7 @@ void updateProduct(vector<Product>& inventory) {
             string newName, newCategory, newDesc;
             float newPrice;
             int newQuantity;
+            int oldQuantity = p.getQuantity();
             
             displayMenuHeader("UPDATE PRODUCT #" + to_string(updateID));
             cout << CYAN << "Current Product Details:\n\n" << RESET;
@@ -141,16 +319,15 @@ void updateProduct(vector<Product>& inventory) {
             
             cout << CYAN << "└─────────────────────────────────────────┘\n";
             
+            views.onProductUpdated(&p - &inventory[0]);
             loadingScreen("Updating product");
             
             // Update file
-            ofstream file(PRODUCTS_FILE);
-            for (const auto& product : inventory) {
-                file << product.getID() << "," << product.getName() << "," 
-                     << product.getPrice() << "," << product.getQuantity() << ","
-                     << product.getCategory() << "," << product.getDescription() << "\n";
+            int change = p.getQuantity() - oldQuantity;
+            if (Product::saveAllToFile(PRODUCTS_FILE, inventory) && change != 0 &&
+                !events.append({EventLog::stockChanged(updateID, change)})) {
+                cerr << "Unable to write to the event log\n";
             }
-            file.close();
             
             showSuccess("Product updated successfully!");
             break;
@@ -162,7 +339,8 @@ void updateProduct(vector<Product>& inventory) {
     }
 }
 
-void deleteProduct(vector<Product>& inventory) {
+void deleteProduct(vector<Product>& inventory, InventoryViews& views, EventLog& events) {
+    TRACE_SCOPE("deleteProduct");
     displayMenuHeader("DELETE PRODUCT");
     
     int deleteID;
@@ -186,18 +364,18 @@ void deleteProduct(vector<Product>& inventory) {
             cin >> confirm;
             
             if (confirm == 'y' || confirm == 'Y') {
+                size_t index = it - inventory.begin();
+                int held = it->getQuantity();
                 inventory.erase(it);
+                views.onProductRemoved(index);
                 
                 loadingScreen("Deleting product");
                 
-                // Update file
-                ofstream file(PRODUCTS_FILE);
-                for (const auto& product : inventory) {
-                    file << product.getID() << "," << product.getName() << "," 
-                         << product.getPrice() << "," << product.getQuantity() << ","
-                         << product.getCategory() << "," << product.getDescription() << "\n";
+                // Update file; the product leaves with whatever it held
+                if (Product::saveAllToFile(PRODUCTS_FILE, inventory) && held != 0 &&
+                    !events.append({EventLog::stockChanged(deleteID, -held)})) {
+                    cerr << "Unable to write to the event log\n";
                 }
-                file.close();
                 
                 showSuccess("Product deleted successfully!");
             } else {
@@ -212,7 +390,30 @@ void deleteProduct(vector<Product>& inventory) {
     }
 }
 
-void searchProduct(const vector<Product>& inventory) {
+// Product lookups go through the on-disk indexes while the products live
+// in the CSV file, and through the storage backend otherwise; neither
+// loads the inventory
+bool findProductByID(int id, Product& result) {
+    if (Storage::current() == STORAGE_CSV) return productIndex.findByID(id, result);
+    return Storage::open<Product>(PRODUCTS_FILE)->findByKey(id, result);
+}
+
+// Names starting with the term, from the name index; a substring match
+// over the inventory when none do or the index is unavailable
+vector<Product> findProductsByName(Lazy<vector<Product>>& inventory, const string& term) {
+    vector<Product> results;
+    if (Storage::current() == STORAGE_CSV && !term.empty()) {
+        productIndex.scanNamePrefix(term, [&results](Product& product) {
+            results.push_back(move(product));
+            return true;
+        });
+    }
+    if (results.empty()) results = Product::searchByName(inventory.get(), term);
+    return results;
+}
+
+void searchProduct(Lazy<vector<Product>>& inventory) {
+    TRACE_SCOPE("searchProduct");
     displayMenuHeader("SEARCH PRODUCT");
     
     cout << CYAN << "┌─────────────────────────────────────────┐\n";
@@ -236,21 +437,14 @@ void searchProduct(const vector<Product>& inventory) {
             
             loadingScreen("Searching for product");
             
-            bool searchFound = false;
-            for (const auto& p : inventory) {
-                if (p.getID() == searchID) {
-                    displayMenuHeader("SEARCH RESULTS");
-                    cout << GREEN << "Product found:\n\n" << RESET;
-                    p.display();
-                    searchFound = true;
-                    break;
-                }
-            }
-            
-            if (!searchFound) {
-                showError("Product not found.");
-            } else {
+            Product p;
+            if (findProductByID(searchID, p)) {
+                displayMenuHeader("SEARCH RESULTS");
+                cout << GREEN << "Product found:\n\n" << RESET;
+                p.display();
                 waitForAnyKey();
+            } else {
+                showError("Product not found.");
             }
             break;
         }
@@ -269,7 +463,7 @@ void searchProduct(const vector<Product>& inventory) {
             
             loadingScreen("Searching for products");
             
-            vector<Product> results = Product::searchByName(inventory, searchName);
+            vector<Product> results = findProductsByName(inventory, searchName);
             
             if (results.empty()) {
                 showError("No products found matching '" + searchName + "'.");
@@ -293,8 +487,255 @@ void searchProduct(const vector<Product>& inventory) {
     }
 }
 
+// Rows, rate and memory of a finished catalog import
+void showImportSummary(const ImportStats& stats) {
+    char rate[32], memory[32], elapsed[32];
+    snprintf(rate, sizeof(rate), "%.0f rows/s", stats.rowsPerSecond());
+    snprintf(memory, sizeof(memory), "%.1f MiB", stats.peakMemoryBytes / (1024.0 * 1024.0));
+    snprintf(elapsed, sizeof(elapsed), "%.2f s", stats.seconds);
+    
+    Frame frame;
+    frame.add(CYAN).add(BOLD).line("Catalog import").add(RESET);
+    frame.tableRow({"Rows read", to_string(stats.rowsRead)}, {24, 20});
+    frame.tableRow({"Imported", to_string(stats.rowsImported)}, {24, 20});
+    frame.tableRow({"Duplicates skipped", to_string(stats.rowsDuplicate)}, {24, 20});
+    frame.tableRow({"Invalid rows skipped", to_string(stats.rowsInvalid)}, {24, 20});
+    frame.tableRow({"Time", elapsed}, {24, 20});
+    frame.tableRow({"Throughput", rate}, {24, 20});
+    frame.tableRow({"Peak memory", memory}, {24, 20});
+    frame.present();
+}
+
+// Stock and order statuses as the event log had them at `at`, with product
+// names from the current file
+bool showStateAsOf(const EventLog& events, time_t at, const string& label) {
+    LedgerState state;
+    ReplayStats stats;
+    if (!events.stateAt(at, state, &stats)) {
+        cerr << "Unable to read the event log\n";
+        return false;
+    }
+    unordered_map<int, string> names;
+    for (const auto& product : Product::loadAllFromFile(PRODUCTS_FILE)) names[product.getID()] = product.getName();
+    
+    Frame frame;
+    frame.add(CYAN).add(BOLD).line("Stock as of " + label).add(RESET);
+    frame.tableRow({"ID", "Product", "Quantity"}, {8, 32, 12});
+    for (size_t id = 1; id < state.stock.size(); ++id) {
+        if (state.stock[id] == 0) continue;
+        auto name = names.find(static_cast<int>(id));
+        frame.tableRow({to_string(id), name != names.end() ? name->second : "(deleted)", to_string(state.stock[id])}, {8, 32, 12});
+    }
+    
+    size_t byStatus[ORDER_CANCELLED + 1] = {};
+    for (uint8_t status : state.orders) {
+        if (status >= ORDER_PENDING && status <= ORDER_CANCELLED) ++byStatus[status];
+    }
+    frame.line().add(CYAN).add(BOLD).line("Orders").add(RESET);
+    for (int status = ORDER_PENDING; status <= ORDER_CANCELLED; ++status) {
+        frame.tableRow({Order::statusToString(static_cast<OrderStatus>(status)), to_string(byStatus[status])}, {24, 20});
+    }
+    
+    char elapsed[32];
+    snprintf(elapsed, sizeof(elapsed), "%.3f s", stats.seconds);
+    frame.line().add(CYAN).add(BOLD).line("Replay").add(RESET);
+    frame.tableRow({"Events applied", to_string(state.sequence)}, {24, 20});
+    frame.tableRow({"Started from", stats.snapshotSequence > 0 ? "event " + to_string(stats.snapshotSequence) : "the first event"}, {24, 20});
+    frame.tableRow({"Events replayed", to_string(stats.eventsReplayed)}, {24, 20});
+    frame.tableRow({"Time", elapsed}, {24, 20});
+    frame.present();
+    return true;
+}
+
+void importCatalog(vector<Product>& inventory, InventoryViews& views, EventLog& events) {
+    TRACE_SCOPE("importCatalog");
+    displayMenuHeader("IMPORT SUPPLIER CATALOG");
+    
+    string catalogFile;
+    cout << CYAN << "┌─────────────────────────────────────────┐\n";
+    cout << "│ " << YELLOW << "Columns: name,category,price,quantity," << RESET << "\n";
+    cout << "│ " << YELLOW << "         description (header optional)" << RESET << "\n";
+    
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    
+    cout << "│ " << YELLOW << "Enter catalog CSV path: " << RESET;
+    getline(cin, catalogFile);
+    cout << CYAN << "└─────────────────────────────────────────┘\n";
+    
+    loadingScreen("Importing catalog");
+    
+    size_t existing = inventory.size();
+    ImportStats stats = CatalogImport::run(catalogFile, inventory, PRODUCTS_FILE);
+    if (!stats.opened) {
+        showError("Unable to open " + catalogFile);
+        return;
+    }
+    if (!stats.saved) {
+        showError("Unable to write " + PRODUCTS_FILE + "; nothing was imported.");
+        return;
+    }
+    views.invalidateAll();
+    // Imported products are appended after the existing ones
+    vector<LedgerEvent> stocked;
+    for (size_t i = existing; i < inventory.size(); ++i) {
+        if (inventory[i].getQuantity() != 0) stocked.push_back(EventLog::stockChanged(inventory[i].getID(), inventory[i].getQuantity()));
+    }
+    if (!events.append(move(stocked))) cerr << "Unable to write to the event log\n";
+    
+    displayMenuHeader("IMPORT RESULTS");
+    showImportSummary(stats);
+    waitForAnyKey();
+}
+
+// Warehouse stock functions
+void viewWarehouses(const WarehouseStock& stock) {
+    TRACE_SCOPE("viewWarehouses");
+    displayMenuHeader("WAREHOUSES");
+    
+    Frame frame;
+    frame.add(CYAN).add(BOLD);
+    frame.tableRow({"ID", "Name", "Position (km)", "Units held"}, {6, 24, 18, 12});
+    frame.add(RESET);
+    for (const auto& warehouse : stock.warehouses()) {
+        char position[32];
+        snprintf(position, sizeof(position), "%.1f, %.1f", warehouse.x, warehouse.y);
+        frame.tableRow({to_string(warehouse.warehouseID), warehouse.name, position, to_string(stock.unitsAt(warehouse.warehouseID))},
+                       {6, 24, 18, 12});
+    }
+    frame.present();
+    waitForAnyKey();
+}
+
+void addWarehouse(WarehouseStock& stock) {
+    TRACE_SCOPE("addWarehouse");
+    displayMenuHeader("ADD WAREHOUSE");
+    
+    Warehouse warehouse{0, "", 0.0f, 0.0f};
+    cout << CYAN << "┌─────────────────────────────────────────┐\n";
+    
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    
+    cout << "│ " << YELLOW << "Enter Warehouse Name: " << RESET;
+    getline(cin, warehouse.name);
+    
+    cout << "│ " << YELLOW << "Enter Position X (km): " << RESET;
+    cin >> warehouse.x;
+    
+    cout << "│ " << YELLOW << "Enter Position Y (km): " << RESET;
+    cin >> warehouse.y;
+    
+    cout << CYAN << "└─────────────────────────────────────────┘\n";
+    
+    if (warehouse.name.empty()) {
+        showError("Warehouse name cannot be empty.");
+        return;
+    }
+    
+    warehouse.warehouseID = warehouseIDs.next();
+    if (!stock.addWarehouse(warehouse) || !stock.saveWarehouses(WAREHOUSES_FILE)) {
+        showError("Unable to save the warehouse.");
+        return;
+    }
+    showSuccess("Warehouse #" + to_string(warehouse.warehouseID) + " added.");
+}
+
+void viewProductStock(const vector<Product>& inventory, const WarehouseStock& stock) {
+    TRACE_SCOPE("viewProductStock");
+    displayMenuHeader("STOCK BY WAREHOUSE");
+    
+    int productID;
+    cout << CYAN << "┌─────────────────────────────────────────┐\n";
+    cout << "│ " << YELLOW << "Enter Product ID: " << RESET;
+    cin >> productID;
+    cout << CYAN << "└─────────────────────────────────────────┘\n";
+    
+    auto product = find_if(inventory.begin(), inventory.end(), [productID](const Product& p) { return p.getID() == productID; });
+    if (product == inventory.end()) {
+        showError("Product not found.");
+        return;
+    }
+    
+    displayMenuHeader("STOCK OF " + product->getName());
+    Frame frame;
+    frame.add(CYAN).add(BOLD);
+    frame.tableRow({"Warehouse", "Available"}, {30, 12});
+    frame.add(RESET);
+    for (const auto& warehouse : stock.warehouses()) {
+        frame.tableRow({warehouse.name, to_string(stock.available(productID, warehouse.warehouseID))}, {30, 12});
+    }
+    frame.tableRow({"Total", to_string(stock.total(productID))}, {30, 12});
+    frame.present();
+    waitForAnyKey();
+}
+
+// Received stock raises the product's quantity as well
+void receiveStock(vector<Product>& inventory, InventoryViews& views, WarehouseStock& stock, EventLog& events) {
+    TRACE_SCOPE("receiveStock");
+    displayMenuHeader("RECEIVE STOCK");
+    
+    int productID, warehouseID, quantity;
+    cout << CYAN << "┌─────────────────────────────────────────┐\n";
+    cout << "│ " << YELLOW << "Enter Product ID: " << RESET;
+    cin >> productID;
+    cout << "│ " << YELLOW << "Enter Warehouse ID: " << RESET;
+    cin >> warehouseID;
+    cout << "│ " << YELLOW << "Enter Quantity: " << RESET;
+    cin >> quantity;
+    cout << CYAN << "└─────────────────────────────────────────┘\n";
+    
+    auto product = find_if(inventory.begin(), inventory.end(), [productID](const Product& p) { return p.getID() == productID; });
+    if (product == inventory.end()) {
+        showError("Product not found.");
+        return;
+    }
+    if (quantity <= 0) {
+        showError("Quantity must be positive.");
+        return;
+    }
+    if (!stock.receive(productID, warehouseID, quantity)) {
+        showError("Warehouse not found.");
+        return;
+    }
+    product->addStock(quantity);
+    views.onProductUpdated(product - inventory.begin());
+    
+    loadingScreen("Receiving stock");
+    if (Product::saveAllToFile(PRODUCTS_FILE, inventory) && !events.append({EventLog::stockChanged(productID, quantity)})) {
+        cerr << "Unable to write to the event log\n";
+    }
+    stock.save(STOCK_FILE);
+    showSuccess("Stock received.");
+}
+
+void transferStock(WarehouseStock& stock) {
+    TRACE_SCOPE("transferStock");
+    displayMenuHeader("TRANSFER STOCK");
+    
+    int productID, fromID, toID, quantity;
+    cout << CYAN << "┌─────────────────────────────────────────┐\n";
+    cout << "│ " << YELLOW << "Enter Product ID: " << RESET;
+    cin >> productID;
+    cout << "│ " << YELLOW << "From Warehouse ID: " << RESET;
+    cin >> fromID;
+    cout << "│ " << YELLOW << "To Warehouse ID: " << RESET;
+    cin >> toID;
+    cout << "│ " << YELLOW << "Enter Quantity: " << RESET;
+    cin >> quantity;
+    cout << CYAN << "└─────────────────────────────────────────┘\n";
+    
+    if (!stock.transfer(productID, fromID, toID, quantity)) {
+        showError("Transfer not possible: check IDs and stock.");
+        return;
+    }
+    stock.save(STOCK_FILE);
+    showSuccess("Stock transferred.");
+}
+
 // Supplier management functions
 void addSupplier(vector<Supplier>& suppliers) {
+    TRACE_SCOPE("addSupplier");
     displayMenuHeader("ADD NEW SUPPLIER");
     
     string name, contactPerson, phone, email, address, username, password;
@@ -346,6 +787,7 @@ void addSupplier(vector<Supplier>& suppliers) {
 }
 
 void viewSuppliers(const vector<Supplier>& suppliers) {
+    TRACE_SCOPE("viewSuppliers");
     displayMenuHeader("SUPPLIER LIST");
     
     if (suppliers.empty()) {
@@ -364,6 +806,7 @@ void viewSuppliers(const vector<Supplier>& suppliers) {
 }
 
 void updateSupplier(vector<Supplier>& suppliers) {
+    TRACE_SCOPE("updateSupplier");
     displayMenuHeader("UPDATE SUPPLIER");
     
     int updateID;
@@ -435,15 +878,7 @@ void updateSupplier(vector<Supplier>& suppliers) {
             loadingScreen("Updating supplier");
             
             // Update file
-            ofstream file(SUPPLIERS_FILE);
-            for (const auto& supplier : suppliers) {
-                file << supplier.getID() << "," << supplier.getName() << "," 
-                     << supplier.getContactPerson() << "," << supplier.getPhone() << ","
-                     << supplier.getEmail() << "," << supplier.getAddress() << ","
-                     << supplier.getUsername() << "," << supplier.getPassword() << ","
-                     << supplier.getStatus() << "\n";
-            }
-            file.close();
+            Supplier::saveAllToFile(SUPPLIERS_FILE, suppliers);
             
             showSuccess("Supplier updated successfully!");
             break;
@@ -456,6 +891,7 @@ void updateSupplier(vector<Supplier>& suppliers) {
 }
 
 void deleteSupplier(vector<Supplier>& suppliers) {
+    TRACE_SCOPE("deleteSupplier");
     displayMenuHeader("DELETE SUPPLIER");
     
     int deleteID;
@@ -484,15 +920,7 @@ void deleteSupplier(vector<Supplier>& suppliers) {
                 loadingScreen("Deleting supplier");
                 
                 // Update file
-                ofstream file(SUPPLIERS_FILE);
-                for (const auto& supplier : suppliers) {
-                    file << supplier.getID() << "," << supplier.getName() << "," 
-                         << supplier.getContactPerson() << "," << supplier.getPhone() << ","
-                         << supplier.getEmail() << "," << supplier.getAddress() << ","
-                         << supplier.getUsername() << "," << supplier.getPassword() << ","
-                         << supplier.getStatus() << "\n";
-                }
-                file.close();
+                Supplier::saveAllToFile(SUPPLIERS_FILE, suppliers);
                 
                 showSuccess("Supplier deleted successfully!");
             } else {
@@ -508,9 +936,29 @@ void deleteSupplier(vector<Supplier>& suppliers) {
 }
 
 // Order management functions
-void createOrder(vector<Order>& orders, vector<Product>& inventory) {
+// Name of a warehouse for messages; the ID if it is unknown
+string warehouseName(const WarehouseStock& stock, int warehouseID) {
+    for (const auto& warehouse : stock.warehouses()) {
+        if (warehouse.warehouseID == warehouseID) return warehouse.name;
+    }
+    return "#" + to_string(warehouseID);
+}
+
+// Items ship from the chosen warehouse when it holds enough, otherwise
+// from the nearest one that does
+// Appends through the order store, so the history is never loaded; the
+// loaded history and analytics are patched only if some screen has them
+void createOrder(Workspace& data) {
+    TRACE_SCOPE("createOrder");
+    static Counter fromChosen("wms_stock_allocations_total", "Order lines by the warehouse they ship from", "source=\"chosen\"");
+    static Counter fromNearest("wms_stock_allocations_total", "Order lines by the warehouse they ship from", "source=\"nearest\"");
     displayMenuHeader("CREATE NEW ORDER");
     
+    vector<Product>& inventory = data.inventory.get();
+    WarehouseStock& stock = data.stock.get();
+    // Pick up quantities changed on the product screens since the last order
+    stock.reconcile(inventory);
+    
     int customerID;
     string customerName;
     char addMore = 'y';
@@ -529,6 +977,15 @@ void createOrder(vector<Order>& orders, vector<Product>& inventory) {
     cout << "│ " << YELLOW << "Enter Customer Name: " << RESET;
     getline(cin, customerName);
     
+    cout << "│ " << YELLOW << "Warehouses:" << RESET << "\n";
+    for (const auto& warehouse : stock.warehouses()) {
+        cout << "│   " << warehouse.warehouseID << ". " << warehouse.name << "\n";
+    }
+    cout << "│ " << YELLOW << "Ship from warehouse ID (0 for " << warehouseName(stock, stock.defaultWarehouse()) << "): " << RESET;
+    int shipFrom;
+    cin >> shipFrom;
+    if (shipFrom == 0) shipFrom = stock.defaultWarehouse();
+    
     cout << CYAN << "└─────────────────────────────────────────┘\n";
     
     Order newOrder(customerID, customerName);
@@ -572,10 +1029,24 @@ void createOrder(vector<Order>& orders, vector<Product>& inventory) {
                     cout << CYAN << "└─────────────────────────────────────────┘\n";
                     showError("Not enough stock available.");
                 } else {
-                    newOrder.addItem(p, quantity);
-                    p.removeStock(quantity);
+                    int source = stock.available(p.getID(), shipFrom) >= quantity
+                                     ? shipFrom
+                                     : stock.nearestWithStock(p.getID(), quantity, shipFrom);
                     cout << CYAN << "└─────────────────────────────────────────┘\n";
-                    showSuccess("Item added to order.");
+                    if (source == 0 || !stock.take(p.getID(), source, quantity)) {
+                        showError("No single warehouse holds that many.");
+                    } else {
+                        newOrder.addItem(p, quantity, source);
+                        p.removeStock(quantity);
+                        if (data.analytics.loaded()) data.analytics.get().registerProduct(p);
+                        if (source == shipFrom) {
+                            fromChosen.increment();
+                            showSuccess("Item added to order.");
+                        } else {
+                            fromNearest.increment();
+                            showSuccess("Item added, shipping from " + warehouseName(stock, source) + ".");
+                        }
+                    }
                 }
                 break;
             }
@@ -597,40 +1068,66 @@ void createOrder(vector<Order>& orders, vector<Product>& inventory) {
     
     loadingScreen("Creating order");
     
-    orders.push_back(newOrder);
-    newOrder.saveToFile(ORDERS_FILE);
-    
-    // Update product inventory in file
-    ofstream file(PRODUCTS_FILE);
-    for (const auto& product : inventory) {
-        file << product.getID() << "," << product.getName() << "," 
-             << product.getPrice() << "," << product.getQuantity() << ","
-             << product.getCategory() << "," << product.getDescription() << "\n";
+    {
+        // Time the commit itself, not the prompts or the animation
+        static Histogram commitTime("wms_order_commit_seconds", "Time to persist a new order and update stock");
+        static Counter ordersCreated("wms_orders_created_total", "Orders committed");
+        ScopedTimer timer(commitTime);
+        
+        if (!data.orderStore.add(newOrder)) cerr << "Unable to write the order to " << ORDERS_FILE << "\n";
+        if (data.orders.loaded()) data.orders.get().push_back(newOrder);
+        if (data.analytics.loaded()) data.analytics.get().recordOrder(newOrder);
+        if (data.views.loaded()) data.views.get().invalidate(SORT_BY_QUANTITY);
+        
+        // Update product inventory in file
+        Product::saveAllToFile(PRODUCTS_FILE, inventory);
+        stock.save(STOCK_FILE);
+        
+        vector<LedgerEvent> logged{EventLog::orderCreated(newOrder.getID())};
+        for (const auto& item : newOrder.getItems()) {
+            logged.push_back(EventLog::stockChanged(item.productID, -item.quantity, newOrder.getID()));
+        }
+        if (!data.events.append(move(logged))) cerr << "Unable to write to the event log\n";
+        ordersCreated.increment();
     }
-    file.close();
     
     showSuccess("Order created successfully!");
 }
 
 void viewOrders(const vector<Order>& orders) {
-    displayMenuHeader("ORDER LIST");
-    
+    TRACE_SCOPE("viewOrders");
     if (orders.empty()) {
         showWarning("No orders available.");
         return;
     }
     
-    cout << CYAN << BOLD << "Total Orders: " << RESET << orders.size() << "\n\n";
-    
-    for (const auto& o : orders) {
-        o.display();
-        cout << "\n";
-    }
-    
-    waitForAnyKey();
+    Pager<Order> pager(orders, "ORDER LIST");
+    pager.setFilter([](const Order& o, const string& term) {
+        return toLowerCase(o.getCustomerName()).find(term) != string::npos ||
+               toLowerCase(o.getStatusString()) == term ||
+               to_string(o.getCustomerID()) == term;
+    });
+    pager.addSortKey("Order ID", [](const Order& a, const Order& b) { return a.getID() < b.getID(); });
+    pager.addSortKey("Date", [](const Order& a, const Order& b) { return a.getOrderDate() < b.getOrderDate(); });
+    pager.addSortKey("Total", [](const Order& a, const Order& b) { return a.getTotalAmount() < b.getTotalAmount(); });
+    pager.addSortKey("Status", [](const Order& a, const Order& b) { return a.getStatus() < b.getStatus(); });
+    pager.addSortKey("Customer", [](const Order& a, const Order& b) { return a.getCustomerName() < b.getCustomerName(); });
+    pager.run();
+}
+
+void showStatusChoices() {
+    cout << "│ " << YELLOW << "1. Pending" << RESET << "\n";
+    cout << "│ " << YELLOW << "2. Processing" << RESET << "\n";
+    cout << "│ " << YELLOW << "3. Shipped" << RESET << "\n";
+    cout << "│ " << YELLOW << "4. Delivered" << RESET << "\n";
+    cout << "│ " << YELLOW << "5. Cancelled" << RESET << "\n";
+    cout << "│ " << YELLOW << "Enter choice (1-5): " << RESET;
 }
 
-void updateOrderStatus(vector<Order>& orders) {
+// Loads only the order being changed, through the order cache, and hands
+// the change to the fulfillment pipeline, which checks it and applies it
+void updateOrderStatus(Workspace& data) {
+    TRACE_SCOPE("updateOrderStatus");
     displayMenuHeader("UPDATE ORDER STATUS");
     
     int updateID;
@@ -639,59 +1136,299 @@ void updateOrderStatus(vector<Order>& orders) {
     cin >> updateID;
     cout << CYAN << "└─────────────────────────────────────────┘\n";
     
-    bool updateFound = false;
-    for (auto& o : orders) {
-        if (o.getID() == updateID) {
-            updateFound = true;
-            
-            displayMenuHeader("UPDATE ORDER #" + to_string(updateID));
-            cout << CYAN << "Current Order Details:\n\n" << RESET;
-            o.display();
-            cout << "\n";
-            
-            cout << CYAN << "┌─────────────────────────────────────────┐\n";
-            cout << "│ " << YELLOW << "Current Status: " << RESET << o.getStatusString() << "\n";
-            cout << "│ " << YELLOW << "Select New Status:" << RESET << "\n";
-            cout << "│ " << YELLOW << "1. Pending" << RESET << "\n";
-            cout << "│ " << YELLOW << "2. Processing" << RESET << "\n";
-            cout << "│ " << YELLOW << "3. Shipped" << RESET << "\n";
-            cout << "│ " << YELLOW << "4. Delivered" << RESET << "\n";
-            cout << "│ " << YELLOW << "5. Cancelled" << RESET << "\n";
-            cout << "│ " << YELLOW << "Enter choice (1-5): " << RESET;
-            
-            int statusChoice;
-            cin >> statusChoice;
+    shared_ptr<const Order> found = data.orderStore.find(updateID);
+    if (!found) {
+        showError("Order not found.");
+        return;
+    }
+    Order o = *found;
+    data.fulfillment.track(o.getID(), o.getStatus());
+    
+    displayMenuHeader("UPDATE ORDER #" + to_string(updateID));
+    cout << CYAN << "Current Order Details:\n\n" << RESET;
+    o.display();
+    cout << "\n";
+    
+    cout << CYAN << "┌─────────────────────────────────────────┐\n";
+    cout << "│ " << YELLOW << "Current Status: " << RESET << o.getStatusString() << "\n";
+    cout << "│ " << YELLOW << "Select New Status:" << RESET << "\n";
+    showStatusChoices();
+    
+    int statusChoice;
+    cin >> statusChoice;
+    cout << CYAN << "└─────────────────────────────────────────┘\n";
+    
+    if (statusChoice < 1 || statusChoice > 5) {
+        showError("Invalid status choice.");
+        return;
+    }
+    
+    OrderStatus newStatus = static_cast<OrderStatus>(statusChoice);
+    if (data.fulfillment.transition(o.getID(), newStatus) != TRANSITION_ACCEPTED) {
+        showError("A " + o.getStatusString() + " order cannot become " + Order::statusToString(newStatus) + ".");
+        return;
+    }
+    
+    loadingScreen("Updating order status");
+    // Wait for the worker, so the files and screens show the change
+    data.fulfillment.flush();
+    
+    showSuccess("Order status updated successfully!");
+}
+
+// Picks orders by ID or by status and age, reading only the order headers,
+// and moves them all through the fulfillment pipeline, which writes the
+// changes a batch at a time
+void bulkUpdateOrderStatus(Workspace& data) {
+    TRACE_SCOPE("bulkUpdateOrderStatus");
+    displayMenuHeader("BULK UPDATE ORDER STATUS");
+    
+    cout << CYAN << "┌─────────────────────────────────────────┐\n";
+    cout << "│ " << YELLOW << "Select orders by:" << RESET << "\n";
+    cout << "│ " << YELLOW << "1. Order IDs" << RESET << "\n";
+    cout << "│ " << YELLOW << "2. Current status and age" << RESET << "\n";
+    cout << "│ " << YELLOW << "Enter choice (1-2): " << RESET;
+    int selectBy;
+    cin >> selectBy;
+    
+    vector<int> selected;
+    size_t notFound = 0;
+    if (selectBy == 1) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        string list;
+        cout << "│ " << YELLOW << "Order IDs (e.g. 12, 15-40): " << RESET;
+        getline(cin, list);
+        vector<int> ids;
+        if (!parseOrderIDs(list, ids)) {
             cout << CYAN << "└─────────────────────────────────────────┘\n";
-            
-            if (statusChoice < 1 || statusChoice > 5) {
-                showError("Invalid status choice.");
-            } else {
-                o.setStatus(static_cast<OrderStatus>(statusChoice));
-                
-                loadingScreen("Updating order status");
-                
-                // Update file
-                ofstream file(ORDERS_FILE);
-                for (const auto& order : orders) {
-                    file << order.getID() << "," << order.getCustomerID() << "," 
-                         << order.getCustomerName() << "," << order.getTotalAmount() << ","
-                         << order.getOrderDate() << "," << order.getStatus() << "\n";
-                }
-                file.close();
-                
-                showSuccess("Order status updated successfully!");
+            showError("Invalid order ID list.");
+            return;
+        }
+        for (int id : ids) {
+            Order header;
+            if (!data.orderStore.findHeader(id, header)) {
+                ++notFound;
+                continue;
+            }
+            data.fulfillment.track(id, header.getStatus());
+            selected.push_back(id);
+        }
+    } else if (selectBy == 2) {
+        cout << "│ " << YELLOW << "Current Status:" << RESET << "\n";
+        showStatusChoices();
+        int current;
+        cin >> current;
+        cout << "│ " << YELLOW << "Placed at least how many days ago: " << RESET;
+        int days;
+        cin >> days;
+        if (current < 1 || current > 5 || days < 0) {
+            cout << CYAN << "└─────────────────────────────────────────┘\n";
+            showError("Invalid status or age.");
+            return;
+        }
+        time_t cutoff = time(nullptr) - static_cast<time_t>(days) * 24 * 60 * 60;
+        data.orderStore.scanHeaders([&](Order& header) {
+            if (header.getStatus() == current && header.getOrderDate() <= cutoff) {
+                data.fulfillment.track(header.getID(), header.getStatus());
+                selected.push_back(header.getID());
+            }
+            return true;
+        });
+    } else {
+        cout << CYAN << "└─────────────────────────────────────────┘\n";
+        showError("Invalid choice.");
+        return;
+    }
+    
+    if (selected.empty()) {
+        cout << CYAN << "└─────────────────────────────────────────┘\n";
+        showError("No matching orders.");
+        return;
+    }
+    
+    cout << "│ " << YELLOW << "Orders selected: " << RESET << selected.size() << "\n";
+    cout << "│ " << YELLOW << "Select New Status:" << RESET << "\n";
+    showStatusChoices();
+    int statusChoice;
+    cin >> statusChoice;
+    cout << CYAN << "└─────────────────────────────────────────┘\n";
+    
+    if (statusChoice < 1 || statusChoice > 5) {
+        showError("Invalid status choice.");
+        return;
+    }
+    
+    loadingScreen("Updating order statuses");
+    vector<TransitionResult> results;
+    size_t moved = data.fulfillment.transitionAll(selected, static_cast<OrderStatus>(statusChoice), &results);
+    data.fulfillment.flush();
+    
+    size_t notAllowed = 0;
+    for (TransitionResult result : results) {
+        if (result == TRANSITION_NOT_ALLOWED) ++notAllowed;
+    }
+    
+    displayMenuHeader("BULK UPDATE RESULTS");
+    Frame frame;
+    frame.add(CYAN).add(BOLD).line("Now " + Order::statusToString(static_cast<OrderStatus>(statusChoice))).add(RESET);
+    frame.tableRow({"Updated", to_string(moved)}, {24, 20});
+    frame.tableRow({"Not allowed from status", to_string(notAllowed)}, {24, 20});
+    frame.tableRow({"Not found", to_string(notFound)}, {24, 20});
+    frame.present();
+    waitForAnyKey();
+}
+
+void viewSalesDashboard(const SalesAnalytics& analytics) {
+    TRACE_SCOPE("viewSalesDashboard");
+    displayMenuHeader("SALES DASHBOARD");
+    
+    cout << CYAN << BOLD << "Total Revenue: " << RESET << "$" << fixed << setprecision(2) << analytics.getTotalRevenue() << "\n";
+    cout << CYAN << BOLD << "Today's Revenue: " << RESET << "$" << analytics.getDayRevenue(time(nullptr)) << "\n\n";
+    
+    cout << CYAN << BOLD << "Revenue by Category:\n" << RESET;
+    if (analytics.getRevenueByCategory().empty()) {
+        cout << "  No sales recorded yet.\n";
+    }
+    for (const auto& entry : analytics.getRevenueByCategory()) {
+        cout << "  " << entry.first << ": $" << entry.second << "\n";
+    }
+    
+    cout << "\n" << CYAN << BOLD << "Revenue by Product ID:\n" << RESET;
+    for (const auto& entry : analytics.getRevenueByProduct()) {
+        cout << "  #" << entry.first << ": $" << entry.second << "\n";
+    }
+    
+    waitForAnyKey();
+}
+
+void viewReports(const vector<Order>& orders, const vector<Product>& inventory) {
+    TRACE_SCOPE("viewReports");
+    displayMenuHeader("REPORTS");
+    
+    cout << CYAN << "┌─────────────────────────────────────────┐\n";
+    cout << "│ " << YELLOW << "1. Top 10 Products" << RESET << "                   │\n";
+    cout << "│ " << YELLOW << "2. Revenue per Customer" << RESET << "              │\n";
+    cout << "│ " << YELLOW << "3. Stock Valuation" << RESET << "                   │\n";
+    cout << "│ " << YELLOW << "4. Order Status Breakdown" << RESET << "            │\n";
+    cout << "│ " << YELLOW << "5. Back to Order Menu" << RESET << "                │\n";
+    cout << CYAN << "└─────────────────────────────────────────┘\n";
+    cout << CYAN << "Select an option (1-5): " << RESET;
+    
+    char choice = singleInput();
+    string reportFile;
+    bool saved = false;
+    
+    switch (choice) {
+        case '1': {
+            vector<ProductSales> report = Reports::topProducts(orders, 10);
+            displayMenuHeader("TOP 10 PRODUCTS");
+            for (const auto& row : report) {
+                cout << CYAN << "#" << row.productID << " " << RESET << row.productName
+                     << " | Units: " << row.unitsSold << " | Revenue: $" << fixed << setprecision(2) << row.revenue << "\n";
             }
+            reportFile = "report_top_products.csv";
+            saved = Reports::saveTopProducts(report, reportFile);
             break;
         }
+        case '2': {
+            vector<CustomerRevenue> report = Reports::revenueByCustomer(orders);
+            displayMenuHeader("REVENUE PER CUSTOMER");
+            for (const auto& row : report) {
+                cout << CYAN << "#" << row.customerID << " " << RESET << row.customerName
+                     << " | Orders: " << row.orderCount << " | Revenue: $" << fixed << setprecision(2) << row.revenue << "\n";
+            }
+            reportFile = "report_customer_revenue.csv";
+            saved = Reports::saveRevenueByCustomer(report, reportFile);
+            break;
+        }
+        case '3': {
+            StockValuation report = Reports::stockValuation(inventory);
+            displayMenuHeader("STOCK VALUATION");
+            for (const auto& entry : report.valueByCategory) {
+                cout << CYAN << entry.first << RESET << ": $" << fixed << setprecision(2) << entry.second << "\n";
+            }
+            cout << "\n" << BOLD << "Total Units: " << RESET << report.totalUnits << "\n";
+            cout << BOLD << "Total Value: " << RESET << "$" << report.totalValue << "\n";
+            reportFile = "report_stock_valuation.csv";
+            saved = Reports::saveStockValuation(report, reportFile);
+            break;
+        }
+        case '4': {
+            StatusBreakdown report = Reports::statusBreakdown(orders);
+            displayMenuHeader("ORDER STATUS BREAKDOWN");
+            for (int s = ORDER_PENDING; s <= ORDER_CANCELLED; ++s) {
+                cout << CYAN << Order::statusToString(static_cast<OrderStatus>(s)) << RESET
+                     << " | Orders: " << report.orderCount[s] << " | Value: $" << fixed << setprecision(2) << report.revenue[s] << "\n";
+            }
+            reportFile = "report_status_breakdown.csv";
+            saved = Reports::saveStatusBreakdown(report, reportFile);
+            break;
+        }
+        case '5':
+            return;
+        default:
+            showError("Invalid choice. Try again.");
+            return;
     }
     
-    if (!updateFound) {
-        showError("Order not found.");
+    if (saved) {
+        cout << "\n" << GREEN << "Report written to " << reportFile << "\n" << RESET;
+    } else {
+        cout << "\n" << RED << "Unable to write " << reportFile << "\n" << RESET;
+    }
+    waitForAnyKey();
+}
+
+// Format a nanosecond duration for display
+string formatDuration(uint64_t nanoseconds) {
+    char buffer[32];
+    if (nanoseconds < 1000) snprintf(buffer, sizeof(buffer), "%llu ns", (unsigned long long)nanoseconds);
+    else if (nanoseconds < 1000000) snprintf(buffer, sizeof(buffer), "%.1f us", nanoseconds / 1e3);
+    else if (nanoseconds < 1000000000) snprintf(buffer, sizeof(buffer), "%.2f ms", nanoseconds / 1e6);
+    else snprintf(buffer, sizeof(buffer), "%.2f s", nanoseconds / 1e9);
+    return buffer;
+}
+
+// Counters and latency percentiles recorded since startup
+void viewMetrics() {
+    TRACE_SCOPE("viewMetrics");
+    displayMenuHeader("SYSTEM METRICS");
+    
+    Frame frame;
+    frame.add(CYAN).add(BOLD).line("Counters").add(RESET);
+    const vector<MetricInfo>& counters = Metrics::counters();
+    for (size_t i = 0; i < counters.size(); ++i) {
+        frame.tableRow({counters[i].name + " " + counters[i].labels, to_string(Metrics::counterValue(i))}, {56, 12});
+    }
+    
+    frame.line().add(CYAN).add(BOLD);
+    frame.tableRow({"Latency", "Count", "p50", "p99", "Mean"}, {40, 8, 10, 10, 10});
+    frame.add(RESET);
+    const vector<MetricInfo>& histograms = Metrics::histograms();
+    for (size_t i = 0; i < histograms.size(); ++i) {
+        HistogramSnapshot snapshot = Metrics::histogramSnapshot(i);
+        uint64_t mean = snapshot.count ? snapshot.sum / snapshot.count : 0;
+        frame.tableRow({histograms[i].name + " " + histograms[i].labels, to_string(snapshot.count),
+                        formatDuration(snapshot.quantile(0.5)), formatDuration(snapshot.quantile(0.99)),
+                        formatDuration(mean)}, {40, 8, 10, 10, 10});
+    }
+    frame.present();
+    
+    cout << "\n" << YELLOW << "Export to " << METRICS_FILE << "? (y/n): " << RESET;
+    char choice = singleInput();
+    if (choice == 'y' || choice == 'Y') {
+        if (Metrics::saveToFile(METRICS_FILE)) {
+            showSuccess("Metrics written to " + METRICS_FILE);
+        } else {
+            showError("Unable to write " + METRICS_FILE);
+        }
     }
 }
 
 // Staff management functions
 void viewStaffList(const vector<Staff>& staffList) {
+    TRACE_SCOPE("viewStaffList");
     displayMenuHeader("STAFF LIST");
     
     if (staffList.empty()) {
@@ -710,6 +1447,7 @@ void viewStaffList(const vector<Staff>& staffList) {
 }
 
 void updateStaffMember(vector<Staff>& staffList, const Staff& currentUser) {
+    TRACE_SCOPE("updateStaffMember");
     displayMenuHeader("UPDATE STAFF");
     
     if (currentUser.getRole() != ADMIN) {
@@ -778,14 +1516,7 @@ void updateStaffMember(vector<Staff>& staffList, const Staff& currentUser) {
             loadingScreen("Updating staff record");
             
             // Update file
-            ofstream file(STAFF_FILE);
-            for (const auto& staff : staffList) {
-                file << staff.getID() << "," << staff.getUsername() << "," 
-                     << staff.getPassword() << "," << staff.getName() << ","
-                     << staff.getPhone() << "," << staff.getEmail() << ","
-                     << staff.getRole() << "\n";
-            }
-            file.close();
+            Staff::saveAllToFile(STAFF_FILE, staffList);
             
             showSuccess("Staff record updated successfully!");
             break;
@@ -798,6 +1529,7 @@ void updateStaffMember(vector<Staff>& staffList, const Staff& currentUser) {
 }
 
 void deleteStaffMember(vector<Staff>& staffList, const Staff& currentUser) {
+    TRACE_SCOPE("deleteStaffMember");
     displayMenuHeader("DELETE STAFF");
     
     if (currentUser.getRole() != ADMIN) {
@@ -836,14 +1568,7 @@ void deleteStaffMember(vector<Staff>& staffList, const Staff& currentUser) {
                 loadingScreen("Deleting staff record");
                 
                 // Update file
-                ofstream file(STAFF_FILE);
-                for (const auto& staff : staffList) {
-                    file << staff.getID() << "," << staff.getUsername() << "," 
-                         << staff.getPassword() << "," << staff.getName() << ","
-                         << staff.getPhone() << "," << staff.getEmail() << ","
-                         << staff.getRole() << "\n";
-                }
-                file.close();
+                Staff::saveAllToFile(STAFF_FILE, staffList);
                 
                 showSuccess("Staff record deleted successfully!");
             } else {
@@ -860,6 +1585,7 @@ void deleteStaffMember(vector<Staff>& staffList, const Staff& currentUser) {
 
 // Supplier dashboard functions
 void viewSupplierProfile(const Supplier& supplier) {
+    TRACE_SCOPE("viewSupplierProfile");
     displayMenuHeader("SUPPLIER PROFILE");
     
     cout << CYAN << "Your Profile Details:\n\n" << RESET;
@@ -869,6 +1595,7 @@ void viewSupplierProfile(const Supplier& supplier) {
 }
 
 void updateSupplierProfile(Supplier& supplier) {
+    TRACE_SCOPE("updateSupplierProfile");
     displayMenuHeader("UPDATE PROFILE");
     
     string newContactPerson, newPhone, newEmail, newAddress, newPassword;
@@ -911,39 +1638,24 @@ void updateSupplierProfile(Supplier& supplier) {
         }
     }
     
-    ofstream file(SUPPLIERS_FILE);
-    for (const auto& s : suppliers) {
-        file << s.getID() << "," << s.getName() << "," 
-             << s.getContactPerson() << "," << s.getPhone() << ","
-             << s.getEmail() << "," << s.getAddress() << ","
-             << s.getUsername() << "," << s.getPassword() << ","
-             << s.getStatus() << "\n";
-    }
-    file.close();
+    Supplier::saveAllToFile(SUPPLIERS_FILE, suppliers);
     
     showSuccess("Profile updated successfully!");
 }
 
-void viewSupplierProducts(const vector<Product>& inventory) {
-    displayMenuHeader("VIEW PRODUCTS");
-    
+void viewSupplierProducts(const vector<Product>& inventory, InventoryViews& views) {
+    TRACE_SCOPE("viewSupplierProducts");
     if (inventory.empty()) {
         showWarning("No products available in the system.");
         return;
     }
     
-    cout << CYAN << BOLD << "Total Products: " << RESET << inventory.size() << "\n\n";
-    
-    for (const auto& p : inventory) {
-        p.display();
-        cout << "\n";
-    }
-    
-    waitForAnyKey();
+    browseProducts(inventory, views, "VIEW PRODUCTS");
 }
 
 // Menu handlers
-void handleProductMenu(vector<Product>& inventory) {
+void handleProductMenu(Workspace& data) {
+    TRACE_SCOPE("handleProductMenu");
     while (true) {
         displayMenuHeader("PRODUCT MANAGEMENT");
         
@@ -953,34 +1665,44 @@ void handleProductMenu(vector<Product>& inventory) {
         cout << "│ " << YELLOW << "3. Update Product" << RESET << "                     │\n";
         cout << "│ " << YELLOW << "4. Delete Product" << RESET << "                     │\n";
         cout << "│ " << YELLOW << "5. Search Product" << RESET << "                     │\n";
-        cout << "│ " << YELLOW << "6. Back to Main Menu" << RESET << "                  │\n";
+        cout << "│ " << YELLOW << "6. Import Catalog (CSV)" << RESET << "               │\n";
+        cout << "│ " << YELLOW << "7. Warehouse Stock" << RESET << "                    │\n";
+        cout << "│ " << YELLOW << "8. Back to Main Menu" << RESET << "                  │\n";
         cout << CYAN << "└─────────────────────────────────────────┘\n";
-        cout << CYAN << "Select an option (1-6): " << RESET;
+        cout << CYAN << "Select an option (1-8): " << RESET;
         
         char choice = singleInput();
         
         switch (choice) {
             case '1': 
                 loadingScreen("Opening Add Product");
-                addProduct(inventory); 
+                addProduct(data.inventory.get(), data.views.get(), data.events); 
                 break;
             case '2': 
                 loadingScreen("Loading Products");
-                viewProducts(inventory); 
+                viewProducts(data.inventory.get(), data.views.get()); 
                 break;
             case '3': 
                 loadingScreen("Opening Update Product");
-                updateProduct(inventory); 
+                updateProduct(data.inventory.get(), data.views.get(), data.events); 
                 break;
             case '4': 
                 loadingScreen("Opening Delete Product");
-                deleteProduct(inventory); 
+                deleteProduct(data.inventory.get(), data.views.get(), data.events); 
                 break;
             case '5': 
                 loadingScreen("Opening Search Product");
-                searchProduct(inventory); 
+                searchProduct(data.inventory); 
                 break;
             case '6': 
+                loadingScreen("Opening Catalog Import");
+                importCatalog(data.inventory.get(), data.views.get(), data.events); 
+                break;
+            case '7': 
+                loadingScreen("Opening Warehouse Stock");
+                handleWarehouseMenu(data); 
+                break;
+            case '8': 
                 loadingScreen("Returning to Main Menu");
                 return;
             default:
@@ -989,7 +1711,51 @@ void handleProductMenu(vector<Product>& inventory) {
     }
 }
 
+void handleWarehouseMenu(Workspace& data) {
+    TRACE_SCOPE("handleWarehouseMenu");
+    // Pick up quantities changed on the product screens
+    if (data.stock.get().reconcile(data.inventory.get()) > 0) data.stock.get().save(STOCK_FILE);
+    while (true) {
+        displayMenuHeader("WAREHOUSE STOCK");
+        
+        cout << CYAN << "┌─────────────────────────────────────────┐\n";
+        cout << "│ " << YELLOW << "1. View Warehouses" << RESET << "                    │\n";
+        cout << "│ " << YELLOW << "2. Add Warehouse" << RESET << "                      │\n";
+        cout << "│ " << YELLOW << "3. Stock by Warehouse" << RESET << "                 │\n";
+        cout << "│ " << YELLOW << "4. Receive Stock" << RESET << "                      │\n";
+        cout << "│ " << YELLOW << "5. Transfer Stock" << RESET << "                     │\n";
+        cout << "│ " << YELLOW << "6. Back to Product Menu" << RESET << "               │\n";
+        cout << CYAN << "└─────────────────────────────────────────┘\n";
+        cout << CYAN << "Select an option (1-6): " << RESET;
+        
+        char choice = singleInput();
+        
+        switch (choice) {
+            case '1': 
+                viewWarehouses(data.stock.get()); 
+                break;
+            case '2': 
+                addWarehouse(data.stock.get()); 
+                break;
+            case '3': 
+                viewProductStock(data.inventory.get(), data.stock.get()); 
+                break;
+            case '4': 
+                receiveStock(data.inventory.get(), data.views.get(), data.stock.get(), data.events); 
+                break;
+            case '5': 
+                transferStock(data.stock.get()); 
+                break;
+            case '6': 
+                return;
+            default:
+                showError("Invalid choice. Try again.");
+        }
+    }
+}
+
 void handleSupplierMenu(vector<Supplier>& suppliers, const Staff& currentUser) {
+    TRACE_SCOPE("handleSupplierMenu");
     while (true) {
         displayMenuHeader("SUPPLIER MANAGEMENT");
         
@@ -1035,7 +1801,8 @@ void handleSupplierMenu(vector<Supplier>& suppliers, const Staff& currentUser) {
     }
 }
 
-void handleOrderMenu(vector<Order>& orders, vector<Product>& inventory) {
+void handleOrderMenu(Workspace& data) {
+    TRACE_SCOPE("handleOrderMenu");
     while (true) {
         displayMenuHeader("ORDER MANAGEMENT");
         
@@ -1043,26 +1810,41 @@ void handleOrderMenu(vector<Order>& orders, vector<Product>& inventory) {
         cout << "│ " << YELLOW << "1. Create Order" << RESET << "                      │\n";
         cout << "│ " << YELLOW << "2. View All Orders" << RESET << "                   │\n";
         cout << "│ " << YELLOW << "3. Update Order Status" << RESET << "               │\n";
-        cout << "│ " << YELLOW << "4. Back to Main Menu" << RESET << "                 │\n";
+        cout << "│ " << YELLOW << "4. Bulk Update Status" << RESET << "                │\n";
+        cout << "│ " << YELLOW << "5. Sales Dashboard" << RESET << "                   │\n";
+        cout << "│ " << YELLOW << "6. Reports" << RESET << "                           │\n";
+        cout << "│ " << YELLOW << "7. Back to Main Menu" << RESET << "                 │\n";
         cout << CYAN << "└─────────────────────────────────────────┘\n";
-        cout << CYAN << "Select an option (1-4): " << RESET;
+        cout << CYAN << "Select an option (1-7): " << RESET;
         
         char choice = singleInput();
         
         switch (choice) {
             case '1': 
                 loadingScreen("Opening Create Order");
-                createOrder(orders, inventory); 
+                createOrder(data); 
                 break;
             case '2': 
                 loadingScreen("Loading Orders");
-                viewOrders(orders); 
+                viewOrders(data.orders.get()); 
                 break;
             case '3': 
                 loadingScreen("Opening Update Order Status");
-                updateOrderStatus(orders); 
+                updateOrderStatus(data); 
                 break;
             case '4': 
+                loadingScreen("Opening Bulk Update Status");
+                bulkUpdateOrderStatus(data); 
+                break;
+            case '5': 
+                loadingScreen("Loading Sales Dashboard");
+                viewSalesDashboard(data.analytics.get()); 
+                break;
+            case '6': 
+                loadingScreen("Opening Reports");
+                viewReports(data.orders.get(), data.inventory.get()); 
+                break;
+            case '7': 
                 loadingScreen("Returning to Main Menu");
                 return;
             default:
@@ -1072,6 +1854,7 @@ void handleOrderMenu(vector<Order>& orders, vector<Product>& inventory) {
 }
 
 void handleStaffMenu(vector<Staff>& staffList, const Staff& currentUser) {
+    TRACE_SCOPE("handleStaffMenu");
     while (true) {
         displayMenuHeader("STAFF MANAGEMENT");
         
@@ -1112,7 +1895,8 @@ void handleStaffMenu(vector<Staff>& staffList, const Staff& currentUser) {
     }
 }
 
-void handleSupplierDashboard(Supplier& currentSupplier, vector<Product>& inventory) {
+void handleSupplierDashboard(Supplier& currentSupplier, Workspace& data) {
+    TRACE_SCOPE("handleSupplierDashboard");
     while (true) {
         displayMenuHeader("SUPPLIER DASHBOARD");
         
@@ -1139,7 +1923,7 @@ void handleSupplierDashboard(Supplier& currentSupplier, vector<Product>& invento
                 break;
             case '3': 
                 loadingScreen("Loading Products");
-                viewSupplierProducts(inventory); 
+                viewSupplierProducts(data.inventory.get(), data.views.get()); 
                 break;
             case '4': 
                 logout();
@@ -1151,7 +1935,130 @@ void handleSupplierDashboard(Supplier& currentSupplier, vector<Product>& invento
 }
 
 // Main function
-int main() {
+int main(int argc, char* argv[]) {
+    // Buffer terminal output before anything is printed
+    initTerminal();
+    
+    // --metrics-file <path>: write the metrics in Prometheus format on exit
+    // --trace-file <path>: record a Chrome trace_event timeline, written on exit
+    // --storage csv|sqlite|lsm: keep records in the CSV files (default), in
+    //     a SQLite database (wms.db) or in LSM stores (under wms_lsm/);
+    //     --database <path> names another database file or directory
+    // --order-cache-mb <n>: memory for orders kept decoded by ID (default 64)
+    // --import-catalog <path>: bulk import a supplier catalog and exit
+    // --export-orders <path> [--from YYYY-MM-DD] [--to YYYY-MM-DD]: write the
+    //     orders joined with their items (JSON Lines for .jsonl, else CSV) and exit
+    // --event-log <dir>: also record every stock change, new order and status
+    //     change in an append-only event log under <dir>
+    // --as-of YYYY-MM-DD: with --event-log, print stock and order statuses as
+    //     they stood at the end of that day (UTC) and exit
+    string storage = "csv";
+    size_t orderCacheBytes = ORDER_CACHE_BYTES;
+    string databaseFile;
+    string catalogFile;
+    string exportFile;
+    time_t exportFrom = numeric_limits<time_t>::min();
+    time_t exportTo = numeric_limits<time_t>::max();
+    string eventLogDirectory;
+    string asOfDate;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--metrics-file" && i + 1 < argc) {
+            Metrics::exportOnExit(argv[++i]);
+        } else if (string(argv[i]) == "--trace-file" && i + 1 < argc) {
+            Tracer::start(argv[++i]);
+        } else if (string(argv[i]) == "--storage" && i + 1 < argc) {
+            storage = argv[++i];
+        } else if (string(argv[i]) == "--database" && i + 1 < argc) {
+            databaseFile = argv[++i];
+        } else if (string(argv[i]) == "--order-cache-mb" && i + 1 < argc) {
+            orderCacheBytes = static_cast<size_t>(max(atol(argv[++i]), 1L)) << 20;
+        } else if (string(argv[i]) == "--import-catalog" && i + 1 < argc) {
+            catalogFile = argv[++i];
+        } else if (string(argv[i]) == "--export-orders" && i + 1 < argc) {
+            exportFile = argv[++i];
+        } else if (string(argv[i]) == "--event-log" && i + 1 < argc) {
+            eventLogDirectory = argv[++i];
+        } else if (string(argv[i]) == "--as-of" && i + 1 < argc) {
+            asOfDate = argv[++i];
+        } else if ((string(argv[i]) == "--from" || string(argv[i]) == "--to") && i + 1 < argc) {
+            bool isFrom = string(argv[i]) == "--from";
+            time_t day;
+            if (!OrderExport::parseDate(argv[++i], day)) {
+                cerr << "Invalid date '" << argv[i] << "' (expected YYYY-MM-DD)\n";
+                return 1;
+            }
+            // --to includes the whole day
+            if (isFrom) exportFrom = day;
+            else exportTo = day + 86400;
+        }
+    }
+    
+    if (storage == "sqlite") {
+        if (!Storage::use(STORAGE_SQLITE, databaseFile.empty() ? DATABASE_FILE : databaseFile)) return 1;
+    } else if (storage == "lsm") {
+        if (!Storage::use(STORAGE_LSM, databaseFile.empty() ? LSM_DIRECTORY : databaseFile)) return 1;
+    } else if (storage != "csv") {
+        cerr << "Unknown storage '" << storage << "' (expected csv, sqlite or lsm)\n";
+        return 1;
+    }
+    bindIdSequences();
+    
+    if (!exportFile.empty()) {
+        if (Storage::current() != STORAGE_CSV) {
+            cerr << "--export-orders streams the CSV files and cannot be combined with --storage sqlite or lsm\n";
+            return 1;
+        }
+        ExportStats stats = OrderExport::run(ORDERS_FILE, ORDER_ITEMS_FILE, exportFile,
+                                             OrderExport::formatForFile(exportFile), exportFrom, exportTo);
+        if (!stats.opened || !stats.written) {
+            cerr << "Export failed: unable to " << (stats.opened ? "write " + exportFile : "open the order files") << "\n";
+            return 1;
+        }
+        cout << "Exported " << stats.ordersExported << " of " << stats.ordersScanned << " orders ("
+             << stats.itemsExported << " items) in " << fixed << setprecision(2) << stats.seconds << " s\n";
+        if (stats.unmatchedItems > 0) {
+            cerr << "Warning: " << stats.unmatchedItems << " items did not follow their order in "
+                 << ORDER_ITEMS_FILE << " and were not exported\n";
+        }
+        return 0;
+    }
+    
+    if (!asOfDate.empty()) {
+        time_t day;
+        if (!OrderExport::parseDate(asOfDate, day)) {
+            cerr << "Invalid date '" << asOfDate << "' (expected YYYY-MM-DD)\n";
+            return 1;
+        }
+        if (eventLogDirectory.empty()) {
+            cerr << "--as-of reads the event log and needs --event-log <dir>\n";
+            return 1;
+        }
+        EventLog events;
+        if (!events.open(eventLogDirectory)) {
+            cerr << "Unable to open the event log in " << eventLogDirectory << "\n";
+            return 1;
+        }
+        return showStateAsOf(events, day + 86399, asOfDate + " 23:59:59 UTC") ? 0 : 1;
+    }
+    
+    if (!catalogFile.empty()) {
+        EventLog events;
+        if (!eventLogDirectory.empty() && !events.open(eventLogDirectory)) {
+            cerr << "Unable to open the event log in " << eventLogDirectory << "\n";
+            return 1;
+        }
+        vector<Product> inventory = Product::loadAllFromFile(PRODUCTS_FILE);
+        events.reconcileStock(inventory);
+        ImportStats stats = CatalogImport::run(catalogFile, inventory, PRODUCTS_FILE);
+        if (!stats.opened || !stats.saved) {
+            cerr << "Import failed: unable to " << (stats.opened ? "write " + PRODUCTS_FILE : "open " + catalogFile) << "\n";
+            return 1;
+        }
+        events.reconcileStock(inventory);
+        showImportSummary(stats);
+        return 0;
+    }
+    
     // Seed random number generator
     srand(time(nullptr));
     
@@ -1163,28 +2070,36 @@ int main() {
     createDefaultSupplier(SUPPLIERS_FILE);
     
     // Create data files if they don't exist
-    ofstream productsFile(PRODUCTS_FILE, ios::app);
-    productsFile.close();
-    
-    ofstream suppliersFile(SUPPLIERS_FILE, ios::app);
-    suppliersFile.close();
-    
-    ofstream ordersFile(ORDERS_FILE, ios::app);
-    ordersFile.close();
-    
-    ofstream orderItemsFile(ORDER_ITEMS_FILE, ios::app);
-    orderItemsFile.close();
+    if (Storage::current() == STORAGE_CSV) {
+        TRACE_SCOPE("startup: create data files");
+        ofstream productsFile(PRODUCTS_FILE, ios::app);
+        productsFile.close();
+        
+        ofstream suppliersFile(SUPPLIERS_FILE, ios::app);
+        suppliersFile.close();
+        
+        ofstream ordersFile(ORDERS_FILE, ios::app);
+        ordersFile.close();
+        
+        ofstream orderItemsFile(ORDER_ITEMS_FILE, ios::app);
+        orderItemsFile.close();
+    }
     
     Staff currentUser;
     Supplier currentSupplier;
     bool isStaffLoggedIn = false;
     bool isSupplierLoggedIn = false;
     
-    // Load data
-    vector<Product> inventory = Product::loadAllFromFile(PRODUCTS_FILE);
-    vector<Supplier> suppliers = Supplier::loadAllFromFile(SUPPLIERS_FILE);
-    vector<Order> orders = Order::loadAllFromFile(ORDERS_FILE, ORDER_ITEMS_FILE);
-    vector<Staff> staffList = Staff::loadAllFromFile(STAFF_FILE);
+    Workspace data(orderCacheBytes);
+    if (!eventLogDirectory.empty()) {
+        if (!data.events.open(eventLogDirectory)) {
+            cerr << "Unable to open the event log in " << eventLogDirectory << "\n";
+            return 1;
+        }
+        // Orders created or changed while the log was not open
+        data.events.reconcileOrders(data.orderStore);
+    }
+    startFulfillment(data);
     
     while (true) {
         if (!isStaffLoggedIn && !isSupplierLoggedIn) {
@@ -1221,7 +2136,7 @@ int main() {
             }
         } else if (isSupplierLoggedIn) {
             // Supplier is logged in
-            handleSupplierDashboard(currentSupplier, inventory);
+            handleSupplierDashboard(currentSupplier, data);
             isSupplierLoggedIn = false;
         } else {
             // Staff is logged in
@@ -1236,35 +2151,39 @@ int main() {
                 cout << "│ " << YELLOW << "2. Supplier Management" << RESET << "                │\n";
                 cout << "│ " << YELLOW << "3. Order Management" << RESET << "                   │\n";
                 cout << "│ " << YELLOW << "4. Staff Management" << RESET << "                   │\n";
-                cout << "│ " << YELLOW << "5. Logout" << RESET << "                             │\n";
-                cout << "│ " << YELLOW << "6. Exit" << RESET << "                               │\n";
+                cout << "│ " << YELLOW << "5. System Metrics" << RESET << "                     │\n";
+                cout << "│ " << YELLOW << "6. Logout" << RESET << "                             │\n";
+                cout << "│ " << YELLOW << "7. Exit" << RESET << "                               │\n";
                 cout << CYAN << "└─────────────────────────────────────────┘\n";
-                cout << CYAN << "Select an option (1-6): " << RESET;
+                cout << CYAN << "Select an option (1-7): " << RESET;
                 
                 char choice = singleInput();
                 
                 switch (choice) {
                     case '1': 
                         loadingScreen("Opening Product Management");
-                        handleProductMenu(inventory); 
+                        handleProductMenu(data); 
                         break;
                     case '2': 
                         loadingScreen("Opening Supplier Management");
-                        handleSupplierMenu(suppliers, currentUser); 
+                        handleSupplierMenu(data.suppliers.get(), currentUser); 
                         break;
                     case '3': 
                         loadingScreen("Opening Order Management");
-                        handleOrderMenu(orders, inventory); 
+                        handleOrderMenu(data); 
                         break;
                     case '4': 
                         loadingScreen("Opening Staff Management");
-                        handleStaffMenu(staffList, currentUser); 
+                        handleStaffMenu(data.staffList.get(), currentUser); 
                         break;
-                    case '5': 
+                    case '5':
+                        viewMetrics();
+                        break;
+                    case '6': 
                         logout();
                         isStaffLoggedIn = false;
                         break;
-                    case '6':
+                    case '7':
                         loadingScreen("Exiting System");
                         showSuccess("Thank you for using the system!");
                         return 0;
@@ -1290,15 +2209,15 @@ int main() {
                 switch (choice) {
                     case '1': 
                         loadingScreen("Opening Product Management");
-                        handleProductMenu(inventory); 
+                        handleProductMenu(data); 
                         break;
                     case '2': 
                         loadingScreen("Opening Supplier Management");
-                        handleSupplierMenu(suppliers, currentUser); 
+                        handleSupplierMenu(data.suppliers.get(), currentUser); 
                         break;
                     case '3': 
                         loadingScreen("Opening Order Management");
-                        handleOrderMenu(orders, inventory); 
+                        handleOrderMenu(data); 
                         break;
                     case '4': 
                         logout();
@@ -1331,19 +2250,19 @@ int main() {
                 switch (choice) {
                     case '1': 
                         loadingScreen("Loading Products");
-                        viewProducts(inventory); 
+                        viewProducts(data.inventory.get(), data.views.get()); 
                         break;
                     case '2': 
                         loadingScreen("Opening Search Product");
-                        searchProduct(inventory); 
+                        searchProduct(data.inventory); 
                         break;
                     case '3': 
                         loadingScreen("Loading Orders");
-                        viewOrders(orders); 
+                        viewOrders(data.orders.get()); 
                         break;
                     case '4': 
                         loadingScreen("Opening Create Order");
-                        createOrder(orders, inventory); 
+                        createOrder(data); 
                         break;
                     case '5': 
                         logout();
@@ -0,0 +1,291 @@
+#include "metrics.h"
+#include "trace.h"
+
+#include <fstream>
+#include <mutex>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+// One block of cells per live thread. Only the owning thread writes to it;
+// readers sum every block under the registry lock.
+struct ThreadCells {
+    atomic<uint64_t> counters[MAX_COUNTERS];
+    atomic<uint64_t> histogramCount[MAX_HISTOGRAMS];
+    atomic<uint64_t> histogramSum[MAX_HISTOGRAMS];
+    atomic<uint64_t> buckets[MAX_HISTOGRAMS][HISTOGRAM_BUCKETS];
+};
+
+struct Registry {
+    mutex lock;
+    vector<MetricInfo> counters;
+    vector<MetricInfo> histograms;
+    vector<ThreadCells*> live;
+    vector<ThreadCells*> pool;  // blocks of exited threads, zeroed for reuse
+    ThreadCells retired;        // totals folded in from exited threads
+};
+
+// Never destroyed, so metrics recorded during shutdown stay valid
+static Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+static void add(atomic<uint64_t>& cell, uint64_t amount) {
+    cell.store(cell.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+static void forEachCell(ThreadCells& cells, void (*apply)(atomic<uint64_t>&, atomic<uint64_t>&), ThreadCells& other) {
+    for (size_t i = 0; i < MAX_COUNTERS; ++i) apply(cells.counters[i], other.counters[i]);
+    for (size_t h = 0; h < MAX_HISTOGRAMS; ++h) {
+        apply(cells.histogramCount[h], other.histogramCount[h]);
+        apply(cells.histogramSum[h], other.histogramSum[h]);
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b) apply(cells.buckets[h][b], other.buckets[h][b]);
+    }
+}
+
+// Folds the thread's cells into the retired totals when the thread exits
+class ThreadCellsHandle {
+public:
+    ThreadCells* cells;
+
+    ThreadCellsHandle() {
+        Registry& reg = registry();
+        lock_guard<mutex> guard(reg.lock);
+        if (reg.pool.empty()) {
+            cells = new ThreadCells();
+        } else {
+            cells = reg.pool.back();
+            reg.pool.pop_back();
+        }
+        reg.live.push_back(cells);
+    }
+
+    ~ThreadCellsHandle() {
+        Registry& reg = registry();
+        lock_guard<mutex> guard(reg.lock);
+        forEachCell(reg.retired, [](atomic<uint64_t>& into, atomic<uint64_t>& from) {
+            add(into, from.load(memory_order_relaxed));
+            from.store(0, memory_order_relaxed);
+        }, *cells);
+        for (size_t i = 0; i < reg.live.size(); ++i) {
+            if (reg.live[i] == cells) {
+                reg.live.erase(reg.live.begin() + i);
+                break;
+            }
+        }
+        reg.pool.push_back(cells);
+    }
+};
+
+static ThreadCells& localCells() {
+    thread_local ThreadCellsHandle handle;
+    return *handle.cells;
+}
+
+static size_t registerMetric(vector<MetricInfo>& list, size_t capacity, const char* name, const char* help, const char* labels) {
+    Registry& reg = registry();
+    lock_guard<mutex> guard(reg.lock);
+    for (size_t i = 0; i < list.size(); ++i) {
+        if (list[i].name == name && list[i].labels == labels) return i;
+    }
+    if (list.size() >= capacity) {
+        cerr << "metrics: too many metrics, dropping " << name << "\n";
+        return capacity;
+    }
+    list.push_back({name, labels, help});
+    return list.size() - 1;
+}
+
+// ========== Counter / Histogram ==========
+Counter::Counter(const char* name, const char* help, const char* labels) {
+    id = registerMetric(registry().counters, MAX_COUNTERS, name, help, labels);
+}
+
+void Counter::increment(uint64_t amount) {
+    if (id >= MAX_COUNTERS) return;
+    add(localCells().counters[id], amount);
+}
+
+Histogram::Histogram(const char* name, const char* help, const char* labels) {
+    id = registerMetric(registry().histograms, MAX_HISTOGRAMS, name, help, labels);
+}
+
+void Histogram::record(uint64_t nanoseconds) {
+    if (id >= MAX_HISTOGRAMS) return;
+    ThreadCells& cells = localCells();
+    add(cells.buckets[id][bucketIndex(nanoseconds)], 1);
+    add(cells.histogramCount[id], 1);
+    add(cells.histogramSum[id], nanoseconds);
+}
+
+size_t Histogram::bucketIndex(uint64_t value) {
+    if (value < HISTOGRAM_SUB_BUCKETS) return value;
+#if defined(__GNUC__) || defined(__clang__)
+    size_t exponent = 63 - __builtin_clzll(value);
+#else
+    size_t exponent = 0;
+    while (value >> (exponent + 1)) ++exponent;
+#endif
+    size_t sub = (value >> (exponent - 2)) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return HISTOGRAM_SUB_BUCKETS + (exponent - 2) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+uint64_t Histogram::bucketUpperBound(size_t index) {
+    if (index < HISTOGRAM_SUB_BUCKETS) return index;
+    size_t exponent = (index - HISTOGRAM_SUB_BUCKETS) / HISTOGRAM_SUB_BUCKETS + 2;
+    size_t sub = (index - HISTOGRAM_SUB_BUCKETS) % HISTOGRAM_SUB_BUCKETS;
+    return ((HISTOGRAM_SUB_BUCKETS + sub + 1) << (exponent - 2)) - 1;
+}
+
+uint64_t HistogramSnapshot::quantile(double q) const {
+    if (count == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(q * count);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < buckets.size(); ++b) {
+        seen += buckets[b];
+        if (seen >= rank) return Histogram::bucketUpperBound(b);
+    }
+    return Histogram::bucketUpperBound(buckets.size() - 1);
+}
+
+// ========== Aggregation and export ==========
+const vector<MetricInfo>& Metrics::counters() {
+    return registry().counters;
+}
+
+const vector<MetricInfo>& Metrics::histograms() {
+    return registry().histograms;
+}
+
+uint64_t Metrics::counterValue(size_t id) {
+    if (id >= MAX_COUNTERS) return 0;
+    Registry& reg = registry();
+    lock_guard<mutex> guard(reg.lock);
+    uint64_t total = reg.retired.counters[id].load(memory_order_relaxed);
+    for (ThreadCells* cells : reg.live) total += cells->counters[id].load(memory_order_relaxed);
+    return total;
+}
+
+HistogramSnapshot Metrics::histogramSnapshot(size_t id) {
+    HistogramSnapshot snapshot{0, 0, vector<uint64_t>(HISTOGRAM_BUCKETS, 0)};
+    if (id >= MAX_HISTOGRAMS) return snapshot;
+
+    Registry& reg = registry();
+    lock_guard<mutex> guard(reg.lock);
+    vector<ThreadCells*> blocks = reg.live;
+    blocks.push_back(&reg.retired);
+    for (ThreadCells* cells : blocks) {
+        snapshot.count += cells->histogramCount[id].load(memory_order_relaxed);
+        snapshot.sum += cells->histogramSum[id].load(memory_order_relaxed);
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+            snapshot.buckets[b] += cells->buckets[id][b].load(memory_order_relaxed);
+        }
+    }
+    return snapshot;
+}
+
+static string seriesName(const string& name, const string& labels, const string& extraLabel = "") {
+    string series = name;
+    if (labels.empty() && extraLabel.empty()) return series;
+    series += "{";
+    series += labels;
+    if (!labels.empty() && !extraLabel.empty()) series += ",";
+    series += extraLabel;
+    series += "}";
+    return series;
+}
+
+static string formatSeconds(uint64_t nanoseconds) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.9g", nanoseconds / 1e9);
+    return buffer;
+}
+
+static vector<size_t> orderByName(const vector<MetricInfo>& list) {
+    vector<size_t> order(list.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&list](size_t a, size_t b) { return list[a].name < list[b].name; });
+    return order;
+}
+
+void Metrics::writePrometheus(ostream& out) {
+    vector<MetricInfo> counterList, histogramList;
+    {
+        Registry& reg = registry();
+        lock_guard<mutex> guard(reg.lock);
+        counterList = reg.counters;
+        histogramList = reg.histograms;
+    }
+
+    // Series of one metric must be contiguous, under a single HELP/TYPE
+    vector<size_t> counterOrder = orderByName(counterList);
+    vector<size_t> histogramOrder = orderByName(histogramList);
+
+    string lastName;
+    for (size_t i : counterOrder) {
+        const MetricInfo& info = counterList[i];
+        if (info.name != lastName) {
+            out << "# HELP " << info.name << " " << info.help << "\n";
+            out << "# TYPE " << info.name << " counter\n";
+            lastName = info.name;
+        }
+        out << seriesName(info.name, info.labels) << " " << counterValue(i) << "\n";
+    }
+
+    lastName.clear();
+    for (size_t i : histogramOrder) {
+        const MetricInfo& info = histogramList[i];
+        if (info.name != lastName) {
+            out << "# HELP " << info.name << " " << info.help << "\n";
+            out << "# TYPE " << info.name << " histogram\n";
+            lastName = info.name;
+        }
+        HistogramSnapshot snapshot = histogramSnapshot(i);
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b < snapshot.buckets.size(); ++b) {
+            if (snapshot.buckets[b] == 0) continue;
+            cumulative += snapshot.buckets[b];
+            string le = "le=\"" + formatSeconds(Histogram::bucketUpperBound(b)) + "\"";
+            out << seriesName(info.name + "_bucket", info.labels, le) << " " << cumulative << "\n";
+        }
+        out << seriesName(info.name + "_bucket", info.labels, "le=\"+Inf\"") << " " << snapshot.count << "\n";
+        out << seriesName(info.name + "_sum", info.labels) << " " << formatSeconds(snapshot.sum) << "\n";
+        out << seriesName(info.name + "_count", info.labels) << " " << snapshot.count << "\n";
+    }
+}
+
+bool Metrics::saveToFile(const string& filename) {
+    TRACE_SCOPE("Metrics::saveToFile");
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    writePrometheus(file);
+    return true;
+}
+
+static string exitExportPath;
+
+static void exportAtExit() {
+    if (!Metrics::saveToFile(exitExportPath)) {
+        cerr << "metrics: unable to write " << exitExportPath << "\n";
+    }
+}
+
+void Metrics::exportOnExit(const string& filename) {
+    registry();
+    if (exitExportPath.empty()) atexit(exportAtExit);
+    exitExportPath = filename;
+}
+
+void Metrics::reset() {
+    Registry& reg = registry();
+    lock_guard<mutex> guard(reg.lock);
+    vector<ThreadCells*> blocks = reg.live;
+    blocks.push_back(&reg.retired);
+    for (ThreadCells* cells : blocks) {
+        forEachCell(*cells, [](atomic<uint64_t>& cell, atomic<uint64_t>&) {
+            cell.store(0, memory_order_relaxed);
+        }, *cells);
+    }
+}
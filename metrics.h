@@ -0,0 +1,106 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+// Process-wide counters and latency histograms for the hot paths.
+//
+// Every thread records into its own block of cells, so an update is a plain
+// relaxed load/store on memory no other thread writes. The registry sums
+// the blocks of all threads when a snapshot or export is requested.
+// Metrics are declared as function-local statics at the call site:
+//
+//     static Histogram loadTime("wms_load_seconds", "Time to load a data file", "entity=\"product\"");
+//     ScopedTimer timer(loadTime);
+
+const size_t MAX_COUNTERS = 64;
+const size_t MAX_HISTOGRAMS = 32;
+
+// Log-linear buckets: exact below 4, then 4 linear steps per power of two,
+// which keeps the relative error of any quantile under 25%.
+const size_t HISTOGRAM_SUB_BUCKETS = 4;
+const size_t HISTOGRAM_BUCKETS = 4 + 62 * HISTOGRAM_SUB_BUCKETS;
+
+struct MetricInfo {
+    string name;
+    string labels;  // Prometheus label list without braces, e.g. entity="order"
+    string help;
+};
+
+struct HistogramSnapshot {
+    uint64_t count;
+    uint64_t sum;  // nanoseconds
+    vector<uint64_t> buckets;
+
+    // Upper bound in nanoseconds of the bucket holding quantile q (0..1)
+    uint64_t quantile(double q) const;
+};
+
+class Counter {
+private:
+    size_t id;
+
+public:
+    Counter(const char* name, const char* help, const char* labels = "");
+
+    void increment(uint64_t amount = 1);
+    size_t getID() const { return id; }
+};
+
+class Histogram {
+private:
+    size_t id;
+
+public:
+    Histogram(const char* name, const char* help, const char* labels = "");
+
+    // Record one observation in nanoseconds
+    void record(uint64_t nanoseconds);
+    size_t getID() const { return id; }
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(size_t index);
+};
+
+// Records the lifetime of the scope into a histogram
+class ScopedTimer {
+private:
+    Histogram& histogram;
+    chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(Histogram& target) : histogram(target), start(chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        histogram.record(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    }
+};
+
+class Metrics {
+public:
+    static const vector<MetricInfo>& counters();
+    static const vector<MetricInfo>& histograms();
+
+    // Totals across every thread that has recorded so far
+    static uint64_t counterValue(size_t id);
+    static HistogramSnapshot histogramSnapshot(size_t id);
+
+    // Prometheus text exposition format
+    static void writePrometheus(ostream& out);
+    static bool saveToFile(const string& filename);
+
+    // Write the metrics to `filename` when the process exits
+    static void exportOnExit(const string& filename);
+
+    // Zero every counter and histogram
+    static void reset();
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+using namespace std;
+
+// Lock-free ring buffer for many producers and one consumer. Each slot
+// carries a sequence number saying whose turn it is: producers claim a
+// position with one compare-and-swap on the tail and publish the slot by
+// bumping its sequence, and the consumer reads slots in order without any
+// atomic read-modify-write. Fixed capacity: tryPush() fails when full and
+// the caller decides whether to wait.
+template <typename T>
+class MpscQueue {
+private:
+    struct Slot {
+        atomic<size_t> sequence;
+        T value;
+    };
+
+    unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) atomic<size_t> tail;  // next position to claim; producers
+    alignas(64) size_t head;          // next position to read; consumer only
+
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        return size;
+    }
+
+public:
+    // `capacity` is rounded up to a power of two
+    explicit MpscQueue(size_t capacity) : slots(new Slot[roundUp(capacity)]), mask(roundUp(capacity) - 1), tail(0), head(0) {
+        for (size_t i = 0; i <= mask; ++i) slots[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread; false if the queue is full
+    bool tryPush(T item) {
+        size_t position = tail.load(memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(memory_order_acquire);
+            intptr_t lag = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (lag == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                    slot.value = move(item);
+                    slot.sequence.store(position + 1, memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;  // the consumer has not freed this slot yet
+            } else {
+                position = tail.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only; false if nothing is ready
+    bool tryPop(T& item) {
+        Slot& slot = slots[head & mask];
+        if (slot.sequence.load(memory_order_acquire) != head + 1) return false;
+        item = move(slot.value);
+        slot.sequence.store(head + mask + 1, memory_order_release);
+        ++head;
+        return true;
+    }
+
+    // Consumer thread only
+    bool empty() const {
+        return slots[head & mask].sequence.load(memory_order_acquire) != head + 1;
+    }
+
+    size_t capacity() const { return mask + 1; }
+};
+
+#endif
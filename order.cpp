@@ -0,0 +1,183 @@
+#include "order.h"
+
+#include "storage.h"
+#include "metrics.h"
+#include "trace.h"
+#include <cstdio>
+#include <algorithm>
+
+IdSequence Order::ids;
+
+Order::Order() {
+    orderID = 0;
+    customerID = 0;
+    customerName = "";
+    totalAmount = 0.0f;
+    orderDate = time(nullptr);
+    status = ORDER_PENDING;
+}
+
+Order::Order(int custID, string custName) {
+    orderID = ids.next();
+    customerID = custID;
+    customerName = custName;
+    totalAmount = 0.0f;
+    orderDate = time(nullptr);
+    status = ORDER_PENDING;
+}
+
+void Order::addItem(const Product& product, int quantity, int warehouseID) {
+    OrderItem item;
+    item.orderID = orderID;
+    item.productID = product.getID();
+    item.productName = product.getName();
+    item.price = product.getPrice();
+    item.quantity = quantity;
+    item.subtotal = item.price * quantity;
+    item.warehouseID = warehouseID;
+    
+    items.push_back(item);
+    totalAmount += item.subtotal;
+}
+
+bool Order::removeItem(int productID) {
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (items[i].productID == productID) {
+            totalAmount -= items[i].subtotal;
+            items.erase(items.begin() + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+string Order::statusToString(OrderStatus status) {
+    switch (status) {
+        case ORDER_PENDING: return "Pending";
+        case ORDER_PROCESSING: return "Processing";
+        case ORDER_SHIPPED: return "Shipped";
+        case ORDER_DELIVERED: return "Delivered";
+        case ORDER_CANCELLED: return "Cancelled";
+        default: return "Unknown";
+    }
+}
+
+string Order::getFormattedDate() const {
+    char buffer[26];
+    struct tm* timeinfo = localtime(&orderDate);
+    strftime(buffer, 26, "%Y-%m-%d %H:%M:%S", timeinfo);
+    return string(buffer);
+}
+
+void Order::appendTo(string& out) const {
+    char line[96];
+    int length;
+    
+    out += BOX_TOP;
+    appendBoxField(out, "Order ID: ", orderID);
+    appendBoxField(out, "Customer ID: ", customerID);
+    appendBoxField(out, "Customer Name: ", customerName);
+    length = strftime(line, sizeof(line), "%Y-%m-%d %H:%M:%S", localtime(&orderDate));
+    appendBoxField(out, "Order Date: ", line, length);
+    appendBoxField(out, "Status: ", statusToString(status));
+    appendBoxField(out, "Items:", "", 0);
+    
+    for (const auto& item : items) {
+        length = snprintf(line, sizeof(line), "  - %s (ID: %d)", item.productName.c_str(), item.productID);
+        appendBoxLine(out, line, min<size_t>(length, sizeof(line) - 1));
+        
+        length = snprintf(line, sizeof(line), "    Price: $%.2f x %d = $%.2f", item.price, item.quantity, item.subtotal);
+        appendBoxLine(out, line, min<size_t>(length, sizeof(line) - 1));
+    }
+    
+    length = snprintf(line, sizeof(line), "$%.2f", totalAmount);
+    appendBoxField(out, "Total Amount: ", line, length);
+    out += BOX_BOTTOM;
+}
+
+void Order::display() const {
+    string out;
+    appendTo(out);
+    cout << out;
+}
+
+void Order::writeRow(ostream& out) const {
+    Repository<Order>::serialize(out, *this);
+}
+
+void Order::saveToFile(const string& filename, const string& itemsFilename) const {
+    TRACE_SCOPE("Order::saveToFile");
+    static Counter rowsWritten("wms_rows_written_total", "Records written by saves and rewrites", "entity=\"order\"");
+    rowsWritten.increment();
+    
+    if (!Storage::open<Order>(filename)->append(*this)) {
+        cout << "Unable to open file for writing\n";
+        return;
+    }
+    if (!Storage::open<OrderItem>(itemsFilename)->appendAll(items)) {
+        cout << "Unable to open items file for writing\n";
+    }
+}
+
+void Order::saveAllToFile(const string& filename, const vector<Order>& orders) {
+    TRACE_SCOPE("Order::saveAllToFile");
+    static Histogram rewriteTime("wms_rewrite_seconds", "Time to rewrite a data file", "entity=\"order\"");
+    static Counter rowsWritten("wms_rows_written_total", "Records written by saves and rewrites", "entity=\"order\"");
+    ScopedTimer timer(rewriteTime);
+    
+    if (!Storage::open<Order>(filename)->saveAll(orders)) {
+        cout << "Unable to open file for writing\n";
+        return;
+    }
+    rowsWritten.increment(orders.size());
+}
+
+bool Order::updateInFile(const string& filename, const Order& order) {
+    TRACE_SCOPE("Order::updateInFile");
+    static Histogram updateTime("wms_update_seconds", "Time to update one record in place", "entity=\"order\"");
+    ScopedTimer timer(updateTime);
+    
+    if (!Storage::open<Order>(filename)->update(order)) {
+        cout << "Unable to update order " << order.orderID << "\n";
+        return false;
+    }
+    return true;
+}
+
+Order Order::loadFromFile(const string& filename, const string& itemsFilename, int id) {
+    TRACE_SCOPE("Order::loadFromFile");
+    Order order;
+    if (!findInFile(filename, itemsFilename, id, order)) return Order();
+    return order;
+}
+
+bool Order::findInFile(const string& filename, const string& itemsFilename, int id, Order& order) {
+    if (!Storage::open<Order>(filename)->findByKey(id, order)) return false;
+    
+    order.items.clear();
+    Storage::open<OrderItem>(itemsFilename)->scanWhere("orderID", order.orderID, [&order](OrderItem& item) {
+        order.items.push_back(move(item));
+        return true;
+    });
+    return true;
+}
+
+vector<Order> Order::loadAllFromFile(const string& filename, const string& itemsFilename) {
+    TRACE_SCOPE("Order::loadAllFromFile");
+    static Histogram loadTime("wms_load_seconds", "Time to load a data file", "entity=\"order\"");
+    static Counter rowsLoaded("wms_rows_loaded_total", "Records parsed by the loaders", "entity=\"order\"");
+    ScopedTimer timer(loadTime);
+    
+    vector<Order> orders = Storage::open<Order>(filename)->loadAll();
+    
+    // Attach items through an ID index instead of scanning the orders per item
+    unordered_map<int, size_t> position = Repository<Order>::buildIndex(orders);
+    Storage::open<OrderItem>(itemsFilename)->scan([&](OrderItem& item) {
+        auto found = position.find(item.orderID);
+        if (found != position.end()) orders[found->second].items.push_back(move(item));
+        return true;
+    });
+    
+    rowsLoaded.increment(orders.size());
+    return orders;
+}
@@ -3,12 +3,12 @@
 
 #include <iostream>
 #include <string>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <ctime>
 #include "product.h"
 #include "utils.h"
+#include "repository.h"
+#include "id_sequence.h"
 
 using namespace std;
 
@@ -21,16 +21,21 @@ enum OrderStatus {
 };
 
 struct OrderItem {
+    int orderID;
     int productID;
     string productName;
     float price;
     int quantity;
     float subtotal;
+    // Where the units were taken from; 0 on items from before warehouses
+    int warehouseID;
 };
 
 class Order {
 private:
-    static int nextID;
+    friend struct EntityTraits<Order>;
+    friend class OrderStore;
+
     int orderID;
     int customerID;
     string customerName;
@@ -40,23 +45,12 @@ private:
     OrderStatus status;
 
 public:
-    Order() {
-        orderID = nextID++;
-        customerID = 0;
-        customerName = "";
-        totalAmount = 0.0f;
-        orderDate = time(nullptr);
-        status = ORDER_PENDING;
-    }
+    // Where new records get their IDs; see IdSequence
+    static IdSequence ids;
 
-    Order(int custID, string custName) {
-        orderID = nextID++;
-        customerID = custID;
-        customerName = custName;
-        totalAmount = 0.0f;
-        orderDate = time(nullptr);
-        status = ORDER_PENDING;
-    }
+    // A blank record with ID 0, for loaders to fill in
+    Order();
+    Order(int custID, string custName);
 
     int getID() const { return orderID; }
     int getCustomerID() const { return customerID; }
@@ -64,242 +58,69 @@ public:
     float getTotalAmount() const { return totalAmount; }
     time_t getOrderDate() const { return orderDate; }
     OrderStatus getStatus() const { return status; }
-    vector<OrderItem> getItems() const { return items; }
+    const vector<OrderItem>& getItems() const { return items; }
 
     void setCustomerID(int id) { customerID = id; }
     void setCustomerName(const string& name) { customerName = name; }
     void setStatus(OrderStatus newStatus) { status = newStatus; }
 
-    void addItem(const Product& product, int quantity) {
-        OrderItem item;
-        item.productID = product.getID();
-        item.productName = product.getName();
-        item.price = product.getPrice();
-        item.quantity = quantity;
-        item.subtotal = item.price * quantity;
-        
-        items.push_back(item);
-        totalAmount += item.subtotal;
-    }
-
-    bool removeItem(int productID) {
-        for (size_t i = 0; i < items.size(); ++i) {
-            if (items[i].productID == productID) {
-                totalAmount -= items[i].subtotal;
-                items.erase(items.begin() + i);
-                return true;
-            }
-        }
-        return false;
-    }
+    void addItem(const Product& product, int quantity, int warehouseID = 0);
+    bool removeItem(int productID);
 
     string getStatusString() const {
-        switch (status) {
-            case ORDER_PENDING: return "Pending";
-            case ORDER_PROCESSING: return "Processing";
-            case ORDER_SHIPPED: return "Shipped";
-            case ORDER_DELIVERED: return "Delivered";
-            case ORDER_CANCELLED: return "Cancelled";
-            default: return "Unknown";
-        }
+        return statusToString(status);
     }
 
-    string getFormattedDate() const {
-        char buffer[26];
-        struct tm* timeinfo = localtime(&orderDate);
-        strftime(buffer, 26, "%Y-%m-%d %H:%M:%S", timeinfo);
-        return string(buffer);
-    }
+    static string statusToString(OrderStatus status);
 
-    void display() const {
-        cout << "┌─────────────────────────────────────────┐\n";
-        cout << "│ " << CYAN << BOLD << "Order ID: " << RESET << orderID << string(32 - to_string(orderID).length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Customer ID: " << RESET << customerID << string(29 - to_string(customerID).length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Customer Name: " << RESET << customerName << string(27 - customerName.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Order Date: " << RESET << getFormattedDate() << string(30 - getFormattedDate().length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Status: " << RESET << getStatusString() << string(34 - getStatusString().length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Items:" << RESET << "                                │\n";
-        
-        for (const auto& item : items) {
-            string itemInfo = "  - " + item.productName + " (ID: " + to_string(item.productID) + ")";
-            cout << "│ " << itemInfo << string(39 - itemInfo.length(), ' ') << "│\n";
-            
-            string priceInfo = "    Price: $" + to_string(item.price) + " x " + to_string(item.quantity) + " = $" + to_string(item.subtotal);
-            cout << "│ " << priceInfo << string(39 - priceInfo.length(), ' ') << "│\n";
-        }
-        
-        string totalInfo = "Total Amount: $" + to_string(totalAmount);
-        cout << "│ " << CYAN << BOLD << totalInfo << RESET << string(39 - totalInfo.length(), ' ') << "│\n";
-        cout << "└─────────────────────────────────────────┘\n";
-    }
+    string getFormattedDate() const;
 
-    void saveToFile(const string& filename) const {
-        ofstream file(filename, ios::app);
-        if (file.is_open()) {
-            file << orderID << "," << customerID << "," << customerName << "," 
-                 << totalAmount << "," << orderDate << "," << status << "\n";
-            file.close();
-        } else {
-            cout << "Unable to open file for writing\n";
-            return;
-        }
-        
-        string itemsFilename = "order_items.txt";
-        ofstream itemsFile(itemsFilename, ios::app);
-        if (itemsFile.is_open()) {
-            for (const auto& item : items) {
-                itemsFile << orderID << "," << item.productID << "," << item.productName << "," 
-                         << item.price << "," << item.quantity << "," << item.subtotal << "\n";
-            }
-            itemsFile.close();
-        } else {
-            cout << "Unable to open items file for writing\n";
-        }
-    }
+    // Render the order card into `out` without intermediate strings
+    void appendTo(string& out) const;
+    void display() const;
 
-    static Order loadFromFile(const string& filename, const string& itemsFilename, int id) {
-        ifstream file(filename);
-        string line;
-        Order order;
-        bool found = false;
-        
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            int fileID;
-            
-            getline(ss, field, ',');
-            fileID = stoi(field);
-            
-            if (fileID == id) {
-                order.orderID = fileID;
-                
-                getline(ss, field, ',');
-                order.customerID = stoi(field);
-                
-                getline(ss, order.customerName, ',');
-                
-                getline(ss, field, ',');
-                order.totalAmount = stof(field);
-                
-                getline(ss, field, ',');
-                order.orderDate = stoll(field);
-                
-                getline(ss, field);
-                order.status = static_cast<OrderStatus>(stoi(field));
-                
-                found = true;
-                break;
-            }
-        }
-        file.close();
-        
-        if (!found) return Order();
-        
-        ifstream itemsFile(itemsFilename);
-        while (getline(itemsFile, line)) {
-            stringstream ss(line);
-            string field;
-            int fileOrderID;
-            
-            getline(ss, field, ',');
-            fileOrderID = stoi(field);
-            
-            if (fileOrderID == id) {
-                OrderItem item;
-                
-                getline(ss, field, ',');
-                item.productID = stoi(field);
-                
-                getline(ss, item.productName, ',');
-                
-                getline(ss, field, ',');
-                item.price = stof(field);
-                
-                getline(ss, field, ',');
-                item.quantity = stoi(field);
-                
-                getline(ss, field);
-                item.subtotal = stof(field);
-                
-                order.items.push_back(item);
-            }
-        }
-        itemsFile.close();
-        
-        return order;
-    }
+    // Write the order header (without items) as one CSV row
+    void writeRow(ostream& out) const;
+    // Append the header to `filename` and the items to `itemsFilename`
+    void saveToFile(const string& filename, const string& itemsFilename) const;
 
-    static vector<Order> loadAllFromFile(const string& filename, const string& itemsFilename) {
-        ifstream file(filename);
-        string line;
-        vector<Order> orders;
-        
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            Order order;
-            
-            getline(ss, field, ',');
-            order.orderID = stoi(field);
-            
-            getline(ss, field, ',');
-            order.customerID = stoi(field);
-            
-            getline(ss, order.customerName, ',');
-            
-            getline(ss, field, ',');
-            order.totalAmount = stof(field);
-            
-            getline(ss, field, ',');
-            order.orderDate = stoll(field);
-            
-            getline(ss, field);
-            order.status = static_cast<OrderStatus>(stoi(field));
-            
-            orders.push_back(order);
-        }
-        file.close();
-        
-        ifstream itemsFile(itemsFilename);
-        while (getline(itemsFile, line)) {
-            stringstream ss(line);
-            string field;
-            int fileOrderID;
-            
-            getline(ss, field, ',');
-            fileOrderID = stoi(field);
-            
-            for (auto& order : orders) {
-                if (order.orderID == fileOrderID) {
-                    OrderItem item;
-                    
-                    getline(ss, field, ',');
-                    item.productID = stoi(field);
-                    
-                    getline(ss, item.productName, ',');
-                    
-                    getline(ss, field, ',');
-                    item.price = stof(field);
-                    
-                    getline(ss, field, ',');
-                    item.quantity = stoi(field);
-                    
-                    getline(ss, field);
-                    item.subtotal = stof(field);
-                    
-                    order.items.push_back(item);
-                    break;
-                }
-            }
-        }
-        itemsFile.close();
-        
-        return orders;
-    }
+    // Rewrite the order header file from `orders`; items are left untouched
+    static void saveAllToFile(const string& filename, const vector<Order>& orders);
+    // Rewrite just this order's header, e.g. after a status change
+    static bool updateInFile(const string& filename, const Order& order);
+
+    static Order loadFromFile(const string& filename, const string& itemsFilename, int id);
+    // The order with `id` and its items; false if there is none
+    static bool findInFile(const string& filename, const string& itemsFilename, int id, Order& order);
+    static vector<Order> loadAllFromFile(const string& filename, const string& itemsFilename);
 };
 
-int Order::nextID = 1;
+template <>
+struct EntityTraits<OrderItem> {
+    static constexpr auto fields = make_tuple(
+        field("orderID", &OrderItem::orderID),
+        field("productID", &OrderItem::productID),
+        field("productName", &OrderItem::productName),
+        field("price", &OrderItem::price),
+        field("quantity", &OrderItem::quantity),
+        field("subtotal", &OrderItem::subtotal),
+        addedField("warehouseID", &OrderItem::warehouseID));
+
+    static int keyOf(const OrderItem& item) { return item.orderID; }
+};
 
-#endif
+template <>
+struct EntityTraits<Order> {
+    static constexpr auto fields = make_tuple(
+        field("orderID", &Order::orderID),
+        field("customerID", &Order::customerID),
+        field("customerName", &Order::customerName),
+        field("totalAmount", &Order::totalAmount),
+        field("orderDate", &Order::orderDate),
+        field("status", &Order::status));
+
+    static int keyOf(const Order& order) { return order.orderID; }
+    static constexpr const char* lookup = "customerID";
+};
 
+#endif
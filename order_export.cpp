@@ -0,0 +1,234 @@
+#include "order_export.h"
+#include "order.h"
+#include "codec.h"
+#include "csv.h"
+#include "jsonl.h"
+#include "metrics.h"
+#include "trace.h"
+
+#include <fstream>
+#include <chrono>
+#include <charconv>
+
+// ========== Dates ==========
+// Civil date <-> days since 1970-01-01 in the proleptic Gregorian calendar,
+// after Howard Hinnant's algorithms. No time zone database and no locale.
+static long long daysFromCivil(long long year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<long long>(dayOfEra) - 719468;
+}
+
+static void civilFromDays(long long days, long long& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned shifted = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * shifted + 2) / 5 + 1;
+    month = shifted < 10 ? shifted + 3 : shifted - 9;
+    year = static_cast<long long>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+static char* appendDigits(char* out, unsigned value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return out + width;
+}
+
+// YYYY-MM-DDTHH:MM:SSZ, or the raw seconds for years outside 0000-9999
+static size_t formatTimestamp(time_t when, char* out) {
+    long long seconds = static_cast<long long>(when);
+    long long days = seconds >= 0 ? seconds / 86400 : (seconds - 86399) / 86400;
+    unsigned secondOfDay = static_cast<unsigned>(seconds - days * 86400);
+    long long year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+    if (year < 0 || year > 9999) return to_chars(out, out + 24, seconds).ptr - out;
+
+    char* p = appendDigits(out, static_cast<unsigned>(year), 4);
+    *p++ = '-';
+    p = appendDigits(p, month, 2);
+    *p++ = '-';
+    p = appendDigits(p, day, 2);
+    *p++ = 'T';
+    p = appendDigits(p, secondOfDay / 3600, 2);
+    *p++ = ':';
+    p = appendDigits(p, secondOfDay / 60 % 60, 2);
+    *p++ = ':';
+    p = appendDigits(p, secondOfDay % 60, 2);
+    *p++ = 'Z';
+    return p - out;
+}
+
+bool OrderExport::parseDate(string_view text, time_t& result) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-') return false;
+    unsigned year, month, day;
+    const char* base = text.data();
+    if (from_chars(base, base + 4, year).ptr != base + 4) return false;
+    if (from_chars(base + 5, base + 7, month).ptr != base + 7) return false;
+    if (from_chars(base + 8, base + 10, day).ptr != base + 10) return false;
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+
+    // Reject dates that do not exist, such as 2023-02-30
+    long long days = daysFromCivil(year, month, day);
+    long long checkYear;
+    unsigned checkMonth, checkDay;
+    civilFromDays(days, checkYear, checkMonth, checkDay);
+    if (checkMonth != month || checkDay != day) return false;
+
+    result = static_cast<time_t>(days * 86400);
+    return true;
+}
+
+ExportFormat OrderExport::formatForFile(const string& filename) {
+    auto endsWith = [&filename](const string& suffix) {
+        return filename.size() >= suffix.size() && filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    return endsWith(".jsonl") || endsWith(".ndjson") ? EXPORT_JSONL : EXPORT_CSV;
+}
+
+// ========== Rows ==========
+static void writeHeader(CsvWriter& writer) {
+    for (const char* column : {"orderID", "customerID", "customerName", "orderDate", "status", "totalAmount",
+                               "productID", "productName", "price", "quantity", "subtotal"}) {
+        writer.field(column);
+    }
+    writer.endRow();
+}
+
+static void writeHeader(JsonlWriter&) {}
+
+static void writeRow(CsvWriter& writer, const Order& order, string_view date, const string& status, const OrderItem* item) {
+    writer.field(order.getID());
+    writer.field(order.getCustomerID());
+    writer.field(order.getCustomerName());
+    writer.field(date);
+    writer.field(status);
+    writer.field(order.getTotalAmount());
+    if (item != nullptr) {
+        writer.field(item->productID);
+        writer.field(item->productName);
+        writer.field(item->price);
+        writer.field(item->quantity);
+        writer.field(item->subtotal);
+    } else {
+        for (int column = 0; column < 5; ++column) writer.field(string_view());
+    }
+    writer.endRow();
+}
+
+static void writeRow(JsonlWriter& writer, const Order& order, string_view date, const string& status, const OrderItem* item) {
+    writer.field("orderID", order.getID());
+    writer.field("customerID", order.getCustomerID());
+    writer.field("customerName", order.getCustomerName());
+    writer.field("orderDate", date);
+    writer.field("status", status);
+    writer.field("totalAmount", order.getTotalAmount());
+    if (item != nullptr) {
+        writer.field("productID", item->productID);
+        writer.field("productName", item->productName);
+        writer.field("price", item->price);
+        writer.field("quantity", item->quantity);
+        writer.field("subtotal", item->subtotal);
+    } else {
+        for (const char* column : {"productID", "productName", "price", "quantity", "subtotal"}) writer.null(column);
+    }
+    writer.endRow();
+}
+
+// Next well-formed item, skipping malformed lines
+static bool nextItem(CsvFormat::Reader& reader, OrderItem& item) {
+    ReadResult result;
+    do {
+        result = reader.read<OrderItem>(item);
+    } while (result == READ_SKIPPED);
+    return result == READ_OK;
+}
+
+// Merge join: each order takes the run of items that follows the previous
+// order's run and carries its ID
+template <typename Writer>
+static void exportRows(CsvFormat::Reader& orders, CsvFormat::Reader& items, Writer& writer,
+                       time_t from, time_t to, ExportStats& stats) {
+    writeHeader(writer);
+
+    // One record of each, reused for the whole walk
+    Order order;
+    OrderItem item;
+    bool haveItem = nextItem(items, item);
+    char date[32];
+
+    ReadResult result;
+    while ((result = orders.read<Order>(order)) != READ_END) {
+        if (result == READ_SKIPPED) continue;
+        ++stats.ordersScanned;
+
+        bool selected = order.getOrderDate() >= from && order.getOrderDate() < to;
+        size_t dateLength = 0;
+        string status;
+        if (selected) {
+            dateLength = formatTimestamp(order.getOrderDate(), date);
+            status = Order::statusToString(order.getStatus());
+        }
+
+        size_t matched = 0;
+        for (; haveItem && item.orderID == order.getID(); haveItem = nextItem(items, item)) {
+            if (selected) writeRow(writer, order, string_view(date, dateLength), status, &item);
+            ++matched;
+        }
+        if (!selected) continue;
+        if (matched == 0) writeRow(writer, order, string_view(date, dateLength), status, nullptr);
+        ++stats.ordersExported;
+        stats.itemsExported += matched;
+    }
+
+    for (; haveItem; haveItem = nextItem(items, item)) ++stats.unmatchedItems;
+}
+
+ExportStats OrderExport::run(const string& ordersFile, const string& itemsFile, ostream& out, ExportFormat format,
+                             time_t from, time_t to) {
+    TRACE_SCOPE("OrderExport::run");
+    static Histogram exportTime("wms_export_seconds", "Time to export the order history");
+    static Counter ordersWritten("wms_export_orders_total", "Orders written by exports");
+    static Counter itemsWritten("wms_export_items_total", "Order items written by exports");
+    ScopedTimer timer(exportTime);
+
+    ExportStats stats = {};
+    auto start = chrono::steady_clock::now();
+
+    ifstream ordersIn(ordersFile);
+    ifstream itemsIn(itemsFile);
+    if (!ordersIn.is_open() || !itemsIn.is_open()) return stats;
+    stats.opened = true;
+
+    CsvFormat::Reader orders(ordersIn);
+    CsvFormat::Reader items(itemsIn);
+    if (format == EXPORT_JSONL) {
+        JsonlWriter writer(out);
+        exportRows(orders, items, writer, from, to, stats);
+    } else {
+        CsvWriter writer(out);
+        exportRows(orders, items, writer, from, to, stats);
+    }
+    out.flush();
+    stats.written = static_cast<bool>(out);
+
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    ordersWritten.increment(stats.ordersExported);
+    itemsWritten.increment(stats.itemsExported);
+    return stats;
+}
+
+ExportStats OrderExport::run(const string& ordersFile, const string& itemsFile, const string& outputFile, ExportFormat format,
+                             time_t from, time_t to) {
+    ofstream out(outputFile);
+    if (!out.is_open()) return ExportStats();
+    return run(ordersFile, itemsFile, out, format, from, to);
+}
@@ -0,0 +1,59 @@
+#ifndef ORDER_EXPORT_H
+#define ORDER_EXPORT_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <ctime>
+#include <limits>
+
+using namespace std;
+
+enum ExportFormat {
+    EXPORT_CSV,
+    EXPORT_JSONL
+};
+
+struct ExportStats {
+    size_t ordersScanned;
+    size_t ordersExported;
+    size_t itemsExported;
+    size_t unmatchedItems;  // items left over once the orders ran out
+    double seconds;
+    bool opened;            // false if an input or the output could not be opened
+    bool written;           // false if the output stream failed
+
+    double ordersPerSecond() const { return seconds > 0 ? ordersScanned / seconds : 0; }
+};
+
+// Denormalized extract of the order history: one row per order item with
+// the order's columns repeated, and one row with empty item columns for an
+// order without items. Columns:
+//
+//     orderID,customerID,customerName,orderDate,status,totalAmount,
+//     productID,productName,price,quantity,subtotal
+//
+// orderDate is written as ISO 8601 UTC. Only orders with from <= orderDate
+// < to are written.
+//
+// The orders and items files are walked side by side, which relies on the
+// items file listing each order's items in the same sequence as the orders
+// file (Order::saveToFile appends them that way). Memory use is one order,
+// one item and the output buffer, however long the history is.
+class OrderExport {
+public:
+    static ExportStats run(const string& ordersFile, const string& itemsFile, ostream& out, ExportFormat format,
+                           time_t from = numeric_limits<time_t>::min(), time_t to = numeric_limits<time_t>::max());
+
+    // Same, into `outputFile` (truncated)
+    static ExportStats run(const string& ordersFile, const string& itemsFile, const string& outputFile, ExportFormat format,
+                           time_t from = numeric_limits<time_t>::min(), time_t to = numeric_limits<time_t>::max());
+
+    // EXPORT_JSONL for a .jsonl or .ndjson name, EXPORT_CSV otherwise
+    static ExportFormat formatForFile(const string& filename);
+
+    // Midnight UTC of a YYYY-MM-DD date
+    static bool parseDate(string_view text, time_t& result);
+};
+
+#endif
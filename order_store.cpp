@@ -0,0 +1,261 @@
+#include "order_store.h"
+#include <sstream>
+#include "storage.h"
+#include "metrics.h"
+#include "trace.h"
+
+namespace {
+
+const size_t INDEX_CACHE_BYTES = 8 << 20;
+
+bool buildOrderIndex(const string& filename, const SourceStamp& stamp) {
+    TRACE_SCOPE("OrderStore::buildIndex");
+    static Histogram buildTime("wms_index_build_seconds", "Time to rebuild the on-disk indexes", "entity=\"order\"");
+    ScopedTimer timer(buildTime);
+    return buildIndexes<Order>(filename, {{"id", [](const Order& order) { return intKey(order.getID()); }}}, stamp);
+}
+
+bool buildItemIndex(const string& filename, const SourceStamp& stamp) {
+    TRACE_SCOPE("OrderStore::buildItemIndex");
+    static Histogram buildTime("wms_index_build_seconds", "Time to rebuild the on-disk indexes", "entity=\"order_item\"");
+    ScopedTimer timer(buildTime);
+    return buildIndexes<OrderItem>(filename, {{"order", [](const OrderItem& item) { return intKey(item.orderID); }}}, stamp);
+}
+
+}  // namespace
+
+OrderStore::OrderStore(const string& ordersFilename, const string& itemsFilename, size_t budgetBytes)
+    : ordersFile(ordersFilename),
+      itemsFile(itemsFilename),
+      orders(ordersFilename, {"id"}, [ordersFilename](const SourceStamp& stamp) { return buildOrderIndex(ordersFilename, stamp); },
+             INDEX_CACHE_BYTES),
+      items(itemsFilename, {"order"}, [itemsFilename](const SourceStamp& stamp) { return buildItemIndex(itemsFilename, stamp); },
+            INDEX_CACHE_BYTES),
+      cache(budgetBytes) {}
+
+size_t OrderStore::footprint(const Order& order) {
+    size_t bytes = sizeof(Order) + order.getCustomerName().capacity() + order.getItems().capacity() * sizeof(OrderItem);
+    for (const auto& item : order.getItems()) bytes += item.productName.capacity();
+    // Cache entry, list node and hash node
+    return bytes + 64;
+}
+
+bool OrderStore::locate(int id, RecordRef& ref) {
+    return orders.refresh() && lookup(id, ref);
+}
+
+bool OrderStore::lookup(int id, RecordRef& ref) {
+    bool found = false;
+    string key = intKey(id);
+    orders.index(0).scanFrom(key, [&](string_view entry, RecordRef at) {
+        found = entry == key;
+        ref = at;
+        return false;
+    });
+    return found;
+}
+
+bool OrderStore::loadHeader(int id, Order& order, RecordRef& ref) {
+    if (Storage::current() != STORAGE_CSV) return Storage::open<Order>(ordersFile)->findByKey(id, order);
+    string bytes;
+    return locate(id, ref) && orders.read(ref, bytes) && parseRecord(bytes, order);
+}
+
+bool OrderStore::loadIndexed(int id, Order& order) {
+    RecordRef ref;
+    if (!loadHeader(id, order, ref)) return false;
+    if (!items.refresh()) return true;
+
+    string bytes;
+    string key = intKey(id);
+    items.index(0).scanFrom(key, [&](string_view entry, RecordRef at) {
+        if (entry != key) return false;
+        OrderItem item;
+        if (items.read(at, bytes) && parseRecord(bytes, item)) order.items.push_back(move(item));
+        return true;
+    });
+    return true;
+}
+
+shared_ptr<const Order> OrderStore::find(int id) {
+    static Counter hitTotal("wms_order_cache_hits_total", "Order lookups served from the order cache");
+    static Counter missTotal("wms_order_cache_misses_total", "Order lookups that loaded the order from storage");
+    static Histogram faultTime("wms_order_fault_seconds", "Time to load one order on an order cache miss");
+
+    shared_ptr<Order> cached = cache.find(id);
+    if (cached) {
+        hitTotal.increment();
+        return cached;
+    }
+    missTotal.increment();
+
+    ScopedTimer timer(faultTime);
+    auto order = make_shared<Order>();
+    bool found = Storage::current() == STORAGE_CSV ? loadIndexed(id, *order)
+                                                   : Order::findInFile(ordersFile, itemsFile, id, *order);
+    if (!found) return nullptr;
+    cache.insert(id, order, footprint(*order));
+    return order;
+}
+
+string OrderStore::rowOf(const Order& order) {
+    ostringstream row;
+    {
+        CsvWriter writer(row, 512);
+        CsvFormat::write(writer, order);
+    }
+    return row.str();
+}
+
+bool OrderStore::add(const Order& order) {
+    TRACE_SCOPE("OrderStore::add");
+    static Counter rowsWritten("wms_rows_written_total", "Records written by saves and rewrites", "entity=\"order\"");
+    if (!Storage::open<Order>(ordersFile)->append(order)) return false;
+    rowsWritten.increment();
+    bool written = Storage::open<OrderItem>(itemsFile)->appendAll(order.getItems());
+    auto copy = make_shared<Order>(order);
+    cache.insert(order.getID(), copy, footprint(*copy));
+    return written;
+}
+
+bool OrderStore::update(const Order& order) {
+    TRACE_SCOPE("OrderStore::update");
+    bool written = false;
+    RecordRef ref;
+    if (Storage::current() == STORAGE_CSV && locate(order.getID(), ref)) {
+        written = orders.overwrite(ref, rowOf(order));
+    }
+    if (!written) written = Order::updateInFile(ordersFile, order);
+    if (written) {
+        auto copy = make_shared<Order>(order);
+        cache.insert(order.getID(), copy, footprint(*copy));
+    } else {
+        cache.erase(order.getID());
+    }
+    return written;
+}
+
+bool OrderStore::findHeader(int id, Order& order) {
+    RecordRef ref;
+    return loadHeader(id, order, ref);
+}
+
+void OrderStore::scanHeaders(const function<bool(Order&)>& visit) {
+    Storage::open<Order>(ordersFile)->scan(visit);
+}
+
+void OrderStore::lookupSorted(const vector<int>& ids, vector<RecordRef>& refs, vector<char>& found) {
+    if (ids.empty()) return;
+    // A sparse batch is cheaper as separate descents than as one walk over
+    // every entry between its ends
+    if (static_cast<long long>(ids.back()) - ids.front() > 16LL * static_cast<long long>(ids.size())) {
+        for (size_t i = 0; i < ids.size(); ++i) found[i] = lookup(ids[i], refs[i]);
+        return;
+    }
+    size_t next = 0;
+    string wanted = intKey(ids[0]);
+    orders.index(0).scanFrom(wanted, [&](string_view entry, RecordRef at) {
+        // Passed IDs that are not on file
+        while (entry > wanted) {
+            if (++next == ids.size()) return false;
+            wanted = intKey(ids[next]);
+        }
+        if (entry == wanted) {
+            refs[next] = at;
+            found[next] = 1;
+            if (++next == ids.size()) return false;
+            wanted = intKey(ids[next]);
+        }
+        return true;
+    });
+}
+
+bool OrderStore::setStatuses(const vector<pair<int, OrderStatus>>& changes) {
+    TRACE_SCOPE("OrderStore::setStatuses");
+    static Histogram batchTime("wms_batch_update_seconds", "Time to update a batch of records", "entity=\"order\"");
+    ScopedTimer timer(batchTime);
+
+    // The last change to each order, in ID order
+    vector<pair<int, OrderStatus>> sorted(changes);
+    stable_sort(sorted.begin(), sorted.end(),
+                [](const pair<int, OrderStatus>& a, const pair<int, OrderStatus>& b) { return a.first < b.first; });
+    vector<int> ids;
+    vector<OrderStatus> statuses;
+    for (const auto& change : sorted) {
+        if (!ids.empty() && ids.back() == change.first) {
+            statuses.back() = change.second;
+        } else {
+            ids.push_back(change.first);
+            statuses.push_back(change.second);
+        }
+    }
+
+    // With CSV storage, find every row with one walk along the index
+    bool indexed = Storage::current() == STORAGE_CSV && orders.refresh();
+    vector<RecordRef> refs(ids.size());
+    vector<char> found(ids.size(), 0);
+    if (indexed) lookupSorted(ids, refs, found);
+    auto backend = Storage::open<Order>(ordersFile);
+
+    bool all = true;
+    // Rows overwritten in place, and the orders behind them
+    vector<pair<RecordRef, string>> rows;
+    vector<Order> inPlace;
+    // Orders the backend rewrites instead
+    vector<Order> rewritten;
+    string bytes;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        Order order;
+        bool loaded = indexed ? found[i] && orders.read(refs[i], bytes) && parseRecord(bytes, order)
+                              : backend->findByKey(ids[i], order);
+        if (!loaded) {
+            all = false;
+            continue;
+        }
+        order.setStatus(statuses[i]);
+        if (indexed) {
+            string row = rowOf(order);
+            if (row.size() == refs[i].length) {
+                rows.emplace_back(refs[i], move(row));
+                inPlace.push_back(move(order));
+                continue;
+            }
+        }
+        rewritten.push_back(move(order));
+    }
+    if (!rows.empty() && !orders.overwriteAll(rows)) {
+        for (auto& order : inPlace) rewritten.push_back(move(order));
+    }
+    bool written = rewritten.empty() || backend->updateAll(rewritten);
+
+    // Resident orders take the new status; headers without items are not
+    // cached
+    for (size_t i = 0; i < ids.size(); ++i) {
+        shared_ptr<Order> cached = cache.peek(ids[i]);
+        if (!cached) continue;
+        if (!written) {
+            cache.erase(ids[i]);
+            continue;
+        }
+        auto copy = make_shared<Order>(*cached);
+        copy->setStatus(statuses[i]);
+        cache.insert(ids[i], copy, footprint(*copy));
+    }
+    return all && written;
+}
+
+bool parseOrderIDs(const string& text, vector<int>& ids) {
+    stringstream in(text);
+    string part;
+    while (getline(in, part, ',')) {
+        int first, last;
+        char dash, extra;
+        stringstream range(part);
+        if (!(range >> first)) return false;
+        last = first;
+        if (range >> dash && (dash != '-' || !(range >> last))) return false;
+        if (range >> extra || first < 1 || last < first || last - first + 1 >= 1000000) return false;
+        for (int id = first; id <= last; ++id) ids.push_back(id);
+    }
+    return !ids.empty();
+}
@@ -0,0 +1,84 @@
+#ifndef ORDER_STORE_H
+#define ORDER_STORE_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <functional>
+#include "order.h"
+#include "csv_index.h"
+#include "lru_cache.h"
+
+using namespace std;
+
+const size_t ORDER_CACHE_BYTES = 64 << 20;
+
+// Orders by ID for histories larger than memory. Decoded orders, items
+// included, are kept in a sharded LRU cache up to a byte budget. A miss
+// faults the one order in. With CSV storage this goes through B+-tree
+// indexes over orders.csv and order_items.csv, both keyed by orderID.
+// Other backends answer key lookups themselves.
+//
+// Updates write through. A CSV row whose new text has the same length as
+// the old (a status change) is overwritten in place and the indexes are
+// kept. Otherwise the file is rewritten and the indexes rebuild on the
+// next miss. Batches of status changes go through setStatuses(), which
+// overwrites every row with one open of the file.
+class OrderStore {
+private:
+    string ordersFile;
+    string itemsFile;
+    IndexedFile orders;
+    IndexedFile items;
+    ShardedLruCache<int, Order> cache;
+
+    // Rough heap footprint of a decoded order, charged against the budget
+    static size_t footprint(const Order& order);
+
+    bool locate(int id, RecordRef& ref);
+    // locate() without checking the indexes are current
+    bool lookup(int id, RecordRef& ref);
+    // The header row alone; `ref` is set with CSV storage
+    bool loadHeader(int id, Order& order, RecordRef& ref);
+    // lookup() for IDs sorted ascending without repeats, in one walk along
+    // the index; found[i] says whether ids[i] is on file
+    void lookupSorted(const vector<int>& ids, vector<RecordRef>& refs, vector<char>& found);
+    bool loadIndexed(int id, Order& order);
+    // The order as one CSV row, newline included
+    static string rowOf(const Order& order);
+
+public:
+    OrderStore(const string& ordersFilename, const string& itemsFilename, size_t budgetBytes = ORDER_CACHE_BYTES);
+
+    // The order with `id`, or null if there is none
+    shared_ptr<const Order> find(int id);
+
+    // Append a new order, items included, to storage and to the cache
+    bool add(const Order& order);
+    // Write a changed order (same ID) to storage and to the cache
+    bool update(const Order& order);
+
+    // The order without its items, for callers that only need the status,
+    // date or customer; the cache is neither read nor filled
+    bool findHeader(int id, Order& order);
+    // Every order without its items, in storage order, until visit()
+    // returns false
+    void scanHeaders(const function<bool(Order&)>& visit);
+
+    // Give many orders a new status in one batch. False if an order is
+    // missing or a write fails; the others are still written.
+    bool setStatuses(const vector<pair<int, OrderStatus>>& changes);
+
+    void setBudget(size_t budgetBytes) { cache.setBudget(budgetBytes); }
+
+    uint64_t hits() const { return cache.hits(); }
+    uint64_t misses() const { return cache.misses(); }
+    size_t residentOrders() { return cache.size(); }
+    size_t residentBytes() { return cache.bytes(); }
+};
+
+// Order IDs from a list like "12, 15-40"; false on anything else, or on a
+// range of a million IDs or more
+bool parseOrderIDs(const string& text, vector<int>& ids);
+
+#endif
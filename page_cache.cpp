@@ -0,0 +1,100 @@
+#include "page_cache.h"
+#include "metrics.h"
+
+bool PageCache::open(const string& path, size_t size, size_t pageCount) {
+    close();
+    file.open(path, ios::in | ios::binary);
+    if (!file.is_open()) return false;
+    file.seekg(0, ios::end);
+    fileBytes = static_cast<uint64_t>(file.tellg());
+    filename = path;
+    pageBytes = size > 0 ? size : 4096;
+    capacity = pageCount > 0 ? pageCount : 1;
+    return true;
+}
+
+void PageCache::close() {
+    lock_guard<mutex> guard(lock);
+    if (file.is_open()) file.close();
+    file.clear();
+    pages.clear();
+    byNumber.clear();
+    fileBytes = 0;
+}
+
+const PageCache::Page* PageCache::fetch(uint64_t number) {
+    static Counter hitTotal("wms_page_cache_hits_total", "Page reads served from memory");
+    static Counter missTotal("wms_page_cache_misses_total", "Page reads that went to the file");
+
+    auto found = byNumber.find(number);
+    if (found != byNumber.end()) {
+        pages.splice(pages.begin(), pages, found->second);
+        ++hitCount;
+        hitTotal.increment();
+        return &pages.front();
+    }
+
+    uint64_t start = number * pageBytes;
+    if (start >= fileBytes) return nullptr;
+    ++missCount;
+    missTotal.increment();
+
+    // Reuse the coldest page's buffer once the budget is spent
+    if (pages.size() >= capacity) {
+        pages.splice(pages.begin(), pages, prev(pages.end()));
+        byNumber.erase(pages.front().number);
+    } else {
+        pages.emplace_front();
+    }
+    Page& page = pages.front();
+    page.number = number;
+    page.bytes.resize(static_cast<size_t>(min<uint64_t>(pageBytes, fileBytes - start)));
+
+    file.clear();
+    file.seekg(static_cast<streamoff>(start));
+    file.read(page.bytes.data(), page.bytes.size());
+    if (static_cast<size_t>(file.gcount()) != page.bytes.size()) {
+        pages.pop_front();
+        return nullptr;
+    }
+    byNumber[number] = pages.begin();
+    return &page;
+}
+
+bool PageCache::read(uint64_t offset, size_t length, string& out) {
+    lock_guard<mutex> guard(lock);
+    out.clear();
+    if (offset + length > fileBytes) return false;
+    out.reserve(length);
+    while (length > 0) {
+        const Page* page = fetch(offset / pageBytes);
+        if (page == nullptr) return false;
+        size_t within = static_cast<size_t>(offset % pageBytes);
+        size_t take = min(length, page->bytes.size() - within);
+        out.append(page->bytes.data() + within, take);
+        offset += take;
+        length -= take;
+    }
+    return true;
+}
+
+void PageCache::invalidate(uint64_t offset, size_t length) {
+    lock_guard<mutex> guard(lock);
+    if (length == 0) return;
+    for (uint64_t number = offset / pageBytes; number <= (offset + length - 1) / pageBytes; ++number) {
+        auto found = byNumber.find(number);
+        if (found == byNumber.end()) continue;
+        pages.erase(found->second);
+        byNumber.erase(found);
+    }
+}
+
+uint64_t PageCache::hits() const {
+    lock_guard<mutex> guard(lock);
+    return hitCount;
+}
+
+uint64_t PageCache::misses() const {
+    lock_guard<mutex> guard(lock);
+    return missCount;
+}
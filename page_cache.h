@@ -0,0 +1,62 @@
+#ifndef PAGE_CACHE_H
+#define PAGE_CACHE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+
+using namespace std;
+
+// Fixed-size pages of one file, read on first use and kept up to a page
+// budget, least recently used out first. Reads that span pages are
+// stitched together, so callers address the file by byte offset. Safe to
+// share between threads; each read copies out under the lock.
+class PageCache {
+private:
+    struct Page {
+        uint64_t number;
+        vector<char> bytes;  // shorter than pageBytes only at the end of the file
+    };
+
+    string filename;
+    ifstream file;
+    uint64_t fileBytes;
+    size_t pageBytes;
+    size_t capacity;
+    list<Page> pages;  // most recently used first
+    unordered_map<uint64_t, list<Page>::iterator> byNumber;
+    uint64_t hitCount;
+    uint64_t missCount;
+    mutable mutex lock;
+
+    // With the lock held; null past the end of the file or on a read error
+    const Page* fetch(uint64_t number);
+
+public:
+    PageCache() : fileBytes(0), pageBytes(4096), capacity(0), hitCount(0), missCount(0) {}
+
+    PageCache(const PageCache&) = delete;
+    PageCache& operator=(const PageCache&) = delete;
+
+    // Open `path` with a budget of `pageCount` pages of `size` bytes
+    bool open(const string& path, size_t size = 4096, size_t pageCount = 256);
+    void close();
+    bool isOpen() const { return file.is_open(); }
+
+    uint64_t size() const { return fileBytes; }
+
+    // Copy `length` bytes at `offset` into `out`; false if the file is shorter
+    bool read(uint64_t offset, size_t length, string& out);
+
+    // Forget the cached pages overlapping a range the caller rewrote
+    void invalidate(uint64_t offset, size_t length);
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+};
+
+#endif
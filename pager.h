@@ -0,0 +1,216 @@
+#ifndef PAGER_H
+#define PAGER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <limits>
+#include <algorithm>
+#include "utils.h"
+
+using namespace std;
+
+// Cursor-based pager over a record vector. Only the records on the current
+// page are rendered, into one reusable buffer that is written in a single
+// call, so paging costs O(page size) regardless of how many records exist.
+// Filtering and sorting build a permutation of indices instead of copies,
+// and cached orderings (see InventoryViews) are paged in place.
+template <typename T>
+class Pager {
+private:
+    const vector<T>& items;
+    vector<size_t> view;
+    const vector<size_t>* activeView;
+    size_t pageSize;
+    size_t currentPage;
+    int activeSortKey;
+    string filterTerm;
+    string title;
+    string buffer;
+    function<bool(const T&, const string&)> matches;
+
+    // A sort key either compares records or hands out a cached ordering
+    struct SortOption {
+        string label;
+        function<bool(const T&, const T&)> less;
+        function<const vector<size_t>&()> ordering;
+    };
+    vector<SortOption> sortKeys;
+
+    const T& at(size_t position) const {
+        return items[activeView ? (*activeView)[position] : position];
+    }
+
+    void rebuildView() {
+        currentPage = 0;
+        activeView = nullptr;
+        view.clear();
+
+        const vector<size_t>* cached = nullptr;
+        if (activeSortKey >= 0 && sortKeys[activeSortKey].ordering) {
+            cached = &sortKeys[activeSortKey].ordering();
+        }
+
+        // A cached ordering with no filter is used in place, without a copy
+        if (cached && filterTerm.empty()) {
+            activeView = cached;
+            return;
+        }
+        if (!cached && filterTerm.empty() && activeSortKey < 0) return;
+
+        size_t count = cached ? cached->size() : items.size();
+        for (size_t i = 0; i < count; ++i) {
+            size_t index = cached ? (*cached)[i] : i;
+            if (filterTerm.empty() || matches(items[index], filterTerm)) view.push_back(index);
+        }
+        if (!cached && activeSortKey >= 0) {
+            const auto& less = sortKeys[activeSortKey].less;
+            stable_sort(view.begin(), view.end(),
+                        [this, &less](size_t a, size_t b) { return less(items[a], items[b]); });
+        }
+        activeView = &view;
+    }
+
+public:
+    Pager(const vector<T>& source, const string& pagerTitle, size_t perPage = 5)
+        : items(source) {
+        activeView = nullptr;
+        pageSize = perPage == 0 ? 1 : perPage;
+        currentPage = 0;
+        activeSortKey = -1;
+        title = pagerTitle;
+        buffer.reserve(pageSize * 1024);
+    }
+
+    void setFilter(function<bool(const T&, const string&)> matcher) { matches = matcher; }
+
+    void addSortKey(const string& label, function<bool(const T&, const T&)> less) {
+        sortKeys.push_back({label, less, nullptr});
+    }
+
+    // Sort key served from an externally maintained index permutation
+    void addCachedSortKey(const string& label, function<const vector<size_t>&()> ordering) {
+        sortKeys.push_back({label, nullptr, ordering});
+    }
+
+    size_t getCount() const { return activeView ? activeView->size() : items.size(); }
+
+    size_t getPageCount() const {
+        size_t count = getCount();
+        return count == 0 ? 1 : (count + pageSize - 1) / pageSize;
+    }
+
+    size_t getCurrentPage() const { return currentPage; }
+
+    void nextPage() { if (currentPage + 1 < getPageCount()) currentPage++; }
+    void previousPage() { if (currentPage > 0) currentPage--; }
+
+    // Jump to a zero-based page, clamped to the last page
+    void jumpTo(size_t page) { currentPage = min(page, getPageCount() - 1); }
+
+    void applyFilter(const string& term) {
+        filterTerm = matches ? toLowerCase(term) : "";
+        rebuildView();
+    }
+
+    void applySort(int key) {
+        activeSortKey = (key >= 0 && key < (int)sortKeys.size()) ? key : -1;
+        rebuildView();
+    }
+
+    void clearView() {
+        filterTerm.clear();
+        activeSortKey = -1;
+        rebuildView();
+    }
+
+    // Render the current page (clear screen, header, records, footer)
+    const string& renderPage() {
+        buffer.clear();
+        buffer += "\033[2J\033[1;1H\n";
+        buffer += BOLD;
+        buffer += CYAN;
+        buffer += title;
+        buffer += RESET;
+        buffer += "\n";
+
+        char line[160];
+        int length = snprintf(line, sizeof(line), "Page %zu of %zu | %zu record(s)",
+                              currentPage + 1, getPageCount(), getCount());
+        buffer.append(line, length);
+        if (!filterTerm.empty()) {
+            buffer += " | filter: ";
+            buffer += filterTerm;
+        }
+        if (activeSortKey >= 0) {
+            buffer += " | sorted by ";
+            buffer += sortKeys[activeSortKey].label;
+        }
+        buffer += "\n\n";
+
+        size_t begin = currentPage * pageSize;
+        size_t end = min(begin + pageSize, getCount());
+        for (size_t i = begin; i < end; ++i) {
+            at(i).appendTo(buffer);
+            buffer += "\n";
+        }
+        if (begin == end) {
+            buffer += YELLOW;
+            buffer += "No matching records.\n\n";
+            buffer += RESET;
+        }
+
+        buffer += YELLOW;
+        buffer += "[n]ext  [p]revious  [j]ump";
+        if (matches) buffer += "  [f]ilter";
+        if (!sortKeys.empty()) buffer += "  [s]ort";
+        buffer += "  [c]lear  [q]uit: ";
+        buffer += RESET;
+        return buffer;
+    }
+
+    // Interactive loop until the user quits
+    void run() {
+        while (true) {
+            writeToTerminal(renderPage());
+            char command = tolower(getch());
+
+            switch (command) {
+                case 'n': nextPage(); break;
+                case 'p': previousPage(); break;
+                case 'j': {
+                    size_t page;
+                    cout << "\n" << YELLOW << "Go to page: " << RESET;
+                    if (cin >> page && page > 0) jumpTo(page - 1);
+                    cin.clear();
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    break;
+                }
+                case 'f': {
+                    if (!matches) break;
+                    string term;
+                    cout << "\n" << YELLOW << "Filter: " << RESET;
+                    getline(cin, term);
+                    applyFilter(term);
+                    break;
+                }
+                case 's': {
+                    if (sortKeys.empty()) break;
+                    cout << "\n";
+                    for (size_t k = 0; k < sortKeys.size(); ++k) {
+                        cout << YELLOW << (k + 1) << ". " << RESET << sortKeys[k].label << "\n";
+                    }
+                    cout << CYAN << "Sort by (1-" << sortKeys.size() << "): " << RESET;
+                    char key = singleInput();
+                    applySort(key - '1');
+                    break;
+                }
+                case 'c': clearView(); break;
+                case 'q': return;
+            }
+        }
+    }
+};
+
+#endif
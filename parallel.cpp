@@ -0,0 +1,8 @@
+#include "parallel.h"
+
+size_t workerCount(size_t count, size_t requested) {
+    size_t threads = requested != 0 ? requested : thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    if (threads > count) threads = count;
+    return threads == 0 ? 1 : threads;
+}
@@ -0,0 +1,40 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include "trace.h"
+
+using namespace std;
+
+// Number of worker threads to use for `count` items (0 = one per core)
+size_t workerCount(size_t count, size_t requested = 0);
+
+// Split [0, count) into one contiguous chunk per thread, reduce each chunk
+// with mapChunk(begin, end) and fold the partial results together with merge.
+template <typename Result, typename MapChunk, typename Merge>
+Result parallelReduce(size_t count, MapChunk mapChunk, Merge merge, size_t threadCount = 0) {
+    size_t threads = workerCount(count, threadCount);
+    if (threads <= 1) return mapChunk(size_t(0), count);
+
+    vector<Result> partials(threads);
+    vector<thread> workers;
+    size_t chunk = (count + threads - 1) / threads;
+
+    for (size_t t = 0; t < threads; ++t) {
+        size_t begin = min(t * chunk, count);
+        size_t end = min(begin + chunk, count);
+        workers.emplace_back([&partials, &mapChunk, t, begin, end]() {
+            TRACE_SCOPE("parallelReduce chunk");
+            partials[t] = mapChunk(begin, end);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    Result result = move(partials[0]);
+    for (size_t t = 1; t < threads; ++t) merge(result, partials[t]);
+    return result;
+}
+
+#endif
@@ -0,0 +1,129 @@
+#include "product.h"
+
+#include "storage.h"
+#include "metrics.h"
+#include "trace.h"
+#include <cstdio>
+#include <algorithm>
+
+IdSequence Product::ids;
+
+Product::Product() {
+    productID = 0;
+    name = "Unnamed";
+    price = 0.0f;
+    quantity = 0;
+    category = "Uncategorized";
+    description = "";
+}
+
+Product::Product(string n, float p, int q, string c, string d) {
+    productID = ids.next();
+    name = n;
+    price = p;
+    quantity = q;
+    category = c;
+    description = d;
+}
+
+void Product::appendTo(string& out) const {
+    char priceText[32];
+    int priceLength = snprintf(priceText, sizeof(priceText), "$%.2f", price);
+    out += BOX_TOP;
+    appendBoxField(out, "Product ID: ", productID);
+    appendBoxField(out, "Name: ", name);
+    appendBoxField(out, "Price: ", priceText, priceLength);
+    appendBoxField(out, "Quantity: ", quantity);
+    appendBoxField(out, "Category: ", category);
+    
+    if (!description.empty()) {
+        appendBoxField(out, "Description: ", "", 0);
+        
+        // Split description into multiple lines if needed
+        for (size_t pos = 0; pos < description.length(); pos += BOX_WIDTH) {
+            size_t length = min(BOX_WIDTH, description.length() - pos);
+            appendBoxLine(out, description.data() + pos, length);
+        }
+    }
+    
+    out += BOX_BOTTOM;
+}
+
+void Product::display() const {
+    string out;
+    appendTo(out);
+    cout << out;
+}
+
+void Product::writeRow(ostream& out) const {
+    Repository<Product>::serialize(out, *this);
+}
+
+bool Product::saveToFile(const string& filename) const {
+    TRACE_SCOPE("Product::saveToFile");
+    static Counter rowsWritten("wms_rows_written_total", "Records written by saves and rewrites", "entity=\"product\"");
+    rowsWritten.increment();
+    
+    if (!Storage::open<Product>(filename)->append(*this)) {
+        cout << "Unable to open file for writing\n";
+        return false;
+    }
+    return true;
+}
+
+bool Product::saveAllToFile(const string& filename, const vector<Product>& products) {
+    TRACE_SCOPE("Product::saveAllToFile");
+    static Histogram rewriteTime("wms_rewrite_seconds", "Time to rewrite a data file", "entity=\"product\"");
+    static Counter rowsWritten("wms_rows_written_total", "Records written by saves and rewrites", "entity=\"product\"");
+    ScopedTimer timer(rewriteTime);
+    
+    if (!Storage::open<Product>(filename)->saveAll(products)) {
+        cout << "Unable to open file for writing\n";
+        return false;
+    }
+    rowsWritten.increment(products.size());
+    return true;
+}
+
+Product Product::loadFromFile(const string& filename, int id) {
+    TRACE_SCOPE("Product::loadFromFile");
+    Product record;
+    if (Storage::open<Product>(filename)->findByKey(id, record)) return record;
+    return Product();
+}
+
+vector<Product> Product::loadAllFromFile(const string& filename) {
+    TRACE_SCOPE("Product::loadAllFromFile");
+    static Histogram loadTime("wms_load_seconds", "Time to load a data file", "entity=\"product\"");
+    static Counter rowsLoaded("wms_rows_loaded_total", "Records parsed by the loaders", "entity=\"product\"");
+    ScopedTimer timer(loadTime);
+    
+    vector<Product> products = Storage::open<Product>(filename)->loadAll();
+    rowsLoaded.increment(products.size());
+    return products;
+}
+
+int Product::findIndexByID(const vector<Product>& products, int id) {
+    static Counter lookups("wms_lookups_total", "Record lookups by key", "kind=\"product_id\"");
+    lookups.increment();
+    for (size_t i = 0; i < products.size(); ++i)
+        if (products[i].getID() == id) return i;
+    return -1;
+}
+
+vector<Product> Product::searchByName(const vector<Product>& products, const string& searchTerm) {
+    static Histogram searchTime("wms_search_seconds", "Time to run a product name search", "kind=\"product_name\"");
+    ScopedTimer timer(searchTime);
+    
+    vector<Product> results;
+    string lowerSearchTerm = toLowerCase(searchTerm);
+    
+    for (const auto& product : products) {
+        // Check if the product name contains the search term
+        if (toLowerCase(product.getName()).find(lowerSearchTerm) != string::npos) {
+            results.push_back(product);
+        }
+    }
+    
+    return results;
+}
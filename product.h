@@ -3,16 +3,17 @@
 
 #include <iostream>
 #include <string>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include "utils.h"
+#include "repository.h"
+#include "id_sequence.h"
 
 using namespace std;
 
 class Product {
 private:
-    static int nextID;
+    friend struct EntityTraits<Product>;
+
     int productID;
     string name;
     float price;
@@ -21,30 +22,19 @@ private:
     string description;
 
 public:
-    Product() {
-        productID = nextID++;
-        name = "Unnamed";
-        price = 0.0f;
-        quantity = 0;
-        category = "Uncategorized";
-        description = "";
-    }
+    // Where new records get their IDs; see IdSequence
+    static IdSequence ids;
 
-    Product(string n, float p, int q, string c = "Uncategorized", string d = "") {
-        productID = nextID++;
-        name = n;
-        price = p;
-        quantity = q;
-        category = c;
-        description = d;
-    }
+    // A blank record with ID 0, for loaders to fill in
+    Product();
+    Product(string n, float p, int q, string c = "Uncategorized", string d = "");
 
     int getID() const { return productID; }
-    string getName() const { return name; }
+    const string& getName() const { return name; }
     float getPrice() const { return price; }
     int getQuantity() const { return quantity; }
-    string getCategory() const { return category; }
-    string getDescription() const { return description; }
+    const string& getCategory() const { return category; }
+    const string& getDescription() const { return description; }
 
     void setName(const string& newName) { name = newName; }
     void setPrice(float newPrice) { price = newPrice; }
@@ -64,130 +54,39 @@ public:
         return false;
     }
 
-    void display() const {
-        cout << "┌─────────────────────────────────────────┐\n";
-        cout << "│ " << CYAN << BOLD << "Product ID: " << RESET << productID << string(30 - to_string(productID).length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Name: " << RESET << name << string(37 - name.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Price: " << RESET << "$" << fixed << setprecision(2) << price << string(35 - to_string(int(price)).length() - 4, ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Quantity: " << RESET << quantity << string(33 - to_string(quantity).length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Category: " << RESET << category << string(33 - category.length(), ' ') << "│\n";
-        
-        if (!description.empty()) {
-            cout << "│ " << CYAN << BOLD << "Description: " << RESET << "                       │\n";
-            
-            // Split description into multiple lines if needed
-            string desc = description;
-            while (desc.length() > 0) {
-                string line = desc.substr(0, 37);
-                desc = desc.length() > 37 ? desc.substr(37) : "";
-                cout << "│ " << line << string(37 - line.length(), ' ') << "│\n";
-            }
-        }
-        
-        cout << "└─────────────────────────────────────────┘\n";
-    }
+    // Render the product card into `out` without intermediate strings
+    void appendTo(string& out) const;
+    void display() const;
 
-    void saveToFile(const string& filename) const {
-        ofstream file(filename, ios::app);
-        if (file.is_open()) {
-            file << productID << "," << name << "," << price << "," << quantity << "," 
-                 << category << "," << description << "\n";
-            file.close();
-        } else {
-            cout << "Unable to open file for writing\n";
-        }
-    }
+    // Write this product as one CSV row
+    void writeRow(ostream& out) const;
+    // Append this product to `filename`; false if the write failed
+    bool saveToFile(const string& filename) const;
 
-    static Product loadFromFile(const string& filename, int id) {
-        ifstream file(filename);
-        string line;
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            int fileID;
-            string fileName, fileCategory, fileDesc;
-            float filePrice;
-            int fileQuantity;
-            
-            getline(ss, field, ',');
-            fileID = stoi(field);
-            getline(ss, fileName, ',');
-            getline(ss, field, ',');
-            filePrice = stof(field);
-            getline(ss, field, ',');
-            fileQuantity = stoi(field);
-            getline(ss, fileCategory, ',');
-            getline(ss, fileDesc);
-            
-            if (fileID == id) {
-                Product p(fileName, filePrice, fileQuantity, fileCategory, fileDesc);
-                p.productID = fileID;  // Preserve the original ID
-                return p;
-            }
-        }
-        file.close();
-        return Product();
-    }
+    // Rewrite the whole file from `products`; false if the write failed
+    static bool saveAllToFile(const string& filename, const vector<Product>& products);
+
+    static Product loadFromFile(const string& filename, int id);
+    static vector<Product> loadAllFromFile(const string& filename);
+
+    // Position of the product with `id` in `products`, or -1
+    static int findIndexByID(const vector<Product>& products, int id);
 
-    static vector<Product> loadAllFromFile(const string& filename) {
-        ifstream file(filename);
-        string line;
-        vector<Product> products;
-        
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            int fileID;
-            string fileName, fileCategory, fileDesc;
-            float filePrice;
-            int fileQuantity;
-            
-            getline(ss, field, ',');
-            fileID = stoi(field);
-            getline(ss, fileName, ',');
-            getline(ss, field, ',');
-            filePrice = stof(field);
-            getline(ss, field, ',');
-            fileQuantity = stoi(field);
-            getline(ss, fileCategory, ',');
-            getline(ss, fileDesc);
-            
-            Product p(fileName, filePrice, fileQuantity, fileCategory, fileDesc);
-            p.productID = fileID;  // Preserve the original ID
-            products.push_back(p);
-        }
-        file.close();
-        return products;
-    }
-    
     // Search products by name (partial match)
-    static vector<Product> searchByName(const vector<Product>& products, const string& searchTerm) {
-        vector<Product> results;
-        string lowerSearchTerm = searchTerm;
-        
-        // Convert search term to lowercase
-        for (char& c : lowerSearchTerm) {
-            c = tolower(c);
-        }
-        
-        for (const auto& product : products) {
-            string lowerName = product.getName();
-            
-            // Convert product name to lowercase
-            for (char& c : lowerName) {
-                c = tolower(c);
-            }
-            
-            // Check if the product name contains the search term
-            if (lowerName.find(lowerSearchTerm) != string::npos) {
-                results.push_back(product);
-            }
-        }
-        
-        return results;
-    }
+    static vector<Product> searchByName(const vector<Product>& products, const string& searchTerm);
 };
 
-int Product::nextID = 1;
+template <>
+struct EntityTraits<Product> {
+    static constexpr auto fields = make_tuple(
+        field("productID", &Product::productID),
+        field("name", &Product::name),
+        field("price", &Product::price),
+        field("quantity", &Product::quantity),
+        field("category", &Product::category),
+        field("description", &Product::description));
+
+    static int keyOf(const Product& product) { return product.productID; }
+};
 
 #endif
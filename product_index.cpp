@@ -0,0 +1,71 @@
+#include "product_index.h"
+#include "metrics.h"
+#include "trace.h"
+
+namespace {
+
+const size_t BY_ID = 0;
+const size_t BY_NAME = 1;
+
+}  // namespace
+
+ProductIndex::ProductIndex(const string& filename, size_t cacheBytes)
+    : file(filename, {"id", "name"},
+           [filename](const SourceStamp& stamp) {
+               TRACE_SCOPE("ProductIndex::build");
+               static Histogram buildTime("wms_index_build_seconds", "Time to rebuild the on-disk indexes", "entity=\"product\"");
+               ScopedTimer timer(buildTime);
+               return buildIndexes<Product>(filename,
+                                            {{"id", [](const Product& product) { return intKey(product.getID()); }},
+                                             {"name", [](const Product& product) { return toLowerCase(product.getName()); }}},
+                                            stamp);
+           },
+           cacheBytes) {}
+
+bool ProductIndex::readProduct(RecordRef ref, Product& product) {
+    string bytes;
+    return file.read(ref, bytes) && parseRecord(bytes, product);
+}
+
+bool ProductIndex::findByID(int id, Product& product) {
+    static Counter lookups("wms_lookups_total", "Record lookups by key", "kind=\"product_id_index\"");
+    lookups.increment();
+    if (!file.refresh()) return false;
+
+    bool found = false;
+    string key = intKey(id);
+    file.index(BY_ID).scanFrom(key, [&](string_view entry, RecordRef ref) {
+        found = entry == key && readProduct(ref, product);
+        return false;
+    });
+    return found;
+}
+
+void ProductIndex::scanNamePrefix(const string& prefix, const function<bool(Product&)>& visit) {
+    static Histogram searchTime("wms_search_seconds", "Time to run a product name search", "kind=\"product_name_index\"");
+    ScopedTimer timer(searchTime);
+    if (!file.refresh()) return;
+
+    string lowerPrefix = toLowerCase(prefix);
+    file.index(BY_NAME).scanPrefix(string_view(lowerPrefix).substr(0, BTREE_MAX_KEY), [&](string_view, RecordRef ref) {
+        Product product;
+        if (!readProduct(ref, product)) return true;
+        // Keys are cut at BTREE_MAX_KEY, so check longer prefixes in full
+        if (lowerPrefix.size() > BTREE_MAX_KEY && toLowerCase(product.getName()).compare(0, lowerPrefix.size(), lowerPrefix) != 0) {
+            return true;
+        }
+        return visit(product);
+    });
+}
+
+void ProductIndex::scanByID(const function<bool(Product&)>& visit) {
+    if (!file.refresh()) return;
+    file.index(BY_ID).scanFrom(string_view(), [&](string_view, RecordRef ref) {
+        Product product;
+        return !readProduct(ref, product) || visit(product);
+    });
+}
+
+uint64_t ProductIndex::size() {
+    return file.refresh() ? file.index(BY_ID).size() : 0;
+}
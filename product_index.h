@@ -0,0 +1,46 @@
+#ifndef PRODUCT_INDEX_H
+#define PRODUCT_INDEX_H
+
+#include <string>
+#include <functional>
+#include "product.h"
+#include "csv_index.h"
+
+using namespace std;
+
+// On-disk B+-tree indexes over a product CSV file, one by productID
+// (<file>.id.idx) and one by lowercase name (<file>.name.idx), whose
+// entries point at the record's bytes. Lookups read the index and data
+// pages through page caches and parse only the records they return, so
+// opening a catalog costs the same whatever its size.
+//
+// Each index records the size and modification time of the file it was
+// built from. A query first checks the file; if it has changed, both
+// indexes are rebuilt in one pass over it (sorting in memory) before the
+// query runs.
+class ProductIndex {
+private:
+    IndexedFile file;
+
+    bool readProduct(RecordRef ref, Product& product);
+
+public:
+    // `cacheBytes` is split between the data and index page caches
+    explicit ProductIndex(const string& filename, size_t cacheBytes = 8 << 20);
+
+    bool findByID(int id, Product& product);
+
+    // Products whose name starts with `prefix`, ignoring case, in name order
+    void scanNamePrefix(const string& prefix, const function<bool(Product&)>& visit);
+
+    // Every product in ID order
+    void scanByID(const function<bool(Product&)>& visit);
+
+    uint64_t size();
+
+    // Page reads served from memory and from disk, over all three caches
+    uint64_t cacheHits() const { return file.cacheHits(); }
+    uint64_t cacheMisses() const { return file.cacheMisses(); }
+};
+
+#endif
@@ -0,0 +1,224 @@
+#include "reports.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include "csv.h"
+#include "parallel.h"
+#include "trace.h"
+
+namespace {
+
+// Sums of float prices pick up noise past the cents; exports show money
+// to the cent
+double toCents(double amount) {
+    return round(amount * 100.0) / 100.0;
+}
+
+}  // namespace
+
+vector<ProductSales> Reports::topProducts(const vector<Order>& orders, size_t n, size_t threadCount) {
+    TRACE_SCOPE("Reports::topProducts");
+    typedef unordered_map<int, ProductSales> SalesMap;
+
+    SalesMap totals = parallelReduce<SalesMap>(orders.size(),
+        [&orders](size_t begin, size_t end) {
+            SalesMap partial;
+            for (size_t i = begin; i < end; ++i) {
+                if (orders[i].getStatus() == ORDER_CANCELLED) continue;
+                for (const auto& item : orders[i].getItems()) {
+                    auto it = partial.find(item.productID);
+                    if (it == partial.end()) {
+                        partial[item.productID] = {item.productID, item.productName, item.quantity, item.subtotal};
+                    } else {
+                        it->second.unitsSold += item.quantity;
+                        it->second.revenue += item.subtotal;
+                    }
+                }
+            }
+            return partial;
+        },
+        [](SalesMap& into, const SalesMap& from) {
+            for (const auto& entry : from) {
+                auto it = into.find(entry.first);
+                if (it == into.end()) {
+                    into.insert(entry);
+                } else {
+                    it->second.unitsSold += entry.second.unitsSold;
+                    it->second.revenue += entry.second.revenue;
+                }
+            }
+        },
+        threadCount);
+
+    vector<ProductSales> ranked;
+    ranked.reserve(totals.size());
+    for (const auto& entry : totals) ranked.push_back(entry.second);
+
+    n = min(n, ranked.size());
+    partial_sort(ranked.begin(), ranked.begin() + n, ranked.end(),
+                 [](const ProductSales& a, const ProductSales& b) { return a.revenue > b.revenue; });
+    ranked.resize(n);
+    return ranked;
+}
+
+vector<CustomerRevenue> Reports::revenueByCustomer(const vector<Order>& orders, size_t threadCount) {
+    TRACE_SCOPE("Reports::revenueByCustomer");
+    typedef unordered_map<int, CustomerRevenue> CustomerMap;
+
+    CustomerMap totals = parallelReduce<CustomerMap>(orders.size(),
+        [&orders](size_t begin, size_t end) {
+            CustomerMap partial;
+            for (size_t i = begin; i < end; ++i) {
+                const Order& order = orders[i];
+                if (order.getStatus() == ORDER_CANCELLED) continue;
+                auto it = partial.find(order.getCustomerID());
+                if (it == partial.end()) {
+                    partial[order.getCustomerID()] = {order.getCustomerID(), order.getCustomerName(), 1, order.getTotalAmount()};
+                } else {
+                    it->second.orderCount++;
+                    it->second.revenue += order.getTotalAmount();
+                }
+            }
+            return partial;
+        },
+        [](CustomerMap& into, const CustomerMap& from) {
+            for (const auto& entry : from) {
+                auto it = into.find(entry.first);
+                if (it == into.end()) {
+                    into.insert(entry);
+                } else {
+                    it->second.orderCount += entry.second.orderCount;
+                    it->second.revenue += entry.second.revenue;
+                }
+            }
+        },
+        threadCount);
+
+    vector<CustomerRevenue> ranked;
+    ranked.reserve(totals.size());
+    for (const auto& entry : totals) ranked.push_back(entry.second);
+    sort(ranked.begin(), ranked.end(),
+         [](const CustomerRevenue& a, const CustomerRevenue& b) { return a.revenue > b.revenue; });
+    return ranked;
+}
+
+StockValuation Reports::stockValuation(const vector<Product>& inventory, size_t threadCount) {
+    TRACE_SCOPE("Reports::stockValuation");
+    return parallelReduce<StockValuation>(inventory.size(),
+        [&inventory](size_t begin, size_t end) {
+            StockValuation partial{0, 0.0, {}};
+            for (size_t i = begin; i < end; ++i) {
+                const Product& product = inventory[i];
+                double value = static_cast<double>(product.getPrice()) * product.getQuantity();
+                partial.totalUnits += product.getQuantity();
+                partial.totalValue += value;
+                partial.valueByCategory[product.getCategory()] += value;
+            }
+            return partial;
+        },
+        [](StockValuation& into, const StockValuation& from) {
+            into.totalUnits += from.totalUnits;
+            into.totalValue += from.totalValue;
+            for (const auto& entry : from.valueByCategory) into.valueByCategory[entry.first] += entry.second;
+        },
+        threadCount);
+}
+
+StatusBreakdown Reports::statusBreakdown(const vector<Order>& orders, size_t threadCount) {
+    TRACE_SCOPE("Reports::statusBreakdown");
+    return parallelReduce<StatusBreakdown>(orders.size(),
+        [&orders](size_t begin, size_t end) {
+            StatusBreakdown partial{};
+            for (size_t i = begin; i < end; ++i) {
+                int status = orders[i].getStatus();
+                if (status < ORDER_PENDING || status > ORDER_CANCELLED) continue;
+                partial.orderCount[status]++;
+                partial.revenue[status] += orders[i].getTotalAmount();
+            }
+            return partial;
+        },
+        [](StatusBreakdown& into, const StatusBreakdown& from) {
+            for (int s = ORDER_PENDING; s <= ORDER_CANCELLED; ++s) {
+                into.orderCount[s] += from.orderCount[s];
+                into.revenue[s] += from.revenue[s];
+            }
+        },
+        threadCount);
+}
+
+bool Reports::saveTopProducts(const vector<ProductSales>& report, const string& filename) {
+    TRACE_SCOPE("Reports::saveTopProducts");
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << "productID,productName,unitsSold,revenue\n";
+    {
+        CsvWriter writer(file);
+        for (const auto& row : report) {
+            writer.field(row.productID);
+            writer.field(row.productName);
+            writer.field(row.unitsSold);
+            writer.field(toCents(row.revenue));
+            writer.endRow();
+        }
+    }
+    file.close();
+    return !file.fail();
+}
+
+bool Reports::saveRevenueByCustomer(const vector<CustomerRevenue>& report, const string& filename) {
+    TRACE_SCOPE("Reports::saveRevenueByCustomer");
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << "customerID,customerName,orderCount,revenue\n";
+    {
+        CsvWriter writer(file);
+        for (const auto& row : report) {
+            writer.field(row.customerID);
+            writer.field(row.customerName);
+            writer.field(row.orderCount);
+            writer.field(toCents(row.revenue));
+            writer.endRow();
+        }
+    }
+    file.close();
+    return !file.fail();
+}
+
+bool Reports::saveStockValuation(const StockValuation& report, const string& filename) {
+    TRACE_SCOPE("Reports::saveStockValuation");
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << "category,value\n";
+    {
+        CsvWriter writer(file);
+        for (const auto& entry : report.valueByCategory) {
+            writer.field(entry.first);
+            writer.field(toCents(entry.second));
+            writer.endRow();
+        }
+        writer.field("TOTAL");
+        writer.field(toCents(report.totalValue));
+        writer.endRow();
+    }
+    file.close();
+    return !file.fail();
+}
+
+bool Reports::saveStatusBreakdown(const StatusBreakdown& report, const string& filename) {
+    TRACE_SCOPE("Reports::saveStatusBreakdown");
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << "status,orderCount,revenue\n";
+    {
+        CsvWriter writer(file);
+        for (int s = ORDER_PENDING; s <= ORDER_CANCELLED; ++s) {
+            writer.field(Order::statusToString(static_cast<OrderStatus>(s)));
+            writer.field(report.orderCount[s]);
+            writer.field(toCents(report.revenue[s]));
+            writer.endRow();
+        }
+    }
+    file.close();
+    return !file.fail();
+}
@@ -0,0 +1,61 @@
+#ifndef REPORTS_H
+#define REPORTS_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "product.h"
+#include "order.h"
+
+using namespace std;
+
+struct ProductSales {
+    int productID;
+    string productName;
+    int unitsSold;
+    double revenue;
+};
+
+struct CustomerRevenue {
+    int customerID;
+    string customerName;
+    int orderCount;
+    double revenue;
+};
+
+struct StockValuation {
+    long long totalUnits;
+    double totalValue;
+    unordered_map<string, double> valueByCategory;
+};
+
+struct StatusBreakdown {
+    int orderCount[ORDER_CANCELLED + 1];
+    double revenue[ORDER_CANCELLED + 1];
+};
+
+// Aggregate reports over the order and inventory stores. Each report is
+// computed with parallelReduce; threadCount = 0 uses every core.
+class Reports {
+public:
+    // Best-selling products by revenue (cancelled orders excluded)
+    static vector<ProductSales> topProducts(const vector<Order>& orders, size_t n, size_t threadCount = 0);
+
+    // Revenue and order count per customer, highest revenue first
+    static vector<CustomerRevenue> revenueByCustomer(const vector<Order>& orders, size_t threadCount = 0);
+
+    // Value of the stock on hand (price x quantity), overall and per category
+    static StockValuation stockValuation(const vector<Product>& inventory, size_t threadCount = 0);
+
+    // Number of orders and their value in each status
+    static StatusBreakdown statusBreakdown(const vector<Order>& orders, size_t threadCount = 0);
+
+    // ========== CSV export ==========
+    static bool saveTopProducts(const vector<ProductSales>& report, const string& filename);
+    static bool saveRevenueByCustomer(const vector<CustomerRevenue>& report, const string& filename);
+    static bool saveStockValuation(const StockValuation& report, const string& filename);
+    static bool saveStatusBreakdown(const StatusBreakdown& report, const string& filename);
+};
+
+#endif
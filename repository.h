@@ -0,0 +1,114 @@
+#ifndef REPOSITORY_H
+#define REPOSITORY_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdio>
+#include "codec.h"
+
+using namespace std;
+
+// File-backed storage for one entity type, generated from its EntityTraits
+// field table (see codec.h). Format picks the on-disk encoding at compile
+// time: CsvFormat for the data files, BinaryFormat for compact caches.
+template <typename T, typename Format = CsvFormat, typename Traits = EntityTraits<T>>
+class Repository {
+private:
+    string filename;
+
+public:
+    explicit Repository(const string& file) : filename(file) {}
+
+    const string& getFilename() const { return filename; }
+
+    // Write `record` in this repository's format
+    static void serialize(ostream& out, const T& record) {
+        Format::template write<T, Traits>(out, record);
+    }
+
+    // Stream every well-formed record to visit(record) until it returns false
+    template <typename Visit>
+    void scan(Visit visit) const {
+        ifstream file(filename, ios::in | Format::MODE);
+        typename Format::Reader reader(file);
+        ReadResult result;
+        do {
+            T record;
+            result = reader.template read<T, Traits>(record);
+            if (result == READ_OK && !visit(record)) return;
+        } while (result != READ_END);
+    }
+
+    vector<T> loadAll() const {
+        vector<T> records;
+        scan([&records](T& record) {
+            records.push_back(move(record));
+            return true;
+        });
+        return records;
+    }
+
+    // First record matching `predicate`
+    template <typename Predicate>
+    bool findFirst(Predicate predicate, T& result) const {
+        bool found = false;
+        scan([&](T& record) {
+            if (!predicate(record)) return true;
+            result = move(record);
+            found = true;
+            return false;
+        });
+        return found;
+    }
+
+    bool findByKey(int key, T& result) const {
+        return findFirst([key](const T& record) { return Traits::keyOf(record) == key; }, result);
+    }
+
+    // Each write reports failure if the stream does, including when the
+    // data only reaches the disk on close()
+    bool append(const T& record) const {
+        ofstream file(filename, ios::app | Format::MODE);
+        if (!file.is_open()) return false;
+        serialize(file, record);
+        file.close();
+        return !file.fail();
+    }
+
+    bool appendAll(const vector<T>& records) const {
+        ofstream file(filename, ios::app | Format::MODE);
+        if (!file.is_open()) return false;
+        Format::template writeAll<T, Traits>(file, records);
+        file.close();
+        return !file.fail();
+    }
+
+    // Rewrite the whole file from `records`: written to a copy that is
+    // renamed over the file, so a failed or interrupted save leaves the old
+    // file as it was
+    bool saveAll(const vector<T>& records) const {
+        string temporary = filename + ".tmp";
+        ofstream file(temporary, ios::out | ios::trunc | Format::MODE);
+        if (!file.is_open()) return false;
+        Format::template writeAll<T, Traits>(file, records);
+        file.close();
+        if (file.fail() || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Position of each record in `records` by primary key
+    static unordered_map<int, size_t> buildIndex(const vector<T>& records) {
+        unordered_map<int, size_t> index;
+        index.reserve(records.size());
+        for (size_t i = 0; i < records.size(); ++i) index.emplace(Traits::keyOf(records[i]), i);
+        return index;
+    }
+};
+
+#endif
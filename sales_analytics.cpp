@@ -0,0 +1,77 @@
+#include "sales_analytics.h"
+
+#include "parallel.h"
+#include "trace.h"
+
+string SalesAnalytics::categoryOf(int productID) const {
+    auto it = productCategories.find(productID);
+    return it != productCategories.end() ? it->second : "Uncategorized";
+}
+
+void SalesAnalytics::apply(const Order& order, int sign) {
+    long long day = dayBucket(order.getOrderDate());
+    for (const auto& item : order.getItems()) {
+        double amount = sign * static_cast<double>(item.subtotal);
+        revenueByProduct[item.productID] += amount;
+        revenueByCategory[categoryOf(item.productID)] += amount;
+        revenueByDay[day] += amount;
+        totalRevenue += amount;
+    }
+}
+
+void SalesAnalytics::merge(const SalesAnalytics& other) {
+    for (const auto& entry : other.revenueByProduct) revenueByProduct[entry.first] += entry.second;
+    for (const auto& entry : other.revenueByCategory) revenueByCategory[entry.first] += entry.second;
+    for (const auto& entry : other.revenueByDay) revenueByDay[entry.first] += entry.second;
+    totalRevenue += other.totalRevenue;
+}
+
+void SalesAnalytics::setCatalog(const vector<Product>& inventory) {
+    productCategories.clear();
+    productCategories.reserve(inventory.size());
+    for (const auto& product : inventory) {
+        productCategories[product.getID()] = product.getCategory();
+    }
+}
+
+void SalesAnalytics::recordStatusChange(const Order& order, OrderStatus oldStatus, OrderStatus newStatus) {
+    if (oldStatus != ORDER_CANCELLED && newStatus == ORDER_CANCELLED) {
+        apply(order, -1);
+    } else if (oldStatus == ORDER_CANCELLED && newStatus != ORDER_CANCELLED) {
+        apply(order, 1);
+    }
+}
+
+void SalesAnalytics::rebuildFromHistory(const vector<Order>& orders, const vector<Product>& inventory) {
+    TRACE_SCOPE("SalesAnalytics::rebuildFromHistory");
+    setCatalog(inventory);
+    revenueByProduct.clear();
+    revenueByCategory.clear();
+    revenueByDay.clear();
+    totalRevenue = 0.0;
+
+    SalesAnalytics totals = parallelReduce<SalesAnalytics>(orders.size(),
+        [this, &orders](size_t begin, size_t end) {
+            SalesAnalytics partial;
+            partial.productCategories = productCategories;
+            for (size_t i = begin; i < end; ++i) partial.recordOrder(orders[i]);
+            return partial;
+        },
+        [](SalesAnalytics& into, const SalesAnalytics& from) { into.merge(from); });
+    merge(totals);
+}
+
+double SalesAnalytics::getProductRevenue(int productID) const {
+    auto it = revenueByProduct.find(productID);
+    return it != revenueByProduct.end() ? it->second : 0.0;
+}
+
+double SalesAnalytics::getCategoryRevenue(const string& category) const {
+    auto it = revenueByCategory.find(category);
+    return it != revenueByCategory.end() ? it->second : 0.0;
+}
+
+double SalesAnalytics::getDayRevenue(time_t date) const {
+    auto it = revenueByDay.find(dayBucket(date));
+    return it != revenueByDay.end() ? it->second : 0.0;
+}
@@ -0,0 +1,67 @@
+#ifndef SALES_ANALYTICS_H
+#define SALES_ANALYTICS_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ctime>
+#include "product.h"
+#include "order.h"
+
+using namespace std;
+
+// Running revenue totals kept up to date as orders are created or cancelled,
+// so dashboard queries never have to walk the order history.
+class SalesAnalytics {
+private:
+    unordered_map<int, double> revenueByProduct;
+    unordered_map<string, double> revenueByCategory;
+    unordered_map<long long, double> revenueByDay;
+    unordered_map<int, string> productCategories;
+    double totalRevenue;
+
+    static long long dayBucket(time_t date) {
+        return static_cast<long long>(date) / 86400;
+    }
+
+    string categoryOf(int productID) const;
+
+    // Add (sign = 1) or remove (sign = -1) an order's items from the totals
+    void apply(const Order& order, int sign);
+
+    void merge(const SalesAnalytics& other);
+
+public:
+    SalesAnalytics() {
+        totalRevenue = 0.0;
+    }
+
+    // Remember which category each product belongs to
+    void setCatalog(const vector<Product>& inventory);
+
+    void registerProduct(const Product& product) {
+        productCategories[product.getID()] = product.getCategory();
+    }
+
+    // Count a newly committed order
+    void recordOrder(const Order& order) {
+        if (order.getStatus() != ORDER_CANCELLED) apply(order, 1);
+    }
+
+    // Keep totals in sync with a status change; cancellations subtract
+    void recordStatusChange(const Order& order, OrderStatus oldStatus, OrderStatus newStatus);
+
+    // Recompute every total from the order history, one partition per thread
+    void rebuildFromHistory(const vector<Order>& orders, const vector<Product>& inventory);
+
+    double getTotalRevenue() const { return totalRevenue; }
+
+    double getProductRevenue(int productID) const;
+    double getCategoryRevenue(const string& category) const;
+    double getDayRevenue(time_t date) const;
+
+    const unordered_map<int, double>& getRevenueByProduct() const { return revenueByProduct; }
+    const unordered_map<string, double>& getRevenueByCategory() const { return revenueByCategory; }
+};
+
+#endif
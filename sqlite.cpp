@@ -0,0 +1,110 @@
+#include "sqlite.h"
+
+#include <sqlite3.h>
+
+SqliteStatement::~SqliteStatement() {
+    if (statement == nullptr) return;
+    if (owned) sqlite3_finalize(statement);
+    else sqlite3_reset(statement);
+}
+
+void SqliteStatement::bind(int index, long long value) {
+    if (statement == nullptr) return;
+    if (sqlite3_bind_int64(statement, index, value) != SQLITE_OK) failed = true;
+}
+
+void SqliteStatement::bind(int index, double value) {
+    if (statement == nullptr) return;
+    if (sqlite3_bind_double(statement, index, value) != SQLITE_OK) failed = true;
+}
+
+void SqliteStatement::bind(int index, string_view text) {
+    if (statement == nullptr) return;
+    // SQLITE_STATIC: the caller keeps the text alive until the statement has run
+    if (sqlite3_bind_text(statement, index, text.data(), static_cast<int>(text.size()), SQLITE_STATIC) != SQLITE_OK) {
+        failed = true;
+    }
+}
+
+bool SqliteStatement::next() {
+    if (failed) return false;
+    int result = sqlite3_step(statement);
+    if (result == SQLITE_ROW) return true;
+    if (result != SQLITE_DONE) failed = true;
+    return false;
+}
+
+bool SqliteStatement::run() {
+    next();
+    return !failed;
+}
+
+long long SqliteStatement::columnInt(int index) const {
+    return sqlite3_column_int64(statement, index);
+}
+
+double SqliteStatement::columnDouble(int index) const {
+    return sqlite3_column_double(statement, index);
+}
+
+string_view SqliteStatement::columnText(int index) const {
+    const unsigned char* text = sqlite3_column_text(statement, index);
+    if (text == nullptr) return string_view();
+    return string_view(reinterpret_cast<const char*>(text), sqlite3_column_bytes(statement, index));
+}
+
+SqliteDatabase::~SqliteDatabase() {
+    close();
+}
+
+bool SqliteDatabase::open(const string& path) {
+    close();
+    if (sqlite3_open(path.c_str(), &db) != SQLITE_OK) {
+        sqlite3_close(db);
+        db = nullptr;
+        return false;
+    }
+    sqlite3_busy_timeout(db, 5000);
+    return exec("PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;");
+}
+
+void SqliteDatabase::close() {
+    for (auto& entry : statements) sqlite3_finalize(entry.second);
+    statements.clear();
+    knownTables.clear();
+    if (db != nullptr) sqlite3_close(db);
+    db = nullptr;
+}
+
+bool SqliteDatabase::exec(const string& sql) {
+    if (db == nullptr) return false;
+    return sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+SqliteStatement SqliteDatabase::prepare(const string& sql) {
+    if (db == nullptr) return SqliteStatement(nullptr, false);
+
+    auto found = statements.find(sql);
+    if (found != statements.end() && !sqlite3_stmt_busy(found->second)) {
+        sqlite3_clear_bindings(found->second);
+        return SqliteStatement(found->second, false);
+    }
+
+    sqlite3_stmt* statement = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), static_cast<int>(sql.size()), &statement, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(statement);
+        return SqliteStatement(nullptr, false);
+    }
+    if (found != statements.end()) return SqliteStatement(statement, true);
+    statements.emplace(sql, statement);
+    return SqliteStatement(statement, false);
+}
+
+int SqliteDatabase::changes() const {
+    return db == nullptr ? 0 : sqlite3_changes(db);
+}
+
+string SqliteDatabase::lastError() const {
+    if (db == nullptr) return "database is not open";
+    return sqlite3_errmsg(db);
+}
@@ -0,0 +1,99 @@
+#ifndef SQLITE_H
+#define SQLITE_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+// A prepared statement on loan from SqliteDatabase's cache, with its
+// bindings cleared. It is reset when the loan ends, which also ends the
+// read it may hold open. Parameters are numbered from 1, result columns
+// from 0.
+class SqliteStatement {
+private:
+    sqlite3_stmt* statement;
+    bool owned;  // a private copy, finalized rather than returned to the cache
+    bool failed;
+
+public:
+    SqliteStatement(sqlite3_stmt* prepared, bool ownStatement)
+        : statement(prepared), owned(ownStatement), failed(prepared == nullptr) {}
+    SqliteStatement(SqliteStatement&& other) noexcept
+        : statement(other.statement), owned(other.owned), failed(other.failed) {
+        other.statement = nullptr;
+    }
+    ~SqliteStatement();
+
+    SqliteStatement(const SqliteStatement&) = delete;
+    SqliteStatement& operator=(const SqliteStatement&) = delete;
+
+    bool valid() const { return statement != nullptr; }
+
+    void bind(int index, long long value);
+    void bind(int index, double value);
+    void bind(int index, string_view text);
+
+    // Advance to the next result row; false when there are no more rows
+    // or the statement failed (see ok())
+    bool next();
+
+    // Run a statement that returns no rows
+    bool run();
+
+    bool ok() const { return !failed; }
+
+    long long columnInt(int index) const;
+    double columnDouble(int index) const;
+    string_view columnText(int index) const;
+};
+
+// One connection, with its prepared statements cached by SQL text, so
+// repeated queries skip the parser. Opened in WAL mode with
+// synchronous=NORMAL: a commit survives a process crash, though the
+// last transactions may be lost on power failure.
+class SqliteDatabase {
+private:
+    sqlite3* db;
+    unordered_map<string, sqlite3_stmt*> statements;
+    unordered_set<string> knownTables;
+
+public:
+    SqliteDatabase() : db(nullptr) {}
+    ~SqliteDatabase();
+
+    SqliteDatabase(const SqliteDatabase&) = delete;
+    SqliteDatabase& operator=(const SqliteDatabase&) = delete;
+
+    bool open(const string& path);
+    void close();
+    bool isOpen() const { return db != nullptr; }
+
+    // Run one or more statements without results
+    bool exec(const string& sql);
+
+    // The cached statement for `sql`, or a private one while the cached
+    // statement is still on loan (a query issued from inside a scan)
+    SqliteStatement prepare(const string& sql);
+
+    bool begin() { return exec("BEGIN"); }
+    bool commit() { return exec("COMMIT"); }
+    void rollback() { exec("ROLLBACK"); }
+
+    // True the first time `table` is seen on this connection, so schema
+    // setup runs once per table rather than once per query
+    bool firstUse(const string& table) { return knownTables.insert(table).second; }
+
+    // Rows changed by the last INSERT, UPDATE or DELETE
+    int changes() const;
+
+    // Text of the most recent error
+    string lastError() const;
+};
+
+#endif
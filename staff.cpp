@@ -0,0 +1,102 @@
+#include "staff.h"
+
+#include "storage.h"
+#include "metrics.h"
+#include "trace.h"
+
+IdSequence Staff::ids;
+
+Staff::Staff() {
+    staffID = 0;
+    username = "";
+    password = "";
+    name = "Unnamed";
+    phone = "";
+    email = "";
+    role = STAFF;
+}
+
+Staff::Staff(string u, string p, string n, string ph, string e, Role r) {
+    staffID = ids.next();
+    username = u;
+    password = p;
+    name = n;
+    phone = ph;
+    email = e;
+    role = r;
+}
+
+void Staff::display() const {
+    cout << "┌─────────────────────────────────────────┐\n";
+    cout << "│ " << CYAN << BOLD << "Staff ID: " << RESET << staffID << string(32 - to_string(staffID).length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Username: " << RESET << username << string(32 - username.length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Name: " << RESET << name << string(37 - name.length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Phone: " << RESET << phone << string(36 - phone.length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Email: " << RESET << email << string(36 - email.length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Role: " << RESET << getRoleString() << string(37 - getRoleString().length(), ' ') << "│\n";
+    cout << "└─────────────────────────────────────────┘\n";
+}
+
+string Staff::getRoleString() const {
+    switch (role) {
+        case ADMIN: return "Admin";
+        case MANAGER: return "Manager";
+        case STAFF: return "Staff";
+        default: return "Unknown";
+    }
+}
+
+void Staff::writeRow(ostream& out) const {
+    Repository<Staff>::serialize(out, *this);
+}
+
+void Staff::saveToFile(const string& filename) const {
+    TRACE_SCOPE("Staff::saveToFile");
+    static Counter rowsWritten("wms_rows_written_total", "Records written by saves and rewrites", "entity=\"staff\"");
+    rowsWritten.increment();
+    
+    if (!Storage::open<Staff>(filename)->append(*this)) {
+        cout << "Unable to open file for writing\n";
+    }
+}
+
+void Staff::saveAllToFile(const string& filename, const vector<Staff>& staffList) {
+    TRACE_SCOPE("Staff::saveAllToFile");
+    static Histogram rewriteTime("wms_rewrite_seconds", "Time to rewrite a data file", "entity=\"staff\"");
+    static Counter rowsWritten("wms_rows_written_total", "Records written by saves and rewrites", "entity=\"staff\"");
+    ScopedTimer timer(rewriteTime);
+    
+    if (!Storage::open<Staff>(filename)->saveAll(staffList)) {
+        cout << "Unable to open file for writing\n";
+        return;
+    }
+    rowsWritten.increment(staffList.size());
+}
+
+Staff Staff::loadFromFile(const string& filename, int id) {
+    TRACE_SCOPE("Staff::loadFromFile");
+    Staff record;
+    if (Storage::open<Staff>(filename)->findByKey(id, record)) return record;
+    return Staff();
+}
+
+vector<Staff> Staff::loadAllFromFile(const string& filename) {
+    TRACE_SCOPE("Staff::loadAllFromFile");
+    static Histogram loadTime("wms_load_seconds", "Time to load a data file", "entity=\"staff\"");
+    static Counter rowsLoaded("wms_rows_loaded_total", "Records parsed by the loaders", "entity=\"staff\"");
+    ScopedTimer timer(loadTime);
+    
+    vector<Staff> staffList = Storage::open<Staff>(filename)->loadAll();
+    rowsLoaded.increment(staffList.size());
+    return staffList;
+}
+
+Staff Staff::findByUsername(const string& filename, const string& username) {
+    TRACE_SCOPE("Staff::findByUsername");
+    static Histogram lookupTime("wms_lookup_seconds", "Time to look a record up by key", "kind=\"staff_username\"");
+    ScopedTimer timer(lookupTime);
+    
+    Staff record;
+    if (Storage::open<Staff>(filename)->findBy("username", username, record)) return record;
+    return Staff();
+}
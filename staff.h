@@ -3,10 +3,10 @@
 
 #include <iostream>
 #include <string>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include "utils.h"
+#include "repository.h"
+#include "id_sequence.h"
 
 using namespace std;
 
@@ -18,7 +18,8 @@ enum Role {
 
 class Staff {
 private:
-    static int nextID;
+    friend struct EntityTraits<Staff>;
+
     int staffID;
     string username;
     string password;
@@ -28,25 +29,12 @@ private:
     Role role;
 
 public:
-    Staff() {
-        staffID = nextID++;
-        username = "";
-        password = "";
-        name = "Unnamed";
-        phone = "";
-        email = "";
-        role = STAFF;
-    }
+    // Where new records get their IDs; see IdSequence
+    static IdSequence ids;
 
-    Staff(string u, string p, string n, string ph, string e, Role r) {
-        staffID = nextID++;
-        username = u;
-        password = p;
-        name = n;
-        phone = ph;
-        email = e;
-        role = r;
-    }
+    // A blank record with ID 0, for loaders to fill in
+    Staff();
+    Staff(string u, string p, string n, string ph, string e, Role r);
 
     int getID() const { return staffID; }
     string getUsername() const { return username; }
@@ -68,150 +56,34 @@ public:
         return password == pwd;
     }
 
-    void display() const {
-        cout << "┌─────────────────────────────────────────┐\n";
-        cout << "│ " << CYAN << BOLD << "Staff ID: " << RESET << staffID << string(32 - to_string(staffID).length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Username: " << RESET << username << string(32 - username.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Name: " << RESET << name << string(37 - name.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Phone: " << RESET << phone << string(36 - phone.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Email: " << RESET << email << string(36 - email.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Role: " << RESET << getRoleString() << string(37 - getRoleString().length(), ' ') << "│\n";
-        cout << "└─────────────────────────────────────────┘\n";
-    }
-
-    string getRoleString() const {
-        switch (role) {
-            case ADMIN: return "Admin";
-            case MANAGER: return "Manager";
-            case STAFF: return "Staff";
-            default: return "Unknown";
-        }
-    }
-
-    void saveToFile(const string& filename) const {
-        ofstream file(filename, ios::app);
-        if (file.is_open()) {
-            file << staffID << "," << username << "," << password << "," 
-                 << name << "," << phone << "," << email << "," << role << "\n";
-            file.close();
-        } else {
-            cout << "Unable to open file for writing\n";
-        }
-    }
+    void display() const;
+    string getRoleString() const;
 
-    static Staff loadFromFile(const string& filename, int id) {
-        ifstream file(filename);
-        string line;
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            int fileID;
-            string fileUsername, filePassword, fileName, filePhone, fileEmail;
-            int fileRole;
-            
-            getline(ss, field, ',');
-            fileID = stoi(field);
-            getline(ss, fileUsername, ',');
-            getline(ss, filePassword, ',');
-            getline(ss, fileName, ',');
-            getline(ss, filePhone, ',');
-            getline(ss, fileEmail, ',');
-            getline(ss, field);
-            fileRole = stoi(field);
-            
-            if (fileID == id) {
-                Staff s;
-                s.staffID = fileID;
-                s.username = fileUsername;
-                s.password = filePassword;
-                s.name = fileName;
-                s.phone = filePhone;
-                s.email = fileEmail;
-                s.role = static_cast<Role>(fileRole);
-                return s;
-            }
-        }
-        file.close();
-        return Staff();
-    }
+    // Write this staff as one CSV row
+    void writeRow(ostream& out) const;
+    void saveToFile(const string& filename) const;
 
-    static vector<Staff> loadAllFromFile(const string& filename) {
-        ifstream file(filename);
-        string line;
-        vector<Staff> staffList;
-        
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            int fileID;
-            string fileUsername, filePassword, fileName, filePhone, fileEmail;
-            int fileRole;
-            
-            getline(ss, field, ',');
-            fileID = stoi(field);
-            getline(ss, fileUsername, ',');
-            getline(ss, filePassword, ',');
-            getline(ss, fileName, ',');
-            getline(ss, filePhone, ',');
-            getline(ss, fileEmail, ',');
-            getline(ss, field);
-            fileRole = stoi(field);
-            
-            Staff s;
-            s.staffID = fileID;
-            s.username = fileUsername;
-            s.password = filePassword;
-            s.name = fileName;
-            s.phone = filePhone;
-            s.email = fileEmail;
-            s.role = static_cast<Role>(fileRole);
-            staffList.push_back(s);
-        }
-        file.close();
-        return staffList;
-    }
+    // Rewrite the whole file from `staffList`
+    static void saveAllToFile(const string& filename, const vector<Staff>& staffList);
 
-    static Staff findByUsername(const string& filename, const string& username) {
-        ifstream file(filename);
-        string line;
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            int fileID;
-            string fileUsername, filePassword, fileName, filePhone, fileEmail;
-            int fileRole;
-            
-            getline(ss, field, ',');
-            fileID = stoi(field);
-            getline(ss, fileUsername, ',');
-            
-            if (fileUsername == username) {
-                getline(ss, filePassword, ',');
-                getline(ss, fileName, ',');
-                getline(ss, filePhone, ',');
-                getline(ss, fileEmail, ',');
-                getline(ss, field);
-                fileRole = stoi(field);
-                
-                Staff s;
-                s.staffID = fileID;
-                s.username = fileUsername;
-                s.password = filePassword;
-                s.name = fileName;
-                s.phone = filePhone;
-                s.email = fileEmail;
-                s.role = static_cast<Role>(fileRole);
-                file.close();
-                return s;
-            } else {
-                getline(ss, field);
-            }
-        }
-        file.close();
-        return Staff();
-    }
+    static Staff loadFromFile(const string& filename, int id);
+    static vector<Staff> loadAllFromFile(const string& filename);
+    static Staff findByUsername(const string& filename, const string& username);
 };
 
-int Staff::nextID = 1;
+template <>
+struct EntityTraits<Staff> {
+    static constexpr auto fields = make_tuple(
+        field("staffID", &Staff::staffID),
+        field("username", &Staff::username),
+        field("password", &Staff::password),
+        field("name", &Staff::name),
+        field("phone", &Staff::phone),
+        field("email", &Staff::email),
+        field("role", &Staff::role));
+
+    static int keyOf(const Staff& staff) { return staff.staffID; }
+    static constexpr const char* lookup = "username";
+};
 
 #endif
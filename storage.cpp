@@ -0,0 +1,69 @@
+#include "storage.h"
+
+StorageKind Storage::kind = STORAGE_CSV;
+#ifdef WMS_SQLITE
+SqliteDatabase Storage::database;
+#endif
+string Storage::databasePath;
+string Storage::lsmDirectory;
+map<string, unique_ptr<LsmStore>> Storage::lsmStores;
+
+bool Storage::use(StorageKind backend, const string& path) {
+    if (backend == STORAGE_CSV) {
+        kind = STORAGE_CSV;
+        return true;
+    }
+    if (backend == STORAGE_LSM) {
+        // Stores open lazily, one per table, the first time it is used
+        if (path != lsmDirectory) lsmStores.clear();
+        lsmDirectory = path;
+        kind = STORAGE_LSM;
+        return true;
+    }
+#ifdef WMS_SQLITE
+    if (!database.open(path)) {
+        cout << "Unable to open database " << path << ": " << database.lastError() << "\n";
+        return false;
+    }
+    databasePath = path;
+    kind = STORAGE_SQLITE;
+    return true;
+#else
+    (void)path;
+    cout << "This build has no SQLite support\n";
+    return false;
+#endif
+}
+
+LsmStore& Storage::lsmStore(const string& table) {
+    auto found = lsmStores.find(table);
+    if (found != lsmStores.end()) return *found->second;
+
+    unique_ptr<LsmStore> store(new LsmStore());
+    string path = lsmDirectory + "/" + table;
+    // A store that fails to open refuses every operation, like an
+    // unreadable CSV file
+    if (!store->open(path)) cout << "Unable to open store " << path << "\n";
+    return *lsmStores.emplace(table, move(store)).first->second;
+}
+
+string Storage::tableFor(const string& location) {
+    size_t start = location.find_last_of("/\\");
+    start = start == string::npos ? 0 : start + 1;
+    size_t end = location.find('.', start);
+    if (end == string::npos) end = location.size();
+
+    string table;
+    for (size_t i = start; i < end; ++i) {
+        char c = location[i];
+        bool plain = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        table += plain ? c : '_';
+    }
+    return table.empty() ? "records" : table;
+}
+
+string Storage::sequenceFile(const string& location) {
+    if (kind == STORAGE_SQLITE) return databasePath + "." + tableFor(location) + ".ids";
+    if (kind == STORAGE_LSM) return lsmDirectory + "/" + tableFor(location) + ".ids";
+    return location + ".ids";
+}
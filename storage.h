@@ -0,0 +1,564 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <map>
+#include <cstdio>
+#include "repository.h"
+#include "lsm.h"
+#ifdef WMS_SQLITE
+#include "sqlite.h"
+#endif
+
+using namespace std;
+
+// Where the entity loaders and savers keep their records. Each entity's
+// persistence functions take a location (the CSV file name they always
+// took) and open a StorageBackend for it through Storage::open, so the
+// whole application switches backends with Storage::use.
+template <typename T>
+class StorageBackend {
+public:
+    virtual ~StorageBackend() {}
+
+    // Stream every record to visit(record) until it returns false
+    virtual void scan(const function<bool(T&)>& visit) const = 0;
+    virtual vector<T> loadAll() const = 0;
+
+    virtual bool findByKey(int key, T& result) const = 0;
+    // First record whose text column `column` equals `value`
+    virtual bool findBy(const char* column, const string& value, T& result) const = 0;
+    // Every record whose integer column `column` equals `value`
+    virtual void scanWhere(const char* column, long long value, const function<bool(T&)>& visit) const = 0;
+
+    virtual bool append(const T& record) = 0;
+    virtual bool appendAll(const vector<T>& records) = 0;
+    // Replace the first record with the same key; false if there is none
+    virtual bool update(const T& record) = 0;
+    // update() for many records at once; false if any key is missing,
+    // though the records that were found are still replaced
+    virtual bool updateAll(const vector<T>& records) = 0;
+    // Replace every record with `records`
+    virtual bool saveAll(const vector<T>& records) = 0;
+};
+
+// ========== CSV ==========
+// The flat files, through Repository. Lookups are scans.
+template <typename T, typename Traits = EntityTraits<T>>
+class CsvBackend : public StorageBackend<T> {
+private:
+    Repository<T, CsvFormat, Traits> repository;
+
+public:
+    explicit CsvBackend(const string& filename) : repository(filename) {}
+
+    void scan(const function<bool(T&)>& visit) const override { repository.scan(visit); }
+    vector<T> loadAll() const override { return repository.loadAll(); }
+
+    bool findByKey(int key, T& result) const override { return repository.findByKey(key, result); }
+
+    bool findBy(const char* column, const string& value, T& result) const override {
+        size_t index = columnIndex<Traits>(column);
+        return repository.findFirst([&](const T& record) { return columnEquals<T, Traits>(record, index, value); }, result);
+    }
+
+    void scanWhere(const char* column, long long value, const function<bool(T&)>& visit) const override {
+        size_t index = columnIndex<Traits>(column);
+        repository.scan([&](T& record) { return !columnEquals<T, Traits>(record, index, value) || visit(record); });
+    }
+
+    bool append(const T& record) override { return repository.append(record); }
+    bool appendAll(const vector<T>& records) override { return repository.appendAll(records); }
+    bool saveAll(const vector<T>& records) override { return repository.saveAll(records); }
+
+    // Streams the file into a copy with the record replaced, then swaps it in
+    bool update(const T& record) override {
+        const string& filename = repository.getFilename();
+        string temporary = filename + ".tmp";
+        bool replaced = false;
+        {
+            ofstream out(temporary, ios::trunc);
+            if (!out.is_open()) return false;
+            CsvWriter writer(out);
+            repository.scan([&](T& existing) {
+                bool match = !replaced && Traits::keyOf(existing) == Traits::keyOf(record);
+                CsvFormat::write<T, Traits>(writer, match ? record : existing);
+                replaced = replaced || match;
+                return true;
+            });
+            writer.flush();
+            if (!out) replaced = false;
+        }
+        if (!replaced || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // One pass over the file however many records change
+    bool updateAll(const vector<T>& records) override {
+        if (records.empty()) return true;
+        unordered_map<int, size_t> pending;
+        for (size_t i = 0; i < records.size(); ++i) pending[Traits::keyOf(records[i])] = i;
+        size_t expected = pending.size();
+
+        const string& filename = repository.getFilename();
+        string temporary = filename + ".tmp";
+        bool written = false;
+        {
+            ofstream out(temporary, ios::trunc);
+            if (!out.is_open()) return false;
+            CsvWriter writer(out);
+            repository.scan([&](T& existing) {
+                auto match = pending.find(Traits::keyOf(existing));
+                if (match == pending.end()) {
+                    CsvFormat::write<T, Traits>(writer, existing);
+                } else {
+                    CsvFormat::write<T, Traits>(writer, records[match->second]);
+                    pending.erase(match);
+                }
+                return true;
+            });
+            writer.flush();
+            written = static_cast<bool>(out);
+        }
+        // Keep the old file if the copy failed or nothing matched
+        if (!written || pending.size() == expected || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return pending.empty();
+    }
+};
+
+#ifdef WMS_SQLITE
+// ========== SQLite ==========
+// One table per location, with a column per field. The schema, the indexes
+// and every statement are generated from the field table: the key column
+// and the traits' lookup column are indexed, rows come back in insertion
+// order, and bulk writes run in one transaction.
+template <typename Traits, typename = void>
+struct LookupColumn {
+    static constexpr const char* name = nullptr;
+};
+
+template <typename Traits>
+struct LookupColumn<Traits, void_t<decltype(Traits::lookup)>> {
+    static constexpr const char* name = Traits::lookup;
+};
+
+template <typename T, typename Traits = EntityTraits<T>>
+class SqliteBackend : public StorageBackend<T> {
+private:
+    SqliteDatabase& db;
+    string table;
+    string columns;
+    string insertSql;
+
+    template <size_t I>
+    static const char* columnName() {
+        return get<I>(Traits::fields).name;
+    }
+
+    template <typename M>
+    static const char* sqlType() {
+        if constexpr (is_same<M, string>::value) return "TEXT";
+        else if constexpr (is_floating_point<M>::value) return "REAL";
+        else return "INTEGER";
+    }
+
+    template <size_t I>
+    static void appendColumn(string& list, bool withType) {
+        using Member = decay_t<decltype(declval<T>().*(get<I>(Traits::fields).member))>;
+        if (I > 0) list += ", ";
+        list += "\"";
+        list += columnName<I>();
+        list += "\"";
+        if (withType) {
+            list += " ";
+            list += sqlType<Member>();
+        }
+    }
+
+    // "a", "b", ... in field table order, with their SQL types for CREATE TABLE
+    template <size_t... I>
+    static string columnList(index_sequence<I...>, bool withTypes) {
+        string list;
+        (appendColumn<I>(list, withTypes), ...);
+        return list;
+    }
+
+    template <typename M>
+    static void bindValue(SqliteStatement& statement, int index, const M& value) {
+        if constexpr (is_same<M, string>::value) statement.bind(index, string_view(value));
+        else if constexpr (is_floating_point<M>::value) statement.bind(index, static_cast<double>(value));
+        else statement.bind(index, static_cast<long long>(value));
+    }
+
+    template <typename M>
+    static void readValue(const SqliteStatement& statement, int index, M& value) {
+        if constexpr (is_same<M, string>::value) value.assign(statement.columnText(index));
+        else if constexpr (is_floating_point<M>::value) value = static_cast<M>(statement.columnDouble(index));
+        else value = static_cast<M>(statement.columnInt(index));
+    }
+
+    template <size_t... I>
+    static void bindRecord(SqliteStatement& statement, const T& record, index_sequence<I...>) {
+        (bindValue(statement, I + 1, record.*(get<I>(Traits::fields).member)), ...);
+    }
+
+    template <size_t... I>
+    static void readRecord(const SqliteStatement& statement, T& record, index_sequence<I...>) {
+        (readValue(statement, I, record.*(get<I>(Traits::fields).member)), ...);
+    }
+
+    // Tables created before an added column get it, zero or empty in the
+    // old rows. Fails harmlessly when the column is already there.
+    template <size_t I>
+    void addColumn() {
+        using Member = decay_t<decltype(declval<T>().*(get<I>(Traits::fields).member))>;
+        if (!get<I>(Traits::fields).added) return;
+        const char* fallback = is_same<Member, string>::value ? "''" : "0";
+        db.exec("ALTER TABLE \"" + table + "\" ADD COLUMN \"" + columnName<I>() + "\" " + sqlType<Member>() +
+                " NOT NULL DEFAULT " + fallback);
+    }
+
+    template <size_t... I>
+    void addColumns(index_sequence<I...>) {
+        (addColumn<I>(), ...);
+    }
+
+    void createSchema() {
+        const char* key = columnName<0>();
+        string sql = "CREATE TABLE IF NOT EXISTS \"" + table + "\" (" +
+                     columnList(make_index_sequence<fieldCount<Traits>()>(), true) + ");";
+        sql += "CREATE INDEX IF NOT EXISTS \"" + table + "_" + key + "\" ON \"" + table + "\" (\"" + key + "\");";
+        if (LookupColumn<Traits>::name != nullptr) {
+            const char* lookup = LookupColumn<Traits>::name;
+            sql += "CREATE INDEX IF NOT EXISTS \"" + table + "_" + lookup + "\" ON \"" + table + "\" (\"" + lookup + "\");";
+        }
+        db.exec(sql);
+        addColumns(make_index_sequence<fieldCount<Traits>()>());
+    }
+
+    string selectSql(const string& where) const {
+        return "SELECT " + columns + " FROM \"" + table + "\"" + where + " ORDER BY rowid";
+    }
+
+    // Rows of `statement` to visit(record) until it returns false
+    void visitRows(SqliteStatement& statement, const function<bool(T&)>& visit) const {
+        while (statement.next()) {
+            T record;
+            readRecord(statement, record, make_index_sequence<fieldCount<Traits>()>());
+            if (!visit(record)) return;
+        }
+    }
+
+    bool insert(const T& record) {
+        SqliteStatement statement = db.prepare(insertSql);
+        bindRecord(statement, record, make_index_sequence<fieldCount<Traits>()>());
+        return statement.run();
+    }
+
+    bool insertAll(const vector<T>& records) {
+        for (const auto& record : records) {
+            if (!insert(record)) return false;
+        }
+        return true;
+    }
+
+    // Run `work` in a transaction, rolled back if it fails
+    template <typename Work>
+    bool transaction(Work work) {
+        if (!db.begin()) return false;
+        if (!work()) {
+            db.rollback();
+            return false;
+        }
+        return db.commit();
+    }
+
+public:
+    SqliteBackend(SqliteDatabase& database, const string& tableName) : db(database), table(tableName) {
+        columns = columnList(make_index_sequence<fieldCount<Traits>()>(), false);
+        insertSql = "INSERT INTO \"" + table + "\" (" + columns + ") VALUES (?";
+        for (size_t i = 1; i < fieldCount<Traits>(); ++i) insertSql += ", ?";
+        insertSql += ")";
+        if (db.firstUse(table)) createSchema();
+    }
+
+    void scan(const function<bool(T&)>& visit) const override {
+        SqliteStatement statement = db.prepare(selectSql(""));
+        visitRows(statement, visit);
+    }
+
+    vector<T> loadAll() const override {
+        vector<T> records;
+        scan([&records](T& record) {
+            records.push_back(move(record));
+            return true;
+        });
+        return records;
+    }
+
+    bool findByKey(int key, T& result) const override {
+        SqliteStatement statement = db.prepare(selectSql(string(" WHERE \"") + columnName<0>() + "\" = ?") + " LIMIT 1");
+        statement.bind(1, static_cast<long long>(key));
+        if (!statement.next()) return false;
+        readRecord(statement, result, make_index_sequence<fieldCount<Traits>()>());
+        return true;
+    }
+
+    bool findBy(const char* column, const string& value, T& result) const override {
+        if (columnIndex<Traits>(column) == fieldCount<Traits>()) return false;
+        SqliteStatement statement = db.prepare(selectSql(string(" WHERE \"") + column + "\" = ?") + " LIMIT 1");
+        statement.bind(1, string_view(value));
+        if (!statement.next()) return false;
+        readRecord(statement, result, make_index_sequence<fieldCount<Traits>()>());
+        return true;
+    }
+
+    void scanWhere(const char* column, long long value, const function<bool(T&)>& visit) const override {
+        if (columnIndex<Traits>(column) == fieldCount<Traits>()) return;
+        SqliteStatement statement = db.prepare(selectSql(string(" WHERE \"") + column + "\" = ?"));
+        statement.bind(1, value);
+        visitRows(statement, visit);
+    }
+
+    bool append(const T& record) override { return insert(record); }
+
+    bool appendAll(const vector<T>& records) override {
+        return transaction([&]() { return insertAll(records); });
+    }
+
+    bool saveAll(const vector<T>& records) override {
+        return transaction([&]() { return db.exec("DELETE FROM \"" + table + "\"") && insertAll(records); });
+    }
+
+    bool update(const T& record) override {
+        string sql = "UPDATE \"" + table + "\" SET (" + columns + ") = (?";
+        for (size_t i = 1; i < fieldCount<Traits>(); ++i) sql += ", ?";
+        sql += string(") WHERE rowid = (SELECT rowid FROM \"") + table + "\" WHERE \"" + columnName<0>() +
+               "\" = ? ORDER BY rowid LIMIT 1)";
+        SqliteStatement statement = db.prepare(sql);
+        bindRecord(statement, record, make_index_sequence<fieldCount<Traits>()>());
+        statement.bind(static_cast<int>(fieldCount<Traits>()) + 1, static_cast<long long>(Traits::keyOf(record)));
+        return statement.run() && db.changes() > 0;
+    }
+
+    // In one transaction; a missing key does not roll back the others
+    bool updateAll(const vector<T>& records) override {
+        bool all = true;
+        bool written = transaction([&]() {
+            for (const auto& record : records) {
+                if (!update(record)) all = false;
+            }
+            return true;
+        });
+        return written && all;
+    }
+};
+#endif
+
+// ========== LSM ==========
+// Records in an LsmStore, binary encoded, in key order. The store key is
+// the record key in the high bits and an ordinal in the low 20, so keys
+// may repeat (an order's items all carry its orderID): the first record
+// with a key has ordinal 0, and later appends take the next free one.
+// Lookups and range scans on the key column are served by the store; any
+// other column is a full scan, as with CSV.
+template <typename T, typename Traits = EntityTraits<T>>
+class LsmBackend : public StorageBackend<T> {
+private:
+    static constexpr int ORDINAL_BITS = 20;
+
+    LsmStore& store;
+
+    static bool decode(string_view value, T& record) {
+        return BinaryFormat::decode<T, Traits>(value, record);
+    }
+
+    // Visit the records with store keys in [from, to)
+    void scanRange(uint64_t from, uint64_t to, const function<bool(T&)>& visit) const {
+        store.scan(from, to, [&visit](uint64_t, string_view value) {
+            T record;
+            return !decode(value, record) || visit(record);
+        });
+    }
+
+    // Ordinal for one more record with `key`. A new key costs one lookup,
+    // which the bloom filters usually answer without reading a block.
+    uint32_t nextOrdinal(int key) const {
+        string existing;
+        if (!store.get(storeKey(key, 0), existing)) return 0;
+        uint32_t next = 1;
+        store.scan(storeKey(key, 0), storeKey(key, 0) + (1ULL << ORDINAL_BITS), [&next](uint64_t found, string_view) {
+            next = static_cast<uint32_t>(found & ((1ULL << ORDINAL_BITS) - 1)) + 1;
+            return true;
+        });
+        return next;
+    }
+
+public:
+    explicit LsmBackend(LsmStore& lsm) : store(lsm) {}
+
+    // Store key of the record with `key` and the given ordinal
+    static uint64_t storeKey(int key, uint32_t ordinal) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(key)) << ORDINAL_BITS) | ordinal;
+    }
+
+    void scan(const function<bool(T&)>& visit) const override { scanRange(0, UINT64_MAX, visit); }
+
+    vector<T> loadAll() const override {
+        vector<T> records;
+        scan([&records](T& record) {
+            records.push_back(move(record));
+            return true;
+        });
+        return records;
+    }
+
+    bool findByKey(int key, T& result) const override {
+        string value;
+        return store.get(storeKey(key, 0), value) && decode(value, result);
+    }
+
+    bool findBy(const char* column, const string& value, T& result) const override {
+        size_t index = columnIndex<Traits>(column);
+        bool found = false;
+        scan([&](T& record) {
+            if (!columnEquals<T, Traits>(record, index, value)) return true;
+            result = move(record);
+            found = true;
+            return false;
+        });
+        return found;
+    }
+
+    void scanWhere(const char* column, long long value, const function<bool(T&)>& visit) const override {
+        size_t index = columnIndex<Traits>(column);
+        if (index == 0) {
+            int key = static_cast<int>(value);
+            scanRange(storeKey(key, 0), storeKey(key, 0) + (1ULL << ORDINAL_BITS), visit);
+            return;
+        }
+        scan([&](T& record) { return !columnEquals<T, Traits>(record, index, value) || visit(record); });
+    }
+
+    bool append(const T& record) override {
+        string value;
+        BinaryFormat::encode<T, Traits>(value, record);
+        return store.put(storeKey(Traits::keyOf(record), nextOrdinal(Traits::keyOf(record))), value);
+    }
+
+    bool appendAll(const vector<T>& records) override {
+        map<int, uint32_t> ordinals;
+        vector<pair<uint64_t, string>> entries;
+        entries.reserve(records.size());
+        for (const auto& record : records) {
+            int key = Traits::keyOf(record);
+            auto found = ordinals.find(key);
+            if (found == ordinals.end()) found = ordinals.emplace(key, nextOrdinal(key)).first;
+            entries.emplace_back(storeKey(key, found->second++), string());
+            BinaryFormat::encode<T, Traits>(entries.back().second, record);
+        }
+        return store.putAll(entries);
+    }
+
+    // Not atomic: a crash part way leaves a prefix of `records`
+    bool saveAll(const vector<T>& records) override {
+        return store.clear() && appendAll(records);
+    }
+
+    // One small write, whatever the size of the store
+    bool update(const T& record) override {
+        string value;
+        uint64_t key = storeKey(Traits::keyOf(record), 0);
+        if (!store.get(key, value)) return false;
+        value.clear();
+        BinaryFormat::encode<T, Traits>(value, record);
+        return store.put(key, value);
+    }
+
+    bool updateAll(const vector<T>& records) override {
+        bool all = true;
+        vector<pair<uint64_t, string>> entries;
+        entries.reserve(records.size());
+        string existing;
+        for (const auto& record : records) {
+            uint64_t key = storeKey(Traits::keyOf(record), 0);
+            if (!store.get(key, existing)) {
+                all = false;
+                continue;
+            }
+            entries.emplace_back(key, string());
+            BinaryFormat::encode<T, Traits>(entries.back().second, record);
+        }
+        return store.putAll(entries) && all;
+    }
+};
+
+// ========== Selection ==========
+enum StorageKind {
+    STORAGE_CSV,
+    STORAGE_SQLITE,
+    STORAGE_LSM
+};
+
+class Storage {
+private:
+    static StorageKind kind;
+#ifdef WMS_SQLITE
+    static SqliteDatabase database;
+#endif
+    static string databasePath;
+    static string lsmDirectory;
+    static map<string, unique_ptr<LsmStore>> lsmStores;
+
+    // The store for `table`, opened on first use
+    static LsmStore& lsmStore(const string& table);
+
+public:
+    // Switch every later Storage::open to `backend`. SQLite keeps all the
+    // entities in the one database file at `path`; LSM keeps one store per
+    // table in subdirectories of `path`. False, leaving the current
+    // backend in place, if it cannot be opened or was not built in.
+    static bool use(StorageKind backend, const string& path = "");
+
+    static StorageKind current() { return kind; }
+
+    // Table for a location: the file name without directory or extension,
+    // so products.csv is kept in the "products" table
+    static string tableFor(const string& location);
+
+    template <typename T>
+    static unique_ptr<StorageBackend<T>> open(const string& location) {
+#ifdef WMS_SQLITE
+        if (kind == STORAGE_SQLITE) return unique_ptr<StorageBackend<T>>(new SqliteBackend<T>(database, tableFor(location)));
+#endif
+        if (kind == STORAGE_LSM) return unique_ptr<StorageBackend<T>>(new LsmBackend<T>(lsmStore(tableFor(location))));
+        return unique_ptr<StorageBackend<T>>(new CsvBackend<T>(location));
+    }
+
+    // Where IdSequence keeps the next free ID for `location`, beside the
+    // records: next to the CSV file or the database file, or among the
+    // LSM stores
+    static string sequenceFile(const string& location);
+
+    // Largest key stored at `location`, 0 if it holds no records
+    template <typename T, typename Traits = EntityTraits<T>>
+    static int highestKey(const string& location) {
+        int highest = 0;
+        open<T>(location)->scan([&highest](T& record) {
+            highest = max(highest, Traits::keyOf(record));
+            return true;
+        });
+        return highest;
+    }
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "supplier.h"
+
+#include "storage.h"
+#include "metrics.h"
+#include "trace.h"
+#include "utils.h"
+
+IdSequence Supplier::ids;
+
+Supplier::Supplier() {
+    supplierID = 0;
+    name = "Unnamed";
+    contactPerson = "";
+    phone = "";
+    email = "";
+    address = "";
+    username = "";
+    password = "";
+    status = SUPPLIER_PENDING;
+}
+
+Supplier::Supplier(string n, string cp, string p, string e, string a, string u, string pwd) {
+    supplierID = ids.next();
+    name = n;
+    contactPerson = cp;
+    phone = p;
+    email = e;
+    address = a;
+    username = u;
+    password = pwd;
+    status = SUPPLIER_ACTIVE;
+}
+
+string Supplier::getStatusString() const {
+    switch (status) {
+        case SUPPLIER_ACTIVE: return "Active";
+        case SUPPLIER_INACTIVE: return "Inactive";
+        case SUPPLIER_PENDING: return "Pending";
+        default: return "Unknown";
+    }
+}
+
+void Supplier::display() const {
+    cout << "┌─────────────────────────────────────────┐\n";
+    cout << "│ " << CYAN << BOLD << "Supplier ID: " << RESET << supplierID << string(30 - to_string(supplierID).length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Name: " << RESET << name << string(37 - name.length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Contact Person: " << RESET << contactPerson << string(27 - contactPerson.length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Phone: " << RESET << phone << string(36 - phone.length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Email: " << RESET << email << string(36 - email.length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Address: " << RESET << address << string(34 - address.length(), ' ') << "│\n";
+    cout << "│ " << CYAN << BOLD << "Status: " << RESET << getStatusString() << string(35 - getStatusString().length(), ' ') << "│\n";
+    cout << "└─────────────────────────────────────────┘\n";
+}
+
+void Supplier::writeRow(ostream& out) const {
+    Repository<Supplier>::serialize(out, *this);
+}
+
+void Supplier::saveToFile(const string& filename) const {
+    TRACE_SCOPE("Supplier::saveToFile");
+    static Counter rowsWritten("wms_rows_written_total", "Records written by saves and rewrites", "entity=\"supplier\"");
+    rowsWritten.increment();
+    
+    if (!Storage::open<Supplier>(filename)->append(*this)) {
+        cout << "Unable to open file for writing\n";
+    }
+}
+
+void Supplier::saveAllToFile(const string& filename, const vector<Supplier>& suppliers) {
+    TRACE_SCOPE("Supplier::saveAllToFile");
+    static Histogram rewriteTime("wms_rewrite_seconds", "Time to rewrite a data file", "entity=\"supplier\"");
+    static Counter rowsWritten("wms_rows_written_total", "Records written by saves and rewrites", "entity=\"supplier\"");
+    ScopedTimer timer(rewriteTime);
+    
+    if (!Storage::open<Supplier>(filename)->saveAll(suppliers)) {
+        cout << "Unable to open file for writing\n";
+        return;
+    }
+    rowsWritten.increment(suppliers.size());
+}
+
+Supplier Supplier::loadFromFile(const string& filename, int id) {
+    TRACE_SCOPE("Supplier::loadFromFile");
+    Supplier record;
+    if (Storage::open<Supplier>(filename)->findByKey(id, record)) return record;
+    return Supplier();
+}
+
+vector<Supplier> Supplier::loadAllFromFile(const string& filename) {
+    TRACE_SCOPE("Supplier::loadAllFromFile");
+    static Histogram loadTime("wms_load_seconds", "Time to load a data file", "entity=\"supplier\"");
+    static Counter rowsLoaded("wms_rows_loaded_total", "Records parsed by the loaders", "entity=\"supplier\"");
+    ScopedTimer timer(loadTime);
+    
+    vector<Supplier> suppliers = Storage::open<Supplier>(filename)->loadAll();
+    rowsLoaded.increment(suppliers.size());
+    return suppliers;
+}
+
+Supplier Supplier::findByUsername(const string& filename, const string& username) {
+    TRACE_SCOPE("Supplier::findByUsername");
+    static Histogram lookupTime("wms_lookup_seconds", "Time to look a record up by key", "kind=\"supplier_username\"");
+    ScopedTimer timer(lookupTime);
+    
+    Supplier record;
+    if (Storage::open<Supplier>(filename)->findBy("username", username, record)) return record;
+    return Supplier();
+}
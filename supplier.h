@@ -3,9 +3,9 @@
 
 #include <iostream>
 #include <string>
-#include <fstream>
-#include <sstream>
 #include <vector>
+#include "repository.h"
+#include "id_sequence.h"
 
 using namespace std;
 
@@ -17,7 +17,8 @@ enum SupplierStatus {
 
 class Supplier {
 private:
-    static int nextID;
+    friend struct EntityTraits<Supplier>;
+
     int supplierID;
     string name;
     string contactPerson;
@@ -29,29 +30,12 @@ private:
     SupplierStatus status;
 
 public:
-    Supplier() {
-        supplierID = nextID++;
-        name = "Unnamed";
-        contactPerson = "";
-        phone = "";
-        email = "";
-        address = "";
-        username = "";
-        password = "";
-        status = SUPPLIER_PENDING;
-    }
+    // Where new records get their IDs; see IdSequence
+    static IdSequence ids;
 
-    Supplier(string n, string cp, string p, string e, string a, string u = "", string pwd = "") {
-        supplierID = nextID++;
-        name = n;
-        contactPerson = cp;
-        phone = p;
-        email = e;
-        address = a;
-        username = u;
-        password = pwd;
-        status = SUPPLIER_ACTIVE;
-    }
+    // A blank record with ID 0, for loaders to fill in
+    Supplier();
+    Supplier(string n, string cp, string p, string e, string a, string u = "", string pwd = "");
 
     int getID() const { return supplierID; }
     string getName() const { return name; }
@@ -76,165 +60,36 @@ public:
         return password == pwd;
     }
 
-    string getStatusString() const {
-        switch (status) {
-            case SUPPLIER_ACTIVE: return "Active";
-            case SUPPLIER_INACTIVE: return "Inactive";
-            case SUPPLIER_PENDING: return "Pending";
-            default: return "Unknown";
-        }
-    }
+    string getStatusString() const;
+    void display() const;
 
-    void display() const {
-        cout << "┌─────────────────────────────────────────┐\n";
-        cout << "│ " << CYAN << BOLD << "Supplier ID: " << RESET << supplierID << string(30 - to_string(supplierID).length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Name: " << RESET << name << string(37 - name.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Contact Person: " << RESET << contactPerson << string(27 - contactPerson.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Phone: " << RESET << phone << string(36 - phone.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Email: " << RESET << email << string(36 - email.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Address: " << RESET << address << string(34 - address.length(), ' ') << "│\n";
-        cout << "│ " << CYAN << BOLD << "Status: " << RESET << getStatusString() << string(35 - getStatusString().length(), ' ') << "│\n";
-        cout << "└─────────────────────────────────────────┘\n";
-    }
+    // Write this supplier as one CSV row
+    void writeRow(ostream& out) const;
+    void saveToFile(const string& filename) const;
 
-    void saveToFile(const string& filename) const {
-        ofstream file(filename, ios::app);
-        if (file.is_open()) {
-            file << supplierID << "," << name << "," << contactPerson << "," 
-                 << phone << "," << email << "," << address << ","
-                 << username << "," << password << "," << status << "\n";
-            file.close();
-        } else {
-            cout << "Unable to open file for writing\n";
-        }
-    }
+    // Rewrite the whole file from `suppliers`
+    static void saveAllToFile(const string& filename, const vector<Supplier>& suppliers);
 
-    static Supplier loadFromFile(const string& filename, int id) {
-        ifstream file(filename);
-        string line;
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            int fileID;
-            string fileName, fileCP, filePhone, fileEmail, fileAddress, fileUsername, filePassword;
-            int fileStatus;
-            
-            getline(ss, field, ',');
-            fileID = stoi(field);
-            getline(ss, fileName, ',');
-            getline(ss, fileCP, ',');
-            getline(ss, filePhone, ',');
-            getline(ss, fileEmail, ',');
-            getline(ss, fileAddress, ',');
-            getline(ss, fileUsername, ',');
-            getline(ss, filePassword, ',');
-            getline(ss, field);
-            fileStatus = stoi(field);
-            
-            if (fileID == id) {
-                Supplier s;
-                s.supplierID = fileID;
-                s.name = fileName;
-                s.contactPerson = fileCP;
-                s.phone = filePhone;
-                s.email = fileEmail;
-                s.address = fileAddress;
-                s.username = fileUsername;
-                s.password = filePassword;
-                s.status = static_cast<SupplierStatus>(fileStatus);
-                return s;
-            }
-        }
-        file.close();
-        return Supplier();
-    }
-
-    static vector<Supplier> loadAllFromFile(const string& filename) {
-        ifstream file(filename);
-        string line;
-        vector<Supplier> suppliers;
-        
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            int fileID;
-            string fileName, fileCP, filePhone, fileEmail, fileAddress, fileUsername, filePassword;
-            int fileStatus;
-            
-            getline(ss, field, ',');
-            fileID = stoi(field);
-            getline(ss, fileName, ',');
-            getline(ss, fileCP, ',');
-            getline(ss, filePhone, ',');
-            getline(ss, fileEmail, ',');
-            getline(ss, fileAddress, ',');
-            getline(ss, fileUsername, ',');
-            getline(ss, filePassword, ',');
-            getline(ss, field);
-            fileStatus = stoi(field);
-            
-            Supplier s;
-            s.supplierID = fileID;
-            s.name = fileName;
-            s.contactPerson = fileCP;
-            s.phone = filePhone;
-            s.email = fileEmail;
-            s.address = fileAddress;
-            s.username = fileUsername;
-            s.password = filePassword;
-            s.status = static_cast<SupplierStatus>(fileStatus);
-            suppliers.push_back(s);
-        }
-        file.close();
-        return suppliers;
-    }
-
-    static Supplier findByUsername(const string& filename, const string& username) {
-        ifstream file(filename);
-        string line;
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string field;
-            int fileID;
-            string fileName, fileCP, filePhone, fileEmail, fileAddress, fileUsername, filePassword;
-            int fileStatus;
-            
-            getline(ss, field, ',');
-            fileID = stoi(field);
-            getline(ss, fileName, ',');
-            getline(ss, fileCP, ',');
-            getline(ss, filePhone, ',');
-            getline(ss, fileEmail, ',');
-            getline(ss, fileAddress, ',');
-            getline(ss, fileUsername, ',');
-            
-            if (fileUsername == username) {
-                getline(ss, filePassword, ',');
-                getline(ss, field);
-                fileStatus = stoi(field);
-                
-                Supplier s;
-                s.supplierID = fileID;
-                s.name = fileName;
-                s.contactPerson = fileCP;
-                s.phone = filePhone;
-                s.email = fileEmail;
-                s.address = fileAddress;
-                s.username = fileUsername;
-                s.password = filePassword;
-                s.status = static_cast<SupplierStatus>(fileStatus);
-                file.close();
-                return s;
-            } else {
-                getline(ss, field);
-            }
-        }
-        file.close();
-        return Supplier();
-    }
+    static Supplier loadFromFile(const string& filename, int id);
+    static vector<Supplier> loadAllFromFile(const string& filename);
+    static Supplier findByUsername(const string& filename, const string& username);
 };
 
-int Supplier::nextID = 1;
+template <>
+struct EntityTraits<Supplier> {
+    static constexpr auto fields = make_tuple(
+        field("supplierID", &Supplier::supplierID),
+        field("name", &Supplier::name),
+        field("contactPerson", &Supplier::contactPerson),
+        field("phone", &Supplier::phone),
+        field("email", &Supplier::email),
+        field("address", &Supplier::address),
+        field("username", &Supplier::username),
+        field("password", &Supplier::password),
+        field("status", &Supplier::status));
+
+    static int keyOf(const Supplier& supplier) { return supplier.supplierID; }
+    static constexpr const char* lookup = "username";
+};
 
 #endif
-
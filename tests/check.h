@@ -0,0 +1,118 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+using namespace std;
+
+// Just enough of a test framework for the suite to build anywhere the
+// project does. TEST(name) registers a case, CHECK records a failure and
+// carries on, REQUIRE stops the case. Each test file is its own executable
+// (see CMakeLists.txt) that runs every case, or those whose names contain
+// argv[1], and exits non-zero if any check failed.
+namespace check {
+
+struct Case {
+    const char* name;
+    void (*run)();
+};
+
+inline vector<Case>& cases() {
+    static vector<Case> all;
+    return all;
+}
+
+inline const char*& current() {
+    static const char* name = "";
+    return name;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+struct Register {
+    Register(const char* name, void (*run)()) { cases().push_back({name, run}); }
+};
+
+inline void fail(const char* file, int line, const string& what) {
+    ++failures();
+    cerr << file << ":" << line << ": " << current() << ": " << what << "\n";
+}
+
+inline int runAll(int argc, char** argv) {
+    string filter = argc > 1 ? argv[1] : "";
+    int ran = 0;
+    for (const auto& test : cases()) {
+        if (string(test.name).find(filter) == string::npos) continue;
+        current() = test.name;
+        int before = failures();
+        test.run();
+        cout << (failures() == before ? "[  OK  ] " : "[FAILED] ") << test.name << "\n";
+        ++ran;
+    }
+    cout << ran << " cases, " << failures() << " failed checks\n";
+    return failures() == 0 && ran > 0 ? 0 : 1;
+}
+
+// A fresh directory named after the running case, removed afterwards
+class ScratchDir {
+private:
+    filesystem::path root;
+
+public:
+    ScratchDir() : root(filesystem::temp_directory_path() / "wms_tests" / current()) {
+        filesystem::remove_all(root);
+        filesystem::create_directories(root);
+    }
+    ~ScratchDir() {
+        error_code ignored;
+        filesystem::remove_all(root, ignored);
+    }
+
+    ScratchDir(const ScratchDir&) = delete;
+    ScratchDir& operator=(const ScratchDir&) = delete;
+
+    string path(const string& name) const { return (root / name).string(); }
+};
+
+}  // namespace check
+
+#define TEST(name)                                                 \
+    static void test_##name();                                     \
+    static check::Register register_##name(#name, test_##name);    \
+    static void test_##name()
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) check::fail(__FILE__, __LINE__, "CHECK(" #condition ")"); \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                            \
+    do {                                                                      \
+        const auto& actual_ = (actual);                                       \
+        const auto& expected_ = (expected);                                   \
+        if (!(actual_ == expected_)) {                                        \
+            ostringstream message_;                                           \
+            message_ << #actual " == " #expected ": got " << actual_ << ", expected " << expected_; \
+            check::fail(__FILE__, __LINE__, message_.str());                  \
+        }                                                                     \
+    } while (0)
+
+#define REQUIRE(condition)                                                    \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            check::fail(__FILE__, __LINE__, "REQUIRE(" #condition ")");      \
+            return;                                                           \
+        }                                                                     \
+    } while (0)
+
+#define TEST_MAIN() \
+    int main(int argc, char** argv) { return check::runAll(argc, argv); }
+
+#endif
@@ -0,0 +1,109 @@
+#include <sstream>
+#include "check.h"
+#include "codec.h"
+#include "product.h"
+#include "order.h"
+
+namespace {
+
+Product sample(const string& name, const string& description) {
+    Product product(name, 12.5f, 40, "Tools", description);
+    return product;
+}
+
+void expectSame(const Product& a, const Product& b) {
+    CHECK_EQ(a.getID(), b.getID());
+    CHECK_EQ(a.getName(), b.getName());
+    CHECK_EQ(a.getPrice(), b.getPrice());
+    CHECK_EQ(a.getQuantity(), b.getQuantity());
+    CHECK_EQ(a.getCategory(), b.getCategory());
+    CHECK_EQ(a.getDescription(), b.getDescription());
+}
+
+}  // namespace
+
+TEST(CsvPlainRecordsAreWrittenBare) {
+    ostringstream out;
+    CsvFormat::write(out, sample("Widget", "Small"));
+    string row = out.str();
+    CHECK_EQ(row.substr(row.find(',')), ",Widget,12.5,40,Tools,Small\n");
+}
+
+TEST(CsvRoundTripsQuotedFields) {
+    vector<Product> products = {sample("Bolt, steel", "Says \"hi\""), sample("Plain", "two\nlines"),
+                                sample("", "trailing,comma,")};
+    stringstream file;
+    CsvFormat::writeAll(file, products);
+
+    CsvFormat::Reader reader(file);
+    for (const auto& expected : products) {
+        Product read;
+        REQUIRE(reader.read(read) == READ_OK);
+        expectSame(read, expected);
+    }
+    Product extra;
+    CHECK_EQ(reader.read(extra), READ_END);
+}
+
+TEST(CsvSkipsRowsWithMalformedNumbers) {
+    stringstream file("1,Good,1.5,3,Tools,x\n2,Bad,price,3,Tools,x\n3,Also good,2,4,Tools,y\n");
+    CsvFormat::Reader reader(file);
+    Product product;
+    CHECK_EQ(reader.read(product), READ_OK);
+    CHECK_EQ(reader.read(product), READ_SKIPPED);
+    CHECK_EQ(reader.read(product), READ_OK);
+    CHECK_EQ(product.getID(), 3);
+    CHECK_EQ(reader.read(product), READ_END);
+}
+
+TEST(CsvRowsFromBeforeAnAddedColumnRead) {
+    // The first row predates the warehouse column; a short row still fails
+    // on the columns that were always there
+    stringstream file("7,2,Gadget,4,3,12\n7,1,Widget,2.5,2,5,3\n7,1,Widget\n");
+    CsvFormat::Reader reader(file);
+    OrderItem item;
+    item.warehouseID = 9;
+    REQUIRE(reader.read(item) == READ_OK);
+    CHECK_EQ(item.productID, 2);
+    CHECK_EQ(item.subtotal, 12.0f);
+    CHECK_EQ(item.warehouseID, 0);
+    REQUIRE(reader.read(item) == READ_OK);
+    CHECK_EQ(item.warehouseID, 3);
+    CHECK_EQ(reader.read(item), READ_SKIPPED);
+}
+
+TEST(BinaryValuesFromBeforeAnAddedColumnDecode) {
+    OrderItem item{7, 2, "Gadget", 4.0f, 3, 12.0f, 5};
+    string encoded;
+    BinaryFormat::encode(encoded, item);
+    string old = encoded.substr(0, encoded.size() - sizeof(int));
+
+    OrderItem decoded;
+    REQUIRE(BinaryFormat::decode(old, decoded));
+    CHECK_EQ(decoded.productName, string("Gadget"));
+    CHECK_EQ(decoded.warehouseID, 0);
+    REQUIRE(BinaryFormat::decode(encoded, decoded));
+    CHECK_EQ(decoded.warehouseID, 5);
+    // Cut inside a column that was always there
+    CHECK(!BinaryFormat::decode(string_view(old).substr(0, old.size() - 2), decoded));
+}
+
+TEST(BinaryRoundTripsThroughMemory) {
+    Product original = sample("Gadget", string("with\0nul", 8));
+    string encoded;
+    BinaryFormat::encode(encoded, original);
+    Product decoded;
+    REQUIRE(BinaryFormat::decode(encoded, decoded));
+    expectSame(decoded, original);
+}
+
+TEST(BinaryRejectsTruncatedRecords) {
+    string encoded;
+    BinaryFormat::encode(encoded, sample("Gadget", "Big"));
+    Product decoded;
+    for (size_t length = 0; length < encoded.size(); ++length) {
+        CHECK(!BinaryFormat::decode(string_view(encoded.data(), length), decoded));
+    }
+}
+
+TEST_MAIN()
@@ -0,0 +1,169 @@
+#include <sstream>
+#include <random>
+#include "check.h"
+#include "csv.h"
+
+namespace {
+
+typedef vector<vector<string>> Records;
+
+// The same grammar as CsvReader, one byte at a time with no buffering, to
+// compare against. Blank lines are skipped, a CR before a record's LF is
+// dropped, and with `columns` set an unquoted last column runs to the end
+// of the line.
+Records reference(const string& text, size_t columns) {
+    Records records;
+    size_t i = 0, n = text.size();
+    while (i < n) {
+        if (text[i] == '\n') {
+            ++i;
+            continue;
+        }
+        if (text[i] == '\r' && i + 1 < n && text[i + 1] == '\n') {
+            i += 2;
+            continue;
+        }
+        vector<string> record;
+        for (;;) {
+            string field;
+            if (i < n && text[i] == '"') {
+                for (++i; i < n; ++i) {
+                    if (text[i] != '"') {
+                        field += text[i];
+                    } else if (i + 1 < n && text[i + 1] == '"') {
+                        field += '"';
+                        ++i;
+                    } else {
+                        ++i;
+                        break;
+                    }
+                }
+                record.push_back(field);
+                // Anything between the closing quote and the separator is dropped
+                while (i < n && text[i] != ',' && text[i] != '\n') ++i;
+                if (i >= n) break;
+                if (text[i++] == '\n') break;
+                continue;
+            }
+            bool last = columns != 0 && record.size() + 1 == columns;
+            while (i < n && text[i] != '\n' && (last || text[i] != ',')) field += text[i++];
+            bool end = i >= n || text[i] == '\n';
+            if (end && !field.empty() && field.back() == '\r') field.pop_back();
+            record.push_back(field);
+            ++i;
+            if (end) break;
+        }
+        records.push_back(record);
+    }
+    return records;
+}
+
+Records parse(const string& text, size_t capacity, size_t columns = 0) {
+    istringstream in(text);
+    CsvReader reader(in, capacity);
+    Records records;
+    while (reader.next(columns)) {
+        vector<string> record;
+        for (size_t i = 0; i < reader.size(); ++i) record.emplace_back(reader.field(i));
+        records.push_back(record);
+    }
+    return records;
+}
+
+string printable(const string& text) {
+    string shown;
+    for (char c : text) shown += c == '\n' ? "\\n" : c == '\r' ? "\\r" : string(1, c);
+    return shown;
+}
+
+// Block sizes from one byte up, and the default
+const size_t CAPACITIES[] = {1, 2, 3, 4, 5, 7, 8, 16, CSV_READ_BUFFER};
+
+void expectRecords(const string& text, const Records& expected, size_t columns = 0) {
+    for (size_t capacity : CAPACITIES) {
+        Records got = parse(text, capacity, columns);
+        if (got != expected) {
+            check::fail(__FILE__, __LINE__, "\"" + printable(text) + "\" with a " + to_string(capacity) + "-byte block");
+        }
+    }
+}
+
+}  // namespace
+
+TEST(QuotedCommasAndLineBreaks) {
+    expectRecords("1,\"a,b\",\"line one\nline two\"\n2,plain,x\n",
+                  {{"1", "a,b", "line one\nline two"}, {"2", "plain", "x"}});
+}
+
+TEST(DoubledQuotesAreEscapes) {
+    expectRecords("\"say \"\"hi\"\"\",\"\"\"\"\n\"\",x\n", {{"say \"hi\"", "\""}, {"", "x"}});
+}
+
+TEST(CrlfLineEndings) {
+    expectRecords("a,b\r\nc,\"d\"\r\n\r\ne\r\n", {{"a", "b"}, {"c", "d"}, {"e"}});
+}
+
+TEST(LoneCrAtBlockBoundary) {
+    // With a three-byte block the CR ends one block and the LF starts the next
+    expectRecords("ab\r\ncd\r\n", {{"ab"}, {"cd"}});
+    // A CR that is not before an LF is data, except at the end of a record
+    expectRecords("a\rb,c\r\n", {{"a\rb", "c"}});
+    expectRecords("ab\r", {{"ab"}});
+}
+
+TEST(FinalLineWithoutNewline) {
+    expectRecords("a,b\nc,d", {{"a", "b"}, {"c", "d"}});
+    expectRecords("a,b\n\"c,d\"", {{"a", "b"}, {"c,d"}});
+    expectRecords("a,", {{"a", ""}});
+}
+
+TEST(BlankLinesAndEmptyInput) {
+    expectRecords("", {});
+    expectRecords("\n\r\n\n", {});
+    expectRecords("\na\n\nb\n", {{"a"}, {"b"}});
+}
+
+TEST(UnterminatedQuoteRunsToTheEnd) {
+    expectRecords("a,\"b,c\nd", {{"a", "b,c\nd"}});
+}
+
+TEST(LastColumnKeepsBareCommas) {
+    expectRecords("1,Widget,small, light and cheap\n2,Gadget,big\n",
+                  {{"1", "Widget", "small, light and cheap"}, {"2", "Gadget", "big"}}, 3);
+}
+
+TEST(RecordPositions) {
+    string text = "a,b\r\n\n\"c\nd\",e\nf";
+    istringstream in(text);
+    CsvReader reader(in, 2);
+    vector<pair<uint64_t, uint64_t>> positions;
+    while (reader.next()) positions.emplace_back(reader.offset(), reader.length());
+    vector<pair<uint64_t, uint64_t>> expected = {{0, 5}, {6, 8}, {14, 1}};
+    CHECK(positions == expected);
+}
+
+// Random inputs over the characters that matter, checked against the
+// reference parser at random block sizes and column counts
+TEST(MatchesReferenceOnRandomInput) {
+    mt19937 random(7);
+    const char alphabet[] = "ab,\"\n\r";
+    for (int round = 0; round < 200000; ++round) {
+        // Half short inputs of special characters, half longer ones that
+        // are mostly plain text
+        bool longer = round % 2 == 1;
+        size_t length = random() % (longer ? 300 : 40);
+        string text;
+        for (size_t k = 0; k < length; ++k) {
+            text += longer && random() % 10 < 8 ? static_cast<char>('a' + random() % 3) : alphabet[random() % 6];
+        }
+        size_t columns = random() % 4;
+        size_t capacity = round % 3 == 0 ? CSV_READ_BUFFER : 1 + random() % 8;
+        if (parse(text, capacity, columns) != reference(text, columns)) {
+            check::fail(__FILE__, __LINE__, "\"" + printable(text) + "\" with a " + to_string(capacity) +
+                                                "-byte block and " + to_string(columns) + " columns");
+            return;
+        }
+    }
+}
+
+TEST_MAIN()
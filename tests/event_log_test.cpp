@@ -0,0 +1,118 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include "check.h"
+#include "event_log.h"
+
+namespace {
+
+// Small enough that a handful of events spans several segments
+const uint64_t SNAPSHOT_EVERY = 4;
+const uint64_t SEGMENT_EVENTS = 2;
+
+string segmentPath(const string& dir, uint64_t first) {
+    char name[48];
+    snprintf(name, sizeof(name), "segment-%020llu.log", static_cast<unsigned long long>(first));
+    return dir + "/" + name;
+}
+
+bool appendStock(EventLog& log, int productID, int quantity) {
+    return log.append({EventLog::stockChanged(productID, quantity)}, 1700000000);
+}
+
+}  // namespace
+
+TEST(EventsSurviveReopenAcrossSegments) {
+    check::ScratchDir dir;
+    string path = dir.path("ledger");
+    {
+        EventLog log(SNAPSHOT_EVERY, SEGMENT_EVENTS);
+        REQUIRE(log.open(path));
+        for (int i = 1; i <= 7; ++i) REQUIRE(appendStock(log, 1 + i % 2, i));
+        CHECK_EQ(log.segmentCount(), size_t(4));
+        CHECK_EQ(log.snapshotCount(), size_t(1));
+    }
+    EventLog log(SNAPSHOT_EVERY, SEGMENT_EVENTS);
+    REQUIRE(log.open(path));
+    CHECK_EQ(log.lastSequence(), uint64_t(7));
+    CHECK_EQ(log.state().quantity(1), 2 + 4 + 6);
+    CHECK_EQ(log.state().quantity(2), 1 + 3 + 5 + 7);
+}
+
+TEST(FailedWritesAreNotApplied) {
+    check::ScratchDir dir;
+    string path = dir.path("ledger");
+    EventLog log(SNAPSHOT_EVERY, SEGMENT_EVENTS);
+    REQUIRE(log.open(path));
+
+    // Every write to the first segment fails
+    filesystem::create_symlink("/dev/full", segmentPath(path, 1));
+    CHECK(!appendStock(log, 1, 5));
+    CHECK(!appendStock(log, 1, 5));
+    CHECK_EQ(log.lastSequence(), uint64_t(0));
+    CHECK_EQ(log.state().quantity(1), 0);
+
+    // Writes that work again carry on from the last applied event
+    filesystem::remove(segmentPath(path, 1));
+    REQUIRE(appendStock(log, 1, 3));
+    CHECK_EQ(log.lastSequence(), uint64_t(1));
+    EventLog reopened(SNAPSHOT_EVERY, SEGMENT_EVENTS);
+    REQUIRE(reopened.open(path));
+    CHECK_EQ(reopened.lastSequence(), uint64_t(1));
+    CHECK_EQ(reopened.state().quantity(1), 3);
+}
+
+TEST(FailedRolloverLeavesNoGap) {
+    check::ScratchDir dir;
+    string path = dir.path("ledger");
+    EventLog log(SNAPSHOT_EVERY, SEGMENT_EVENTS);
+    REQUIRE(log.open(path));
+    REQUIRE(appendStock(log, 1, 1));
+    REQUIRE(appendStock(log, 1, 1));
+
+    // The segment starting at 3 cannot be created
+    filesystem::create_directory(segmentPath(path, 3));
+    CHECK(!appendStock(log, 1, 1));
+    CHECK_EQ(log.lastSequence(), uint64_t(2));
+    filesystem::remove(segmentPath(path, 3));
+
+    REQUIRE(appendStock(log, 1, 1));
+    REQUIRE(appendStock(log, 1, 1));
+    EventLog reopened(SNAPSHOT_EVERY, SEGMENT_EVENTS);
+    REQUIRE(reopened.open(path));
+    CHECK_EQ(reopened.lastSequence(), uint64_t(4));
+    CHECK_EQ(reopened.state().quantity(1), 4);
+}
+
+TEST(LeftoversOfAFailedWriteAreCutOff) {
+    check::ScratchDir dir;
+    string path = dir.path("ledger");
+    EventLog log(SNAPSHOT_EVERY, SEGMENT_EVENTS);
+    REQUIRE(log.open(path));
+    REQUIRE(appendStock(log, 1, 1));
+    REQUIRE(appendStock(log, 1, 1));
+
+    // Part of an event that was never applied sits in the next segment
+    ofstream(segmentPath(path, 3), ios::binary) << "partial record";
+    REQUIRE(appendStock(log, 1, 10));
+    EventLog reopened(SNAPSHOT_EVERY, SEGMENT_EVENTS);
+    REQUIRE(reopened.open(path));
+    CHECK_EQ(reopened.lastSequence(), uint64_t(3));
+    CHECK_EQ(reopened.state().quantity(1), 12);
+}
+
+TEST(MissingEventsFailTheOpen) {
+    check::ScratchDir dir;
+    string path = dir.path("ledger");
+    {
+        EventLog log(100, SEGMENT_EVENTS);
+        REQUIRE(log.open(path));
+        for (int i = 0; i < 6; ++i) REQUIRE(appendStock(log, 1, 1));
+    }
+    // Segments 1, 3 and 5, with 3 gone: 5 starts after the next event
+    filesystem::remove(segmentPath(path, 3));
+    EventLog log(100, SEGMENT_EVENTS);
+    CHECK(!log.open(path));
+}
+
+TEST_MAIN()
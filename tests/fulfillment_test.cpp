@@ -0,0 +1,162 @@
+#include <thread>
+#include <vector>
+#include <map>
+#include <random>
+#include "check.h"
+#include "fulfillment.h"
+#include "mpsc_queue.h"
+
+namespace {
+
+const int THREADS = 4;
+
+}  // namespace
+
+TEST(QueueKeepsEachProducersOrder) {
+    const uint64_t perProducer = 50000;
+    // Small enough that producers keep finding it full
+    MpscQueue<uint64_t> queue(8);
+    CHECK_EQ(queue.capacity(), size_t(8));
+
+    vector<thread> producers;
+    for (int p = 0; p < THREADS; ++p) {
+        producers.emplace_back([&queue, p, perProducer] {
+            for (uint64_t i = 0; i < perProducer; ++i) {
+                while (!queue.tryPush(uint64_t(p) << 32 | i)) this_thread::yield();
+            }
+        });
+    }
+
+    vector<uint64_t> next(THREADS, 0);
+    bool ordered = true;
+    for (uint64_t received = 0; received < perProducer * THREADS;) {
+        uint64_t value;
+        if (!queue.tryPop(value)) {
+            this_thread::yield();
+            continue;
+        }
+        size_t producer = value >> 32;
+        if (producer >= next.size() || (value & 0xffffffffu) != next[producer]) ordered = false;
+        if (producer < next.size()) next[producer] = (value & 0xffffffffu) + 1;
+        ++received;
+    }
+    for (auto& producer : producers) producer.join();
+
+    CHECK(ordered);
+    CHECK(queue.empty());
+    for (int p = 0; p < THREADS; ++p) CHECK_EQ(next[p], perProducer);
+}
+
+TEST(FullQueueRefusesPushes) {
+    MpscQueue<int> queue(3);
+    CHECK_EQ(queue.capacity(), size_t(4));
+    for (int i = 0; i < 4; ++i) CHECK(queue.tryPush(i));
+    CHECK(!queue.tryPush(4));
+    int value = -1;
+    REQUIRE(queue.tryPop(value));
+    CHECK_EQ(value, 0);
+    CHECK(queue.tryPush(4));
+}
+
+TEST(TransitionsFollowTheLifecycle) {
+    FulfillmentPipeline pipeline;
+    pipeline.start();
+    pipeline.track(1, ORDER_PENDING);
+    pipeline.track(1, ORDER_SHIPPED);  // already tracked, ignored
+    CHECK_EQ(pipeline.status(1), int(ORDER_PENDING));
+    CHECK_EQ(pipeline.transition(2, ORDER_PROCESSING), TRANSITION_UNKNOWN_ORDER);
+    CHECK_EQ(pipeline.transition(1, ORDER_DELIVERED), TRANSITION_NOT_ALLOWED);
+    CHECK_EQ(pipeline.transition(1, ORDER_PROCESSING), TRANSITION_ACCEPTED);
+    CHECK_EQ(pipeline.transition(1, ORDER_CANCELLED), TRANSITION_ACCEPTED);
+    CHECK_EQ(pipeline.transition(1, ORDER_PENDING), TRANSITION_NOT_ALLOWED);
+    CHECK_EQ(pipeline.status(1), int(ORDER_CANCELLED));
+    pipeline.flush();
+    CHECK_EQ(pipeline.accepted(), uint64_t(2));
+    CHECK_EQ(pipeline.handled(), uint64_t(2));
+}
+
+// Threads race every order through random moves. Each move out of a status
+// must be accepted once, and the events of an order must reach the
+// handlers in the order they happened.
+TEST(RacingTransitionsAreAcceptedOnce) {
+    const int orders = 2000;
+    const int rounds = 20;
+    // A small queue and batches so producers wrap it and wait on the worker
+    FulfillmentPipeline pipeline(64, 16);
+    map<int, vector<StatusEvent>> seen;
+    pipeline.subscribe([&seen](const vector<StatusEvent>& batch) {
+        for (const auto& event : batch) seen[event.orderID].push_back(event);
+    });
+    pipeline.start();
+    for (int id = 1; id <= orders; ++id) pipeline.track(id, ORDER_PENDING);
+
+    vector<size_t> acceptedBy(THREADS, 0);
+    vector<thread> workers;
+    for (int t = 0; t < THREADS; ++t) {
+        workers.emplace_back([&pipeline, &acceptedBy, t, orders, rounds] {
+            mt19937 random(t);
+            uniform_int_distribution<int> target(ORDER_PROCESSING, ORDER_CANCELLED);
+            for (int round = 0; round < rounds; ++round) {
+                for (int id = 1; id <= orders; ++id) {
+                    OrderStatus to = static_cast<OrderStatus>(target(random));
+                    if (pipeline.transition(id, to) == TRANSITION_ACCEPTED) ++acceptedBy[t];
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    pipeline.flush();
+
+    size_t accepted = 0;
+    for (size_t count : acceptedBy) accepted += count;
+    CHECK_EQ(pipeline.accepted(), uint64_t(accepted));
+    CHECK_EQ(pipeline.handled(), uint64_t(accepted));
+
+    size_t events = 0;
+    bool chained = true;
+    bool legal = true;
+    bool final = true;
+    for (int id = 1; id <= orders; ++id) {
+        OrderStatus current = ORDER_PENDING;
+        for (const auto& event : seen[id]) {
+            if (event.from != current) chained = false;
+            if (!FulfillmentPipeline::allowed(event.from, event.to)) legal = false;
+            current = event.to;
+            ++events;
+        }
+        if (pipeline.status(id) != current) final = false;
+    }
+    CHECK_EQ(events, accepted);
+    CHECK(chained);
+    CHECK(legal);
+    CHECK(final);
+}
+
+TEST(DeferredHandlersRunOnTheFlushingThread) {
+    FulfillmentPipeline pipeline;
+    thread::id workerThread;
+    vector<thread::id> deferredThreads;
+    size_t deferredEvents = 0;
+    pipeline.subscribe([&workerThread](const vector<StatusEvent>&) { workerThread = this_thread::get_id(); });
+    pipeline.subscribeDeferred([&](const vector<StatusEvent>& batch) {
+        deferredThreads.push_back(this_thread::get_id());
+        deferredEvents += batch.size();
+    });
+    pipeline.start();
+    for (int id = 1; id <= 100; ++id) pipeline.track(id, ORDER_PENDING);
+    for (int id = 1; id <= 100; ++id) pipeline.transition(id, ORDER_PROCESSING);
+
+    pipeline.flush();
+    CHECK_EQ(deferredEvents, size_t(100));
+    CHECK(workerThread != this_thread::get_id());
+    bool onCaller = !deferredThreads.empty();
+    for (const auto& id : deferredThreads) onCaller = onCaller && id == this_thread::get_id();
+    CHECK(onCaller);
+
+    // Batches handled by the worker before stop() still reach them
+    for (int id = 1; id <= 100; ++id) pipeline.transition(id, ORDER_CANCELLED);
+    pipeline.stop();
+    CHECK_EQ(deferredEvents, size_t(200));
+}
+
+TEST_MAIN()
@@ -0,0 +1,185 @@
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <csignal>
+#include <sys/resource.h>
+#include "check.h"
+#include "lsm.h"
+
+namespace {
+
+string readFile(const string& path) {
+    ifstream in(path, ios::binary);
+    stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+// Entries stay in the memtable and the log unless a test flushes
+LsmOptions largeMemtable() {
+    LsmOptions options;
+    options.memtableBytes = 64 << 20;
+    return options;
+}
+
+void putRange(LsmStore& store, uint64_t from, uint64_t to) {
+    for (uint64_t key = from; key < to; ++key) store.put(key, "value " + to_string(key));
+}
+
+bool holdsRange(const LsmStore& store, uint64_t from, uint64_t to) {
+    string value;
+    for (uint64_t key = from; key < to; ++key) {
+        if (!store.get(key, value) || value != "value " + to_string(key)) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(ReopenReplaysTheLog) {
+    check::ScratchDir dir;
+    {
+        LsmStore store;
+        REQUIRE(store.open(dir.path("lsm"), largeMemtable()));
+        putRange(store, 1, 100);
+        store.remove(50);
+    }
+    LsmStore store;
+    REQUIRE(store.open(dir.path("lsm"), largeMemtable()));
+    CHECK(holdsRange(store, 1, 50));
+    CHECK(holdsRange(store, 51, 100));
+    string value;
+    CHECK(!store.get(50, value));
+}
+
+TEST(TornLogIsFlushedThenTruncated) {
+    check::ScratchDir dir;
+    string wal = dir.path("lsm/wal.log");
+    {
+        LsmStore store;
+        REQUIRE(store.open(dir.path("lsm"), largeMemtable()));
+        putRange(store, 1, 100);
+    }
+    ofstream(wal, ios::binary | ios::app) << "torn";
+
+    {
+        LsmStore store;
+        REQUIRE(store.open(dir.path("lsm"), largeMemtable()));
+        CHECK(holdsRange(store, 1, 100));
+        CHECK_EQ(store.stats().runs, size_t(1));
+        CHECK_EQ(filesystem::file_size(wal), uintmax_t(0));
+        // Written after the torn entry used to be: must survive a reopen
+        putRange(store, 100, 120);
+    }
+    LsmStore store;
+    REQUIRE(store.open(dir.path("lsm"), largeMemtable()));
+    CHECK(holdsRange(store, 1, 120));
+}
+
+TEST(FailedLogWritesAreNotApplied) {
+    check::ScratchDir dir;
+    string wal = dir.path("lsm/wal.log");
+    LsmStore store;
+    REQUIRE(store.open(dir.path("lsm"), largeMemtable()));
+    putRange(store, 1, 10);
+
+    // Files may grow only part way into the next entry
+    rlimit saved;
+    getrlimit(RLIMIT_FSIZE, &saved);
+    signal(SIGXFSZ, SIG_IGN);
+    rlimit limit = saved;
+    limit.rlim_cur = filesystem::file_size(wal) + 16;
+    setrlimit(RLIMIT_FSIZE, &limit);
+    bool written = store.put(10, string(1000, 'x'));
+    // Fits once the partial entry is cut off
+    bool removed = store.remove(1);
+    setrlimit(RLIMIT_FSIZE, &saved);
+    signal(SIGXFSZ, SIG_DFL);
+    CHECK(!written);
+    CHECK(removed);
+    string value;
+    CHECK(!store.get(10, value));
+    CHECK(!store.get(1, value));
+    CHECK(holdsRange(store, 2, 10));
+
+    store.close();
+    REQUIRE(store.open(dir.path("lsm"), largeMemtable()));
+    CHECK(!store.get(10, value));
+    CHECK(!store.get(1, value));
+    CHECK(holdsRange(store, 2, 10));
+}
+
+TEST(FailedRecoveryKeepsTheLog) {
+    check::ScratchDir dir;
+    string wal = dir.path("lsm/wal.log");
+    {
+        LsmStore store;
+        REQUIRE(store.open(dir.path("lsm"), largeMemtable()));
+        putRange(store, 1, 100);
+    }
+    ofstream(wal, ios::binary | ios::app) << "torn";
+    string before = readFile(wal);
+
+    // A non-empty directory where the recovery flush writes its run
+    filesystem::create_directories(dir.path("lsm/run-000001.sst/blocker"));
+    {
+        LsmStore store;
+        CHECK(!store.open(dir.path("lsm"), largeMemtable()));
+        CHECK(!store.isOpen());
+        string value;
+        CHECK(!store.get(1, value));
+        CHECK_EQ(store.stats().runs, size_t(0));
+        CHECK_EQ(store.stats().memtableEntries, size_t(0));
+    }
+    CHECK(readFile(wal) == before);
+
+    filesystem::remove_all(dir.path("lsm/run-000001.sst"));
+    LsmStore store;
+    REQUIRE(store.open(dir.path("lsm"), largeMemtable()));
+    CHECK(holdsRange(store, 1, 100));
+}
+
+TEST(FailedOpenDropsLoadedRuns) {
+    check::ScratchDir dir;
+    {
+        LsmStore store;
+        REQUIRE(store.open(dir.path("lsm"), largeMemtable()));
+        putRange(store, 1, 10);
+        REQUIRE(store.flush());
+        putRange(store, 10, 20);
+        REQUIRE(store.flush());
+    }
+    // The manifest names a run that is gone
+    ofstream(dir.path("lsm/MANIFEST"), ios::app) << "99\n";
+    LsmStore store;
+    CHECK(!store.open(dir.path("lsm"), largeMemtable()));
+    CHECK_EQ(store.stats().runs, size_t(0));
+    string value;
+    CHECK(!store.get(1, value));
+}
+
+TEST(FlushAndCompactKeepEveryEntry) {
+    check::ScratchDir dir;
+    LsmOptions options;
+    options.memtableBytes = 4096;
+    options.compactionTrigger = 2;
+    LsmStore store;
+    REQUIRE(store.open(dir.path("lsm"), options));
+    putRange(store, 1, 2000);
+    for (uint64_t key = 1; key < 2000; key += 3) store.remove(key);
+    store.compact();
+    CHECK_EQ(store.stats().runs, size_t(1));
+    string value;
+    for (uint64_t key = 1; key < 2000; ++key) {
+        bool removed = (key - 1) % 3 == 0;
+        if (store.get(key, value) == removed) {
+            CHECK(!removed);
+            break;
+        }
+    }
+    size_t scanned = 0;
+    store.scan(0, UINT64_MAX, [&scanned](uint64_t, string_view) { return ++scanned > 0; });
+    CHECK_EQ(scanned, size_t(1999 - 667));
+}
+
+TEST_MAIN()
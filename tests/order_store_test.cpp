@@ -0,0 +1,196 @@
+#include <fstream>
+#include <sstream>
+#include "check.h"
+#include "order_store.h"
+#include "storage.h"
+
+namespace {
+
+Order makeOrder(const string& customer, int itemCount) {
+    Order order(7, customer);
+    for (int i = 0; i < itemCount; ++i) {
+        Product product("Part " + to_string(i), 2.5f, 100);
+        order.addItem(product, i + 1);
+    }
+    return order;
+}
+
+// Header rows for orders with the given IDs, all pending and without items
+string ordersWith(const vector<int>& ids, OrderStatus status = ORDER_PENDING) {
+    string rows;
+    for (int id : ids) rows += to_string(id) + ",7,Customer " + to_string(id) + ",10,1700000000," + to_string(status) + "\n";
+    return rows;
+}
+
+void writeFile(const string& path, const string& text) {
+    ofstream out(path, ios::binary);
+    out << text;
+}
+
+string readFile(const string& path) {
+    ifstream in(path, ios::binary);
+    stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+int statusOf(OrderStore& store, int id) {
+    Order order;
+    return store.findHeader(id, order) ? order.getStatus() : 0;
+}
+
+}  // namespace
+
+TEST(AddedOrdersAreFoundWithTheirItems) {
+    check::ScratchDir dir;
+    string orders = dir.path("orders.csv");
+    string items = dir.path("order_items.csv");
+    ofstream(orders).close();
+    ofstream(items).close();
+
+    Order first = makeOrder("Ann", 2);
+    Order second = makeOrder("Bob, Jr.", 3);
+    {
+        OrderStore store(orders, items);
+        REQUIRE(store.add(first));
+        REQUIRE(store.add(second));
+        shared_ptr<const Order> cached = store.find(second.getID());
+        REQUIRE(cached);
+        CHECK_EQ(store.hits(), uint64_t(1));
+    }
+
+    // A fresh store reads them back from the files through the indexes
+    OrderStore store(orders, items);
+    shared_ptr<const Order> found = store.find(second.getID());
+    REQUIRE(found);
+    CHECK_EQ(store.misses(), uint64_t(1));
+    CHECK_EQ(found->getCustomerName(), string("Bob, Jr."));
+    CHECK_EQ(found->getItems().size(), size_t(3));
+    CHECK_EQ(found->getStatus(), ORDER_PENDING);
+    REQUIRE(store.find(first.getID()));
+    CHECK_EQ(store.find(first.getID())->getItems().size(), size_t(2));
+    CHECK(!store.find(second.getID() + 100));
+}
+
+TEST(BatchesKeepTheLastChangeToEachOrder) {
+    check::ScratchDir dir;
+    string orders = dir.path("orders.csv");
+    string items = dir.path("order_items.csv");
+    writeFile(orders, ordersWith({1, 2, 3, 4, 5, 6}));
+    writeFile(items, "");
+
+    OrderStore store(orders, items);
+    // 1-3 are adjacent rows and go out as one write; 2 is given twice and
+    // 5 sits apart from the rest
+    CHECK(store.setStatuses({{2, ORDER_PROCESSING}, {1, ORDER_SHIPPED}, {5, ORDER_CANCELLED},
+                             {3, ORDER_PROCESSING}, {2, ORDER_CANCELLED}}));
+
+    string expected = ordersWith({1}, ORDER_SHIPPED) + ordersWith({2}, ORDER_CANCELLED) +
+                      ordersWith({3}, ORDER_PROCESSING) + ordersWith({4}) + ordersWith({5}, ORDER_CANCELLED) +
+                      ordersWith({6});
+    CHECK_EQ(readFile(orders), expected);
+    // The rows kept their offsets, so the indexes still answer
+    CHECK_EQ(statusOf(store, 2), int(ORDER_CANCELLED));
+    OrderStore reopened(orders, items);
+    CHECK_EQ(statusOf(reopened, 5), int(ORDER_CANCELLED));
+    CHECK_EQ(statusOf(reopened, 6), int(ORDER_PENDING));
+}
+
+TEST(MissingOrdersFailTheBatchButNotTheRest) {
+    check::ScratchDir dir;
+    string orders = dir.path("orders.csv");
+    string items = dir.path("order_items.csv");
+    writeFile(orders, ordersWith({1, 2, 3}));
+    writeFile(items, "");
+
+    OrderStore store(orders, items);
+    CHECK(!store.setStatuses({{0, ORDER_SHIPPED}, {2, ORDER_SHIPPED}, {9, ORDER_SHIPPED}}));
+    CHECK_EQ(statusOf(store, 2), int(ORDER_SHIPPED));
+    CHECK_EQ(statusOf(store, 1), int(ORDER_PENDING));
+    CHECK_EQ(statusOf(store, 3), int(ORDER_PENDING));
+}
+
+TEST(SparseBatchesLookUpEachOrder) {
+    check::ScratchDir dir;
+    string orders = dir.path("orders.csv");
+    string items = dir.path("order_items.csv");
+    // IDs far enough apart that one walk along the index would cost more
+    // than a descent per order
+    writeFile(orders, ordersWith({1, 40, 5000, 100000, 2000000}));
+    writeFile(items, "");
+
+    OrderStore store(orders, items);
+    CHECK(!store.setStatuses({{2000000, ORDER_PROCESSING}, {777, ORDER_PROCESSING}, {40, ORDER_CANCELLED}}));
+    CHECK_EQ(statusOf(store, 40), int(ORDER_CANCELLED));
+    CHECK_EQ(statusOf(store, 2000000), int(ORDER_PROCESSING));
+    CHECK_EQ(statusOf(store, 1), int(ORDER_PENDING));
+    CHECK_EQ(statusOf(store, 5000), int(ORDER_PENDING));
+    CHECK_EQ(statusOf(store, 100000), int(ORDER_PENDING));
+}
+
+TEST(CachedOrdersTakeBatchStatuses) {
+    check::ScratchDir dir;
+    string orders = dir.path("orders.csv");
+    string items = dir.path("order_items.csv");
+    writeFile(orders, "");
+    writeFile(items, "");
+
+    OrderStore store(orders, items);
+    Order order = makeOrder("Ann", 2);
+    REQUIRE(store.add(order));
+    REQUIRE(store.find(order.getID()));
+    CHECK(store.setStatuses({{order.getID(), ORDER_PROCESSING}}));
+
+    shared_ptr<const Order> cached = store.find(order.getID());
+    REQUIRE(cached);
+    CHECK_EQ(store.misses(), uint64_t(0));
+    CHECK_EQ(cached->getStatus(), ORDER_PROCESSING);
+    CHECK_EQ(cached->getItems().size(), size_t(2));
+}
+
+TEST(LsmStorageTakesBatchStatuses) {
+    check::ScratchDir dir;
+    REQUIRE(Storage::use(STORAGE_LSM, dir.path("lsm")));
+    Order first = makeOrder("Ann", 1);
+    Order second = makeOrder("Bob", 2);
+    bool all;
+    int firstStatus, secondStatus;
+    size_t secondItems = 0;
+    {
+        OrderStore store("orders.csv", "order_items.csv");
+        REQUIRE(store.add(first));
+        REQUIRE(store.add(second));
+        all = store.setStatuses({{second.getID(), ORDER_PROCESSING}, {first.getID(), ORDER_CANCELLED},
+                                 {second.getID(), ORDER_SHIPPED}, {first.getID() + 1000, ORDER_SHIPPED}});
+        OrderStore reopened("orders.csv", "order_items.csv");
+        firstStatus = statusOf(reopened, first.getID());
+        secondStatus = statusOf(reopened, second.getID());
+        shared_ptr<const Order> found = reopened.find(second.getID());
+        if (found) secondItems = found->getItems().size();
+    }
+    Storage::use(STORAGE_CSV);
+
+    CHECK(!all);
+    CHECK_EQ(firstStatus, int(ORDER_CANCELLED));
+    CHECK_EQ(secondStatus, int(ORDER_SHIPPED));
+    CHECK_EQ(secondItems, size_t(2));
+}
+
+TEST(OrderIDListsParse) {
+    vector<int> ids;
+    CHECK(parseOrderIDs("12, 15-17,3", ids));
+    CHECK_EQ(ids.size(), size_t(5));
+    CHECK(ids == vector<int>({12, 15, 16, 17, 3}));
+
+    for (const char* bad : {"", "x", "4-", "5-3", "0", "-2", "1-2-3", "7 8", "1,,2", "1-1000000"}) {
+        vector<int> rejected;
+        if (parseOrderIDs(bad, rejected)) {
+            check::fail(__FILE__, __LINE__, string("accepted \"") + bad + "\"");
+        }
+    }
+    vector<int> wide;
+    CHECK(parseOrderIDs("1-999999", wide));
+    CHECK_EQ(wide.size(), size_t(999999));
+}
+
+TEST_MAIN()
@@ -0,0 +1,51 @@
+#include <fstream>
+#include <sstream>
+#include "check.h"
+#include "reports.h"
+
+namespace {
+
+string readFile(const string& path) {
+    ifstream in(path);
+    stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+}  // namespace
+
+TEST(TopProductsQuoteNamesAndWriteCents) {
+    check::ScratchDir dir;
+    vector<ProductSales> report = {{1, "Bolt, \"steel\"", 3, 1234567.89}, {2, "Nut", 1, 0.1 + 0.2}};
+    REQUIRE(Reports::saveTopProducts(report, dir.path("top.csv")));
+    CHECK_EQ(readFile(dir.path("top.csv")),
+             string("productID,productName,unitsSold,revenue\n1,\"Bolt, \"\"steel\"\"\",3,1234567.89\n2,Nut,1,0.3\n"));
+}
+
+TEST(RevenueByCustomerQuotesNames) {
+    check::ScratchDir dir;
+    vector<CustomerRevenue> report = {{7, "Smith, Jane", 2, 20000000.5}};
+    REQUIRE(Reports::saveRevenueByCustomer(report, dir.path("customers.csv")));
+    CHECK_EQ(readFile(dir.path("customers.csv")),
+             string("customerID,customerName,orderCount,revenue\n7,\"Smith, Jane\",2,20000000.5\n"));
+}
+
+TEST(StockValuationWritesTotal) {
+    check::ScratchDir dir;
+    StockValuation report{0, 2500000.25, {{"Tools, hand", 2500000.25}}};
+    REQUIRE(Reports::saveStockValuation(report, dir.path("stock.csv")));
+    CHECK_EQ(readFile(dir.path("stock.csv")), string("category,value\n\"Tools, hand\",2500000.25\nTOTAL,2500000.25\n"));
+}
+
+TEST(StockValuationCountsPastIntRange) {
+    vector<Product> inventory;
+    for (int i = 0; i < 3; ++i) inventory.emplace_back("Pallet", 1.0f, 1000000000);
+    CHECK_EQ(Reports::stockValuation(inventory, 2).totalUnits, 3000000000LL);
+}
+
+TEST(SaveFailsForUnwritablePath) {
+    check::ScratchDir dir;
+    CHECK(!Reports::saveStatusBreakdown(StatusBreakdown{}, dir.path("missing/breakdown.csv")));
+}
+
+TEST_MAIN()
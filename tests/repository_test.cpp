@@ -0,0 +1,70 @@
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include "check.h"
+#include "repository.h"
+#include "product.h"
+
+namespace {
+
+string readFile(const string& path) {
+    ifstream in(path);
+    stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+vector<Product> sampleProducts(int count) {
+    vector<Product> products;
+    for (int i = 0; i < count; ++i) products.emplace_back("Item " + to_string(i), 1.5f, i, "Tools", "x");
+    return products;
+}
+
+}  // namespace
+
+TEST(AppendAndLoadRoundTrip) {
+    check::ScratchDir dir;
+    Repository<Product> repository(dir.path("products.csv"));
+    vector<Product> products = sampleProducts(3);
+    CHECK(repository.append(products[0]));
+    CHECK(repository.appendAll({products[1], products[2]}));
+    vector<Product> loaded = repository.loadAll();
+    REQUIRE(loaded.size() == 3);
+    CHECK_EQ(loaded[2].getName(), string("Item 2"));
+}
+
+TEST(SaveAllReplacesTheFile) {
+    check::ScratchDir dir;
+    Repository<Product> repository(dir.path("products.csv"));
+    REQUIRE(repository.saveAll(sampleProducts(5)));
+    REQUIRE(repository.saveAll(sampleProducts(2)));
+    CHECK_EQ(repository.loadAll().size(), size_t(2));
+    CHECK(!filesystem::exists(dir.path("products.csv.tmp")));
+}
+
+TEST(FailedSaveAllKeepsTheOldFile) {
+    check::ScratchDir dir;
+    Repository<Product> repository(dir.path("products.csv"));
+    REQUIRE(repository.saveAll(sampleProducts(4)));
+    string before = readFile(dir.path("products.csv"));
+    // The copy cannot be created where a directory is in the way
+    filesystem::create_directory(dir.path("products.csv.tmp"));
+    CHECK(!repository.saveAll(sampleProducts(1)));
+    CHECK_EQ(readFile(dir.path("products.csv")), before);
+}
+
+TEST(WritesToAFullDiskFail) {
+    if (!filesystem::exists("/dev/full")) return;
+    Repository<Product> repository("/dev/full");
+    CHECK(!repository.append(sampleProducts(1)[0]));
+    CHECK(!repository.appendAll(sampleProducts(3)));
+}
+
+TEST(WritesToAMissingDirectoryFail) {
+    check::ScratchDir dir;
+    Repository<Product> repository(dir.path("missing/products.csv"));
+    CHECK(!repository.append(sampleProducts(1)[0]));
+    CHECK(!repository.saveAll(sampleProducts(1)));
+}
+
+TEST_MAIN()
@@ -0,0 +1,31 @@
+#include "check.h"
+#include "storage.h"
+#include "order.h"
+
+#ifdef WMS_SQLITE
+TEST(SqliteTablesGainAddedColumns) {
+    check::ScratchDir dir;
+    string path = dir.path("wms.db");
+    {
+        // order_items as it was before items recorded their warehouse
+        SqliteDatabase old;
+        REQUIRE(old.open(path));
+        REQUIRE(old.exec("CREATE TABLE \"order_items\" (\"orderID\" INTEGER, \"productID\" INTEGER, "
+                         "\"productName\" TEXT, \"price\" REAL, \"quantity\" INTEGER, \"subtotal\" REAL);"
+                         "INSERT INTO \"order_items\" VALUES (7, 2, 'Gadget', 4.0, 3, 12.0);"));
+    }
+
+    REQUIRE(Storage::use(STORAGE_SQLITE, path));
+    auto items = Storage::open<OrderItem>("order_items.csv");
+    REQUIRE(items->append(OrderItem{8, 1, "Widget", 2.5f, 2, 5.0f, 3}));
+    vector<OrderItem> loaded = items->loadAll();
+    Storage::use(STORAGE_CSV);
+
+    REQUIRE(loaded.size() == 2);
+    CHECK_EQ(loaded[0].productName, string("Gadget"));
+    CHECK_EQ(loaded[0].warehouseID, 0);
+    CHECK_EQ(loaded[1].warehouseID, 3);
+}
+#endif
+
+TEST_MAIN()
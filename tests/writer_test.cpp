@@ -0,0 +1,65 @@
+#include <sstream>
+#include <cmath>
+#include "check.h"
+#include "csv.h"
+#include "jsonl.h"
+
+namespace {
+
+string csvRows(size_t capacity) {
+    ostringstream out;
+    {
+        CsvWriter writer(out, capacity);
+        writer.field("plain");
+        writer.field("a,b");
+        writer.field("say \"hi\"");
+        writer.field(-42);
+        writer.field(19.99f);
+        writer.endRow();
+        writer.field(string(40, 'x'));
+        writer.endRow();
+    }
+    return out.str();
+}
+
+string jsonRows(size_t capacity) {
+    ostringstream out;
+    {
+        JsonlWriter writer(out, capacity);
+        writer.field("name", "tab\there \"q\" \\ \x01");
+        writer.field("count", 7);
+        writer.field("price", 2.5f);
+        writer.field("bad", NAN);
+        writer.null("none");
+        writer.endRow();
+        writer.endRow();
+    }
+    return out.str();
+}
+
+}  // namespace
+
+// Every buffer size, including ones smaller than a single field, gives the
+// same text
+TEST(CsvWriterQuotesAndFormats) {
+    string expected = "plain,\"a,b\",\"say \"\"hi\"\"\",-42,19.99\n" + string(40, 'x') + "\n";
+    for (size_t capacity : {1, 3, 16, 64, 1 << 20}) CHECK_EQ(csvRows(capacity), expected);
+}
+
+TEST(JsonlWriterEscapesStrings) {
+    string expected = "{\"name\":\"tab\\there \\\"q\\\" \\\\ \\u0001\",\"count\":7,\"price\":2.5,\"bad\":null,"
+                      "\"none\":null}\n{}\n";
+    for (size_t capacity : {1, 3, 16, 64, 1 << 20}) CHECK_EQ(jsonRows(capacity), expected);
+}
+
+TEST(FlushHandsOverWhatIsBuffered) {
+    ostringstream out;
+    CsvWriter writer(out);
+    writer.field("a");
+    writer.endRow();
+    CHECK_EQ(out.str(), string());
+    writer.flush();
+    CHECK_EQ(out.str(), string("a\n"));
+}
+
+TEST_MAIN()
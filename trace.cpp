@@ -0,0 +1,159 @@
+#include "trace.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+
+const size_t TRACE_RING_CAPACITY = 1 << 14;
+const size_t MAX_RETIRED_RINGS = 64;
+
+struct TraceEvent {
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+// Single-writer ring: the owning thread fills a slot, then publishes it by
+// advancing `head` with release order; readers acquire `head` first.
+struct TraceRing {
+    TraceEvent events[TRACE_RING_CAPACITY];
+    atomic<uint64_t> head;
+    int threadID;
+    bool isMain;
+};
+
+struct TraceState {
+    mutex lock;
+    vector<TraceRing*> live;
+    vector<TraceRing*> retired;  // rings of exited threads, kept until flushed
+    int nextThreadID = 1;
+    thread::id mainThread;
+    atomic<bool> enabled{false};
+    string filename;
+};
+
+// Never destroyed, so spans closed during shutdown stay valid
+static TraceState& state() {
+    static TraceState* instance = new TraceState();
+    return *instance;
+}
+
+// Hands the ring over to the retired list when its thread exits
+class TraceRingHandle {
+public:
+    TraceRing* ring;
+
+    TraceRingHandle() {
+        TraceState& trace = state();
+        ring = new TraceRing();
+        lock_guard<mutex> guard(trace.lock);
+        ring->threadID = trace.nextThreadID++;
+        ring->isMain = this_thread::get_id() == trace.mainThread;
+        trace.live.push_back(ring);
+    }
+
+    ~TraceRingHandle() {
+        TraceState& trace = state();
+        lock_guard<mutex> guard(trace.lock);
+        for (size_t i = 0; i < trace.live.size(); ++i) {
+            if (trace.live[i] == ring) {
+                trace.live.erase(trace.live.begin() + i);
+                break;
+            }
+        }
+        if (trace.retired.size() >= MAX_RETIRED_RINGS) {
+            delete trace.retired.front();
+            trace.retired.erase(trace.retired.begin());
+        }
+        trace.retired.push_back(ring);
+    }
+};
+
+static TraceRing& localRing() {
+    thread_local TraceRingHandle handle;
+    return *handle.ring;
+}
+
+static void flushAtExit() {
+    TraceState& trace = state();
+    if (!Tracer::flush(trace.filename)) {
+        cerr << "trace: unable to write " << trace.filename << "\n";
+    }
+}
+
+void Tracer::start(const string& filename) {
+    TraceState& trace = state();
+    now();  // pin the time origin
+    trace.mainThread = this_thread::get_id();
+    if (trace.filename.empty()) atexit(flushAtExit);
+    trace.filename = filename;
+    trace.enabled.store(true, memory_order_relaxed);
+}
+
+bool Tracer::isEnabled() {
+    return state().enabled.load(memory_order_relaxed);
+}
+
+uint64_t Tracer::now() {
+    static const chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+    // +1 so that a valid timestamp is never 0, which TraceSpan uses as "not recording"
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin).count() + 1;
+}
+
+void Tracer::record(const char* name, uint64_t begin, uint64_t end) {
+    TraceRing& ring = localRing();
+    uint64_t head = ring.head.load(memory_order_relaxed);
+    ring.events[head & (TRACE_RING_CAPACITY - 1)] = {name, begin, end};
+    ring.head.store(head + 1, memory_order_release);
+}
+
+// Append `text` as a JSON string literal
+static void writeJsonString(ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out << '\\' << *c;
+        else if (static_cast<unsigned char>(*c) < 0x20) out << ' ';
+        else out << *c;
+    }
+    out << '"';
+}
+
+static void writeRing(ostream& out, const TraceRing& ring, bool& first) {
+    char number[64];
+
+    out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring.threadID
+        << ",\"args\":{\"name\":\"" << (ring.isMain ? "main" : "worker") << "\"}}";
+    first = false;
+
+    uint64_t head = ring.head.load(memory_order_acquire);
+    uint64_t oldest = head > TRACE_RING_CAPACITY ? head - TRACE_RING_CAPACITY : 0;
+    for (uint64_t i = oldest; i < head; ++i) {
+        const TraceEvent& event = ring.events[i & (TRACE_RING_CAPACITY - 1)];
+        out << ",\n{\"name\":";
+        writeJsonString(out, event.name);
+        // trace_event timestamps are in microseconds
+        snprintf(number, sizeof(number), ",\"ts\":%.3f,\"dur\":%.3f",
+                 event.begin / 1e3, (event.end - event.begin) / 1e3);
+        out << ",\"cat\":\"wms\",\"ph\":\"X\"" << number << ",\"pid\":1,\"tid\":" << ring.threadID << "}";
+    }
+}
+
+bool Tracer::flush(const string& filename) {
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+
+    TraceState& trace = state();
+    lock_guard<mutex> guard(trace.lock);
+    bool first = true;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (const TraceRing* ring : trace.retired) writeRing(file, *ring, first);
+    for (const TraceRing* ring : trace.live) writeRing(file, *ring, first);
+    file << "\n]}\n";
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+// Timeline tracing for startup, menu handlers and file I/O.
+//
+// TRACE_SCOPE("name") records a span covering the rest of the enclosing
+// scope. Spans go into a ring buffer owned by the recording thread (the
+// oldest are overwritten once it is full) and are written as Chrome
+// trace_event JSON, which chrome://tracing and Perfetto can open.
+//
+// Spans are only recorded after Tracer::start(); until then a span is a
+// single flag check. Building without WMS_TRACING removes them entirely.
+//
+// The name must be a string literal; only the pointer is stored.
+
+class Tracer {
+public:
+    // Start recording and write the trace to `filename` when the process exits
+    static void start(const string& filename);
+    static bool isEnabled();
+
+    // Record a finished span; times are nanoseconds from Tracer::now()
+    static void record(const char* name, uint64_t begin, uint64_t end);
+    static uint64_t now();
+
+    // Write every recorded span. Spans still being written by other threads
+    // may be skipped; call this when the workers are idle.
+    static bool flush(const string& filename);
+};
+
+class TraceSpan {
+private:
+    const char* name;
+    uint64_t begin;
+
+public:
+    explicit TraceSpan(const char* spanName) : name(spanName), begin(Tracer::isEnabled() ? Tracer::now() : 0) {}
+
+    ~TraceSpan() {
+        if (begin != 0) Tracer::record(name, begin, Tracer::now());
+    }
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef WMS_TRACING
+#define TRACE_SCOPE(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif
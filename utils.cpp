@@ -0,0 +1,366 @@
+#include "utils.h"
+
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <streambuf>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <termios.h>
+#include <unistd.h>
+
+char getch() {
+    struct termios oldt{}, newt{};
+    tcgetattr(STDIN_FILENO, &oldt);
+    newt = oldt;
+    newt.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
+    fflush(stdout);
+    char ch = getchar();
+    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
+    return ch;
+}
+#endif
+
+// Clear the screen
+void clearScreen() {
+    cout << "\033[2J\033[1;1H";
+}
+
+// Center text on the screen
+void centerText(const string& text) {
+    int screenWidth = 80;
+    int padding = (screenWidth - text.length()) / 2;
+    if (padding > 0) cout << string(padding, ' ');
+    cout << text << "\n";
+}
+
+// Lowercase copy of a string, for case-insensitive matching
+string toLowerCase(string text) {
+    for (char& c : text) c = tolower(c);
+    return text;
+}
+
+bool stdoutIsTerminal() {
+#ifdef _WIN32
+    return true;
+#else
+    static const bool isTerminal = isatty(STDOUT_FILENO);
+    return isTerminal;
+#endif
+}
+
+// Copy of `text` with ESC [ ... <letter> sequences removed
+string stripAnsi(const string& text) {
+    string plain;
+    plain.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\033' && i + 1 < text.size() && text[i + 1] == '[') {
+            i += 2;
+            while (i < text.size() && !isalpha(static_cast<unsigned char>(text[i]))) ++i;
+            continue;
+        }
+        plain += text[i];
+    }
+    return plain;
+}
+
+// Stream buffer that forwards to another buffer with ANSI sequences removed
+class AnsiFilterBuf : public streambuf {
+private:
+    streambuf* target;
+    int state;  // 0 = text, 1 = saw ESC, 2 = inside ESC [ ... sequence
+
+protected:
+    int overflow(int ch) override {
+        if (ch == EOF) return 0;
+        if (state == 0 && ch == '\033') { state = 1; return ch; }
+        if (state == 1) {
+            state = (ch == '[') ? 2 : 0;
+            if (state == 0) target->sputc('\033');
+            else return ch;
+        }
+        if (state == 2) {
+            if (isalpha(ch)) state = 0;
+            return ch;
+        }
+        return target->sputc(static_cast<char>(ch));
+    }
+
+    // Forward runs of plain text in bulk; only escape sequences go char by char
+    streamsize xsputn(const char* text, streamsize count) override {
+        streamsize i = 0;
+        while (i < count) {
+            if (state == 0) {
+                const void* esc = memchr(text + i, '\033', count - i);
+                streamsize run = esc ? static_cast<const char*>(esc) - (text + i) : count - i;
+                target->sputn(text + i, run);
+                i += run;
+                if (i == count) break;
+            }
+            overflow(static_cast<unsigned char>(text[i++]));
+        }
+        return count;
+    }
+
+    int sync() override {
+        return target->pubsync();
+    }
+
+public:
+    explicit AnsiFilterBuf(streambuf* buf) : target(buf), state(0) {}
+};
+
+// Call once at startup, before any output
+void initTerminal() {
+#ifndef _WIN32
+    setvbuf(stdout, nullptr, _IOFBF, 1 << 16);
+#endif
+    if (!stdoutIsTerminal()) {
+        static AnsiFilterBuf filter(cout.rdbuf());
+        cout.rdbuf(&filter);
+    }
+}
+
+// Write a rendered buffer to the terminal in one call
+void writeToTerminal(const string& buffer) {
+    cout.flush();
+    const string plain = stdoutIsTerminal() ? string() : stripAnsi(buffer);
+    const string& out = stdoutIsTerminal() ? buffer : plain;
+#ifdef _WIN32
+    fwrite(out.data(), 1, out.size(), stdout);
+    fflush(stdout);
+#else
+    size_t written = 0;
+    while (written < out.size()) {
+        ssize_t n = write(STDOUT_FILENO, out.data() + written, out.size() - written);
+        if (n <= 0) break;
+        written += n;
+    }
+#endif
+}
+
+// Append a "│ Label: value   │" row, padded to the box width
+void appendBoxField(string& out, const char* label, const char* value, size_t valueLength) {
+    size_t used = strlen(label) + valueLength;
+    out += "│ ";
+    out += CYAN;
+    out += BOLD;
+    out += label;
+    out += RESET;
+    out.append(value, valueLength);
+    if (used < BOX_WIDTH) out.append(BOX_WIDTH - used, ' ');
+    out += "│\n";
+}
+
+void appendBoxField(string& out, const char* label, const string& value) {
+    appendBoxField(out, label, value.data(), value.size());
+}
+
+void appendBoxField(string& out, const char* label, long long value) {
+    char buffer[24];
+    int length = snprintf(buffer, sizeof(buffer), "%lld", value);
+    appendBoxField(out, label, buffer, length);
+}
+
+// Append a plain "│ text   │" row
+void appendBoxLine(string& out, const char* text, size_t length) {
+    out += "│ ";
+    out.append(text, length);
+    if (length < BOX_WIDTH) out.append(BOX_WIDTH - length, ' ');
+    out += "│\n";
+}
+
+Frame& Frame::centered(const string& text) {
+    int padding = (80 - (int)text.length()) / 2;
+    if (padding > 0) buffer.append(padding, ' ');
+    return line(text);
+}
+
+Frame& Frame::tableRow(const vector<string>& cells, const vector<size_t>& widths) {
+    for (size_t c = 0; c < cells.size() && c < widths.size(); ++c) {
+        size_t length = min(cells[c].size(), widths[c]);
+        buffer.append(cells[c], 0, length);
+        buffer.append(widths[c] - length + 1, ' ');
+    }
+    return line();
+}
+
+void Frame::present() {
+    writeToTerminal(buffer);
+    buffer.clear();
+}
+
+// Pad `text` to `width` columns (never underflows)
+string padRight(const string& text, size_t width) {
+    return text.length() < width ? text + string(width - text.length(), ' ') : text;
+}
+
+// Generate a random color
+string randomColor() {
+    string colors[] = {RED, GREEN, YELLOW, BLUE, MAGENTA, CYAN};
+    return colors[rand() % 6];
+}
+
+// Enhanced loading screen with animation
+void loadingScreen(const string& message) {
+    const int barWidth = 50;
+    const string progressChars = "▁▂▃▄▅▆▇█";
+    clearScreen();
+    
+    cout << "\n\n";
+    centerText(string(BOLD) + string(CYAN) + "╔══════════════════════════════════════════════════════════╗");
+    centerText(string(BOLD) + string(CYAN) + "║                                                          ║");
+    centerText(string(BOLD) + string(CYAN) + "║  " + string(YELLOW) + message + string(50 - message.length(), ' ') + string(CYAN) + "  ║");
+    centerText(string(BOLD) + string(CYAN) + "║                                                          ║");
+    centerText(string(BOLD) + string(CYAN) + "╚══════════════════════════════════════════════════════════╝");
+    cout << "\n\n";
+
+    // Animated progress bar
+    for (int i = 0; i <= barWidth; ++i) {
+        string progressBar = "[";
+        for (int j = 0; j < i; ++j) progressBar += "█";
+        for (int j = i; j < barWidth; ++j) progressBar += " ";
+        progressBar += "]";
+        
+        centerText(string(BRIGHT_GREEN) + progressBar + " " + to_string(int((i * 100) / barWidth)) + "% " + 
+                  progressChars[i % progressChars.length()]);
+        
+        cout.flush();
+        this_thread::sleep_for(chrono::milliseconds(20));
+        
+        if (i < barWidth) {
+            cout << "\033[1A";  // Move cursor up one line
+            cout << "\r";       // Move cursor to beginning of line
+        }
+    }
+
+    this_thread::sleep_for(chrono::milliseconds(300));
+    clearScreen();
+}
+
+// Get a single character input
+char singleInput() {
+    char ch = getch();
+    cout << ch << "\n";
+    return ch;
+}
+
+// Get masked password input
+string getMaskedPassword() {
+    string password;
+    char ch;
+    
+    while (true) {
+        ch = getch();
+        
+        // Enter key pressed - end input
+        if (ch == '\r' || ch == '\n') {
+            cout << "\n";
+            break;
+        }
+        // Backspace pressed - remove last character
+        else if (ch == '\b' || ch == 127) {
+            if (!password.empty()) {
+                password.pop_back();
+                cout << "\b \b" << flush;
+            }
+        }
+        // Regular character - add to password
+        else {
+            password.push_back(ch);
+            cout << '*' << flush;
+        }
+    }
+    
+    return password;
+}
+
+// Wait for any key press to continue
+void waitForAnyKey() {
+    cout << "\n" << string(YELLOW) << "Press any key to continue..." << string(RESET);
+    getch();  // Wait for any key
+}
+
+// Display a fancy banner
+void displayBanner() {
+    Frame frame;
+    frame.clearScreen().line().line();
+    frame.add(CYAN).add(BOLD);
+    frame.add("╔═══════════════════════════════════════════════════════════════════╗\n");
+    frame.add("║                                                                   ║\n");
+    frame.add("║  ").add(BRIGHT_MAGENTA).add(" ____   __  __  ____    __  __    ___   _   _    ___    ____  ").add(CYAN).add(" ║\n");
+    frame.add("║  ").add(BRIGHT_MAGENTA).add("| __ ) |  \\/  |/ ___|  |  \\/  |  / _ \\ | \\ | |  / _ \\  / ___| ").add(CYAN).add(" ║\n");
+    frame.add("║  ").add(BRIGHT_MAGENTA).add("|  _ \\ | |\\/| |\\___ \\  | |\\/| | | | | ||  \\| | | | | | \\___ \\ ").add(CYAN).add(" ║\n");
+    frame.add("║  ").add(BRIGHT_MAGENTA).add("| |_) || |  | | ___) | | |  | | | |_| || |\\  | | |_| |  ___) |").add(CYAN).add(" ║\n");
+    frame.add("║  ").add(BRIGHT_MAGENTA).add("|____/ |_|  |_||____/  |_|  |_|  \\___/ |_| \\_|  \\___/  |____/ ").add(CYAN).add(" ║\n");
+    frame.add("║                                                                   ║\n");
+    frame.add("╚═══════════════════════════════════════════════════════════════════╝\n");
+    frame.add(RESET);
+    
+    frame.add("\n");
+    frame.centered(string(YELLOW) + string(BOLD) + "WAREHOUSE Management System" + string(RESET));
+    frame.add("\n");
+    
+    frame.centered(string(CYAN) + "╔═════════════════════════════════════════════════════╗");
+    frame.centered(string(CYAN) + "║                  " + string(GREEN) + "Group Members" + string(CYAN) + "                   ║");
+    frame.centered(string(CYAN) + "╠═════════════════════════════════════════════════════╣");
+    frame.centered(string(CYAN) + "║ " + string(BRIGHT_WHITE) + "1. AREEBA TARIQ    - Roll Number: 23021519-099" + string(CYAN) + " ║");
+    // frame.centered(string(CYAN) + "║ " + string(BRIGHT_WHITE) + "2. ABDULLAH NAEEM   - Roll Number: 230121519-088" + string(CYAN) + " ║");
+    frame.centered(string(CYAN) + "╚═════════════════════════════════════════════════════╝");
+    
+    frame.add("\n");
+    frame.centered(string(YELLOW) + "* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *");
+    frame.add("\n");
+    
+    frame.centered(string(BRIGHT_GREEN) + "Press any key to continue..." + string(RESET));
+    frame.present();
+    getch();  // Wait for any key
+}
+
+// Display a framed message box and wait for a key
+void showMessageBox(const string& titleRow, const char* color, const string& message) {
+    string border = string(BOLD) + color;
+    Frame frame;
+    frame.clearScreen().line().line();
+    frame.centered(border + "╔══════════════════════════════════════════════════════════╗");
+    frame.centered(border + "║" + titleRow + "║");
+    frame.centered(border + "╠══════════════════════════════════════════════════════════╣");
+    frame.centered(border + "║                                                          ║");
+    frame.centered(border + "║  " + string(WHITE) + padRight(message, 50) + color + "  ║");
+    frame.centered(border + "║                                                          ║");
+    frame.centered(border + "╚══════════════════════════════════════════════════════════╝");
+    frame.line().line();
+    frame.present();
+    waitForAnyKey();
+}
+
+// Display a success message
+void showSuccess(const string& message) {
+    showMessageBox("                        SUCCESS                           ", GREEN, message);
+}
+
+// Display an error message
+void showError(const string& message) {
+    showMessageBox("                         ERROR                            ", RED, message);
+}
+
+// Display a warning message
+void showWarning(const string& message) {
+    showMessageBox("                        WARNING                           ", YELLOW, message);
+}
+
+// Display a fancy menu header
+void displayMenuHeader(const string& title) {
+    size_t space = title.length() < 50 ? 50 - title.length() : 0;
+    Frame frame;
+    frame.clearScreen().line();
+    frame.centered(string(BOLD) + string(CYAN) + "╔══════════════════════════════════════════════════════════╗");
+    frame.centered(string(BOLD) + string(CYAN) + "║" + string(space / 2, ' ') + string(BRIGHT_WHITE) + title + 
+                   string(CYAN) + string((space + 1) / 2, ' ') + "║");
+    frame.centered(string(BOLD) + string(CYAN) + "╚══════════════════════════════════════════════════════════╝");
+    frame.line();
+    frame.present();
+}
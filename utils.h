@@ -3,30 +3,15 @@
 
 #include <iostream>
 #include <string>
-#include <thread>
-#include <chrono>
-#include <limits>
-#include <random>
-#include <iomanip>
+#include <vector>
 
 #ifdef _WIN32
 #include <conio.h>
 #define CLEAR "cls"
 #define getch _getch
 #else
-#include <termios.h>
-#include <unistd.h>
 #define CLEAR "clear"
-char getch() {
-    struct termios oldt{}, newt{};
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    char ch = getchar();
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    return ch;
-}
+char getch();
 #endif
 
 // Color definitions
@@ -70,195 +55,105 @@ char getch() {
 using namespace std;
 
 // Clear the screen
-void clearScreen() {
-    cout << "\033[2J\033[1;1H";
-}
+void clearScreen();
 
 // Center text on the screen
-void centerText(const string& text) {
-    int screenWidth = 80;
-    int padding = (screenWidth - text.length()) / 2;
-    for (int i = 0; i < padding; ++i) cout << " ";
-    cout << text << endl;
-}
+void centerText(const string& text);
 
-// Generate a random color
-string randomColor() {
-    string colors[] = {RED, GREEN, YELLOW, BLUE, MAGENTA, CYAN};
-    return colors[rand() % 6];
-}
+// Lowercase copy of a string, for case-insensitive matching
+string toLowerCase(string text);
 
-// Enhanced loading screen with animation
-void loadingScreen(const string& message = "Loading...") {
-    const int barWidth = 50;
-    const string progressChars = "▁▂▃▄▅▆▇█";
-    clearScreen();
-    
-    cout << "\n\n";
-    centerText(string(BOLD) + string(CYAN) + "╔══════════════════════════════════════════════════════════╗");
-    centerText(string(BOLD) + string(CYAN) + "║                                                          ║");
-    centerText(string(BOLD) + string(CYAN) + "║  " + string(YELLOW) + message + string(50 - message.length(), ' ') + string(CYAN) + "  ║");
-    centerText(string(BOLD) + string(CYAN) + "║                                                          ║");
-    centerText(string(BOLD) + string(CYAN) + "╚══════════════════════════════════════════════════════════╝");
-    cout << "\n\n";
-
-    // Animated progress bar
-    for (int i = 0; i <= barWidth; ++i) {
-        string progressBar = "[";
-        for (int j = 0; j < i; ++j) progressBar += "█";
-        for (int j = i; j < barWidth; ++j) progressBar += " ";
-        progressBar += "]";
-        
-        centerText(string(BRIGHT_GREEN) + progressBar + " " + to_string(int((i * 100) / barWidth)) + "% " + 
-                  progressChars[i % progressChars.length()]);
-        
-        cout.flush();
-        this_thread::sleep_for(chrono::milliseconds(20));
-        
-        if (i < barWidth) {
-            cout << "\033[1A";  // Move cursor up one line
-            cout << "\r";       // Move cursor to beginning of line
-        }
+// ========== Terminal output layer ==========
+// stdout is fully buffered and flushed only when input is read, and whole
+// screens are composed in a Frame and written at once, so a refresh costs a
+// single write() instead of one per line. ANSI codes are dropped when stdout
+// is not a terminal.
+
+bool stdoutIsTerminal();
+
+// Copy of `text` with ESC [ ... <letter> sequences removed
+string stripAnsi(const string& text);
+
+// Call once at startup, before any output
+void initTerminal();
+
+// Write a rendered buffer to the terminal in one call
+void writeToTerminal(const string& buffer);
+
+// ========== Buffered box rendering ==========
+// Records render into a caller-owned buffer so a whole page can be written at once.
+const size_t BOX_WIDTH = 40;
+const char* const BOX_TOP = "┌─────────────────────────────────────────┐\n";
+const char* const BOX_BOTTOM = "└─────────────────────────────────────────┘\n";
+
+// Append a "│ Label: value   │" row, padded to the box width
+void appendBoxField(string& out, const char* label, const char* value, size_t valueLength);
+void appendBoxField(string& out, const char* label, const string& value);
+void appendBoxField(string& out, const char* label, long long value);
+
+// Append a plain "│ text   │" row
+void appendBoxLine(string& out, const char* text, size_t length);
+
+// A screen composed in memory and presented with one write
+class Frame {
+private:
+    string buffer;
+
+public:
+    Frame(size_t capacity = 4096) {
+        buffer.reserve(capacity);
     }
 
-    this_thread::sleep_for(chrono::milliseconds(300));
-    clearScreen();
-}
+    Frame& clearScreen() { buffer += "\033[2J\033[1;1H"; return *this; }
+    Frame& add(const string& text) { buffer += text; return *this; }
+    Frame& add(const char* text) { buffer += text; return *this; }
+    Frame& line(const string& text = "") { buffer += text; buffer += '\n'; return *this; }
+
+    // Same centering rule as centerText()
+    Frame& centered(const string& text);
+
+    // Left-aligned table row; cells wider than their column are truncated
+    Frame& tableRow(const vector<string>& cells, const vector<size_t>& widths);
+
+    string& raw() { return buffer; }
+
+    void present();
+};
+
+// Pad `text` to `width` columns (never underflows)
+string padRight(const string& text, size_t width);
+
+// Generate a random color
+string randomColor();
+
+// Enhanced loading screen with animation
+void loadingScreen(const string& message = "Loading...");
 
 // Get a single character input
-char singleInput() {
-    char ch = getch();
-    cout << ch << endl;
-    return ch;
-}
+char singleInput();
 
 // Get masked password input
-string getMaskedPassword() {
-    string password;
-    char ch;
-    
-    while (true) {
-        ch = getch();
-        
-        // Enter key pressed - end input
-        if (ch == '\r' || ch == '\n') {
-            cout << endl;
-            break;
-        }
-        // Backspace pressed - remove last character
-        else if (ch == '\b' || ch == 127) {
-            if (!password.empty()) {
-                password.pop_back();
-                cout << "\b \b";
-            }
-        }
-        // Regular character - add to password
-        else {
-            password.push_back(ch);
-            cout << '*';
-        }
-    }
-    
-    return password;
-}
+string getMaskedPassword();
 
 // Wait for any key press to continue
-void waitForAnyKey() {
-    cout << "\n" << string(YELLOW) << "Press any key to continue..." << string(RESET);
-    getch();  // Wait for any key
-}
+void waitForAnyKey();
 
 // Display a fancy banner
-void displayBanner() {
-    clearScreen();
-    
-    cout << "\n\n";
-    cout << string(CYAN) << string(BOLD);
-    cout << "╔═══════════════════════════════════════════════════════════════════╗\n";
-    cout << "║                                                                   ║\n";
-    cout << "║  " << string(BRIGHT_MAGENTA) << " ____   __  __  ____    __  __    ___   _   _    ___    ____  " << string(CYAN) << " ║\n";
-    cout << "║  " << string(BRIGHT_MAGENTA) << "| __ ) |  \\/  |/ ___|  |  \\/  |  / _ \\ | \\ | |  / _ \\  / ___| " << string(CYAN) << " ║\n";
-    cout << "║  " << string(BRIGHT_MAGENTA) << "|  _ \\ | |\\/| |\\___ \\  | |\\/| | | | | ||  \\| | | | | | \\___ \\ " << string(CYAN) << " ║\n";
-    cout << "║  " << string(BRIGHT_MAGENTA) << "| |_) || |  | | ___) | | |  | | | |_| || |\\  | | |_| |  ___) |" << string(CYAN) << " ║\n";
-    cout << "║  " << string(BRIGHT_MAGENTA) << "|____/ |_|  |_||____/  |_|  |_|  \\___/ |_| \\_|  \\___/  |____/ " << string(CYAN) << " ║\n";
-    cout << "║                                                                   ║\n";
-    cout << "╚═══════════════════════════════════════════════════════════════════╝\n";
-    cout << string(RESET);
-    
-    cout << "\n";
-    centerText(string(YELLOW) + string(BOLD) + "WAREHOUSE Management System" + string(RESET));
-    cout << "\n";
-    
-    centerText(string(CYAN) + "╔═════════════════════════════════════════════════════╗");
-    centerText(string(CYAN) + "║                  " + string(GREEN) + "Group Members" + string(CYAN) + "                   ║");
-    centerText(string(CYAN) + "╠═════════════════════════════════════════════════════╣");
-    centerText(string(CYAN) + "║ " + string(BRIGHT_WHITE) + "1. AREEBA TARIQ    - Roll Number: 23021519-099" + string(CYAN) + " ║");
-    // centerText(string(CYAN) + "║ " + string(BRIGHT_WHITE) + "2. ABDULLAH NAEEM   - Roll Number: 230121519-088" + string(CYAN) + " ║");
-    centerText(string(CYAN) + "╚═════════════════════════════════════════════════════╝");
-    
-    cout << "\n";
-    centerText(string(YELLOW) + "* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *");
-    cout << "\n";
-    
-    centerText(string(BRIGHT_GREEN) + "Press any key to continue..." + string(RESET));
-    getch();  // Wait for any key
-}
+void displayBanner();
+
+// Display a framed message box and wait for a key
+void showMessageBox(const string& titleRow, const char* color, const string& message);
 
 // Display a success message
-void showSuccess(const string& message) {
-    clearScreen();
-    cout << "\n\n";
-    centerText(string(BOLD) + string(GREEN) + "╔══════════════════════════════════════════════════════════╗");
-    centerText(string(BOLD) + string(GREEN) + "║                        SUCCESS                           ║");
-    centerText(string(BOLD) + string(GREEN) + "╠══════════════════════════════════════════════════════════╣");
-    centerText(string(BOLD) + string(GREEN) + "║                                                          ║");
-    centerText(string(BOLD) + string(GREEN) + "║  " + string(WHITE) + message + string(50 - message.length(), ' ') + string(GREEN) + "  ║");
-    centerText(string(BOLD) + string(GREEN) + "║                                                          ║");
-    centerText(string(BOLD) + string(GREEN) + "╚══════════════════════════════════════════════════════════╝");
-    cout << "\n\n";
-    waitForAnyKey();
-}
+void showSuccess(const string& message);
 
 // Display an error message
-void showError(const string& message) {
-    clearScreen();
-    cout << "\n\n";
-    centerText(string(BOLD) + string(RED) + "╔══════════════════════════════════════════════════════════╗");
-    centerText(string(BOLD) + string(RED) + "║                         ERROR                            ║");
-    centerText(string(BOLD) + string(RED) + "╠══════════════════════════════════════════════════════════╣");
-    centerText(string(BOLD) + string(RED) + "║                                                          ║");
-    centerText(string(BOLD) + string(RED) + "║  " + string(WHITE) + message + string(50 - message.length(), ' ') + string(RED) + "  ║");
-    centerText(string(BOLD) + string(RED) + "║                                                          ║");
-    centerText(string(BOLD) + string(RED) + "╚══════════════════════════════════════════════════════════╝");
-    cout << "\n\n";
-    waitForAnyKey();
-}
+void showError(const string& message);
 
 // Display a warning message
-void showWarning(const string& message) {
-    clearScreen();
-    cout << "\n\n";
-    centerText(string(BOLD) + string(YELLOW) + "╔══════════════════════════════════════════════════════════╗");
-    centerText(string(BOLD) + string(YELLOW) + "║                        WARNING                           ║");
-    centerText(string(BOLD) + string(YELLOW) + "╠══════════════════════════════════════════════════════════╣");
-    centerText(string(BOLD) + string(YELLOW) + "║                                                          ║");
-    centerText(string(BOLD) + string(YELLOW) + "║  " + string(WHITE) + message + string(50 - message.length(), ' ') + string(YELLOW) + "  ║");
-    centerText(string(BOLD) + string(YELLOW) + "║                                                          ║");
-    centerText(string(BOLD) + string(YELLOW) + "╚══════════════════════════════════════════════════════════╝");
-    cout << "\n\n";
-    waitForAnyKey();
-}
+void showWarning(const string& message);
 
 // Display a fancy menu header
-void displayMenuHeader(const string& title) {
-    clearScreen();
-    cout << "\n";
-    centerText(string(BOLD) + string(CYAN) + "╔══════════════════════════════════════════════════════════╗");
-    centerText(string(BOLD) + string(CYAN) + "║" + string((50 - title.length()) / 2, ' ') + string(BRIGHT_WHITE) + title + 
-              string(CYAN) + string((50 - title.length() + 1) / 2, ' ') + "║");
-    centerText(string(BOLD) + string(CYAN) + "╚══════════════════════════════════════════════════════════╝");
-    cout << "\n";
-}
+void displayMenuHeader(const string& title);
 
 #endif
-
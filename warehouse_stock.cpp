@@ -0,0 +1,298 @@
+#include "warehouse_stock.h"
+#include "storage.h"
+#include "metrics.h"
+#include "trace.h"
+#include <limits>
+
+namespace {
+
+// out[i] += in[i]; contiguous int32 adds, vectorized at -O2 and above
+void addInto(int32_t* out, const int32_t* in, size_t count) {
+    for (size_t i = 0; i < count; ++i) out[i] += in[i];
+}
+
+}  // namespace
+
+WarehouseStock::WarehouseStock(WarehouseStock&& other) noexcept
+    : sites(move(other.sites)),
+      xs(move(other.xs)),
+      ys(move(other.ys)),
+      shards(move(other.shards)),
+      siteOf(move(other.siteOf)),
+      columnOf(move(other.columnOf)),
+      products(move(other.products)) {}
+
+size_t WarehouseStock::site(int warehouseID) const {
+    auto found = siteOf.find(warehouseID);
+    return found == siteOf.end() ? NONE : found->second;
+}
+
+size_t WarehouseStock::column(int productID) const {
+    auto found = columnOf.find(productID);
+    return found == columnOf.end() ? NONE : found->second;
+}
+
+size_t WarehouseStock::addColumn(int productID) {
+    size_t existing = column(productID);
+    if (existing != NONE) return existing;
+    size_t added = products.size();
+    products.push_back(productID);
+    columnOf[productID] = added;
+    for (auto& shard : shards) shard->quantities.push_back(0);
+    return added;
+}
+
+void WarehouseStock::addSite(const Warehouse& warehouse) {
+    siteOf[warehouse.warehouseID] = sites.size();
+    sites.push_back(warehouse);
+    xs.push_back(warehouse.x);
+    ys.push_back(warehouse.y);
+    shards.emplace_back(new Shard());
+    shards.back()->quantities.assign(products.size(), 0);
+}
+
+vector<int32_t> WarehouseStock::columnTotals() const {
+    vector<int32_t> totals(products.size(), 0);
+    for (const auto& shard : shards) {
+        lock_guard<mutex> guard(shard->lock);
+        addInto(totals.data(), shard->quantities.data(), totals.size());
+    }
+    return totals;
+}
+
+bool WarehouseStock::load(const string& warehousesFile, const string& stockFile, size_t& skipped) {
+    TRACE_SCOPE("WarehouseStock::load");
+    unique_lock<shared_mutex> layout(layoutLock);
+    for (const auto& warehouse : Storage::open<Warehouse>(warehousesFile)->loadAll()) {
+        if (site(warehouse.warehouseID) == NONE) addSite(warehouse);
+    }
+    if (sites.empty()) {
+        addSite(Warehouse{1, "Main", 0.0f, 0.0f});
+        if (!Storage::open<Warehouse>(warehousesFile)->saveAll(sites)) return false;
+    }
+
+    skipped = 0;
+    Storage::open<StockLevel>(stockFile)->scan([&](StockLevel& level) {
+        size_t at = site(level.warehouseID);
+        if (at == NONE || level.quantity < 0) {
+            ++skipped;
+            return true;
+        }
+        size_t col = addColumn(level.productID);
+        shards[at]->quantities[col] += level.quantity;
+        return true;
+    });
+    return true;
+}
+
+bool WarehouseStock::save(const string& stockFile) const {
+    return Storage::open<StockLevel>(stockFile)->saveAll(levels());
+}
+
+bool WarehouseStock::saveWarehouses(const string& warehousesFile) const {
+    shared_lock<shared_mutex> layout(layoutLock);
+    return Storage::open<Warehouse>(warehousesFile)->saveAll(sites);
+}
+
+bool WarehouseStock::addWarehouse(const Warehouse& warehouse) {
+    unique_lock<shared_mutex> layout(layoutLock);
+    if (site(warehouse.warehouseID) != NONE) return false;
+    addSite(warehouse);
+    return true;
+}
+
+vector<Warehouse> WarehouseStock::warehouses() const {
+    shared_lock<shared_mutex> layout(layoutLock);
+    return sites;
+}
+
+int WarehouseStock::defaultWarehouse() const {
+    shared_lock<shared_mutex> layout(layoutLock);
+    return sites.empty() ? 0 : sites.front().warehouseID;
+}
+
+int WarehouseStock::available(int productID, int warehouseID) const {
+    shared_lock<shared_mutex> layout(layoutLock);
+    size_t at = site(warehouseID);
+    size_t col = column(productID);
+    if (at == NONE || col == NONE) return 0;
+    lock_guard<mutex> guard(shards[at]->lock);
+    return shards[at]->quantities[col];
+}
+
+bool WarehouseStock::receive(int productID, int warehouseID, int quantity) {
+    if (quantity <= 0) return false;
+    {
+        shared_lock<shared_mutex> layout(layoutLock);
+        size_t at = site(warehouseID);
+        if (at == NONE) return false;
+        size_t col = column(productID);
+        if (col != NONE) {
+            lock_guard<mutex> guard(shards[at]->lock);
+            shards[at]->quantities[col] += quantity;
+            return true;
+        }
+    }
+    // First stock of this product anywhere: add its column
+    unique_lock<shared_mutex> layout(layoutLock);
+    size_t at = site(warehouseID);
+    if (at == NONE) return false;
+    shards[at]->quantities[addColumn(productID)] += quantity;
+    return true;
+}
+
+bool WarehouseStock::take(int productID, int warehouseID, int quantity) {
+    if (quantity <= 0) return false;
+    shared_lock<shared_mutex> layout(layoutLock);
+    size_t at = site(warehouseID);
+    size_t col = column(productID);
+    if (at == NONE || col == NONE) return false;
+    lock_guard<mutex> guard(shards[at]->lock);
+    int32_t& held = shards[at]->quantities[col];
+    if (held < quantity) return false;
+    held -= quantity;
+    return true;
+}
+
+bool WarehouseStock::transfer(int productID, int fromWarehouse, int toWarehouse, int quantity) {
+    static Counter transfers("wms_stock_transfers_total", "Stock moves between warehouses");
+    if (quantity <= 0 || fromWarehouse == toWarehouse) return false;
+    shared_lock<shared_mutex> layout(layoutLock);
+    size_t from = site(fromWarehouse);
+    size_t to = site(toWarehouse);
+    size_t col = column(productID);
+    if (from == NONE || to == NONE || col == NONE) return false;
+    // scoped_lock orders the two locks, so opposite transfers cannot deadlock
+    scoped_lock guard(shards[from]->lock, shards[to]->lock);
+    int32_t& held = shards[from]->quantities[col];
+    if (held < quantity) return false;
+    held -= quantity;
+    shards[to]->quantities[col] += quantity;
+    transfers.increment();
+    return true;
+}
+
+int WarehouseStock::total(int productID) const {
+    shared_lock<shared_mutex> layout(layoutLock);
+    size_t col = column(productID);
+    if (col == NONE) return 0;
+    int sum = 0;
+    for (const auto& shard : shards) {
+        lock_guard<mutex> guard(shard->lock);
+        sum += shard->quantities[col];
+    }
+    return sum;
+}
+
+void WarehouseStock::totals(vector<int>& productIDs, vector<int32_t>& quantities) const {
+    shared_lock<shared_mutex> layout(layoutLock);
+    productIDs = products;
+    quantities = columnTotals();
+}
+
+long long WarehouseStock::unitsAt(int warehouseID) const {
+    shared_lock<shared_mutex> layout(layoutLock);
+    size_t at = site(warehouseID);
+    if (at == NONE) return 0;
+    lock_guard<mutex> guard(shards[at]->lock);
+    const int32_t* quantities = shards[at]->quantities.data();
+    long long sum = 0;
+    for (size_t i = 0; i < products.size(); ++i) sum += quantities[i];
+    return sum;
+}
+
+int WarehouseStock::nearestWithStock(int productID, int quantity, int originWarehouse) const {
+    shared_lock<shared_mutex> layout(layoutLock);
+    size_t col = column(productID);
+    if (col == NONE) return 0;
+    size_t origin = site(originWarehouse);
+    float originX = origin == NONE ? 0.0f : xs[origin];
+    float originY = origin == NONE ? 0.0f : ys[origin];
+
+    size_t count = sites.size();
+    vector<int32_t> held(count);
+    for (size_t s = 0; s < count; ++s) {
+        lock_guard<mutex> guard(shards[s]->lock);
+        held[s] = shards[s]->quantities[col];
+    }
+
+    // Squared distance, or infinity where the stock is short. Written as a
+    // store then an overwrite, which GCC turns into a masked vector store;
+    // it leaves a ternary as a branch
+    const float far = numeric_limits<float>::infinity();
+    vector<float> distance(count);
+    const float* x = xs.data();
+    const float* y = ys.data();
+    const int32_t* units = held.data();
+    float* out = distance.data();
+    for (size_t s = 0; s < count; ++s) {
+        float dx = x[s] - originX;
+        float dy = y[s] - originY;
+        out[s] = dx * dx + dy * dy;
+        if (units[s] < quantity) out[s] = far;
+    }
+
+    size_t best = NONE;
+    float bestDistance = far;
+    for (size_t s = 0; s < count; ++s) {
+        if (distance[s] < bestDistance) {
+            bestDistance = distance[s];
+            best = s;
+        }
+    }
+    return best == NONE ? 0 : sites[best].warehouseID;
+}
+
+size_t WarehouseStock::reconcile(const vector<Product>& inventory) {
+    TRACE_SCOPE("WarehouseStock::reconcile");
+    unique_lock<shared_mutex> layout(layoutLock);
+    if (sites.empty()) return 0;
+
+    vector<char> listed(products.size(), 0);
+    for (const auto& product : inventory) {
+        size_t col = addColumn(product.getID());
+        if (col >= listed.size()) listed.resize(col + 1, 0);
+        listed[col] = 1;
+    }
+    vector<int32_t> totals = columnTotals();
+
+    size_t changed = 0;
+    for (size_t col = 0; col < products.size(); ++col) {
+        if (listed[col] || totals[col] == 0) continue;
+        for (auto& shard : shards) shard->quantities[col] = 0;
+        ++changed;
+    }
+    for (const auto& product : inventory) {
+        size_t col = column(product.getID());
+        int32_t difference = product.getQuantity() - totals[col];
+        if (difference == 0) continue;
+        ++changed;
+        totals[col] = product.getQuantity();
+        if (difference > 0) {
+            shards.front()->quantities[col] += difference;
+            continue;
+        }
+        // Remove from the default warehouse first, then the others in order
+        int32_t excess = -difference;
+        for (auto& shard : shards) {
+            int32_t removed = min(excess, shard->quantities[col]);
+            shard->quantities[col] -= removed;
+            excess -= removed;
+            if (excess == 0) break;
+        }
+    }
+    return changed;
+}
+
+vector<StockLevel> WarehouseStock::levels() const {
+    shared_lock<shared_mutex> layout(layoutLock);
+    vector<StockLevel> cells;
+    for (size_t s = 0; s < sites.size(); ++s) {
+        lock_guard<mutex> guard(shards[s]->lock);
+        const vector<int32_t>& quantities = shards[s]->quantities;
+        for (size_t col = 0; col < products.size(); ++col) {
+            if (quantities[col] != 0) cells.push_back(StockLevel{products[col], sites[s].warehouseID, quantities[col]});
+        }
+    }
+    return cells;
+}
@@ -0,0 +1,132 @@
+#ifndef WAREHOUSE_STOCK_H
+#define WAREHOUSE_STOCK_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <cstdint>
+#include "product.h"
+#include "repository.h"
+
+using namespace std;
+
+struct Warehouse {
+    int warehouseID;
+    string name;
+    float x;  // position on a km grid, for picking the nearest site
+    float y;
+};
+
+// One cell of the stock matrix, as stored
+struct StockLevel {
+    int productID;
+    int warehouseID;
+    int quantity;
+};
+
+// Stock per product and warehouse. Each warehouse owns a dense array of
+// quantities with one column per product, behind its own lock and on its
+// own cache lines, so threads working on different warehouses never
+// contend. Queries across warehouses run over those arrays as plain loops
+// the compiler vectorizes.
+//
+// Product::quantity stays the total over all warehouses. reconcile() books
+// changes made to it elsewhere (adding, editing or importing products) at
+// the default warehouse.
+class WarehouseStock {
+private:
+    struct alignas(64) Shard {
+        mutex lock;
+        vector<int32_t> quantities;  // one per column
+    };
+
+    // Shared to read or change stock, exclusive to add a warehouse or column
+    mutable shared_mutex layoutLock;
+    vector<Warehouse> sites;
+    vector<float> xs;  // site positions, kept apart for the distance loop
+    vector<float> ys;
+    vector<unique_ptr<Shard>> shards;  // parallel to sites
+    unordered_map<int, size_t> siteOf;
+    unordered_map<int, size_t> columnOf;
+    vector<int> products;  // column -> productID
+
+    static const size_t NONE = static_cast<size_t>(-1);
+
+    // With layoutLock held either way; NONE if unknown
+    size_t site(int warehouseID) const;
+    size_t column(int productID) const;
+    // With layoutLock held exclusively
+    size_t addColumn(int productID);
+    void addSite(const Warehouse& warehouse);
+    // Per-column totals over every warehouse, with layoutLock held
+    vector<int32_t> columnTotals() const;
+
+public:
+    WarehouseStock() {}
+    // Only for handing over a store no other thread is using yet
+    WarehouseStock(WarehouseStock&& other) noexcept;
+
+    // Read the warehouses and stock levels. With no warehouses on file a
+    // default one is created, holding nothing until reconcile(). `skipped`
+    // counts stock levels left out for unknown warehouses or negative amounts.
+    bool load(const string& warehousesFile, const string& stockFile, size_t& skipped);
+    bool save(const string& stockFile) const;
+    bool saveWarehouses(const string& warehousesFile) const;
+
+    // False if the ID is taken
+    bool addWarehouse(const Warehouse& warehouse);
+    vector<Warehouse> warehouses() const;
+    // The first warehouse, 0 if there are none
+    int defaultWarehouse() const;
+
+    int available(int productID, int warehouseID) const;
+    bool receive(int productID, int warehouseID, int quantity);
+    // False, taking nothing, if the warehouse holds less than `quantity`
+    bool take(int productID, int warehouseID, int quantity);
+    bool transfer(int productID, int fromWarehouse, int toWarehouse, int quantity);
+
+    int total(int productID) const;
+    // Totals over all warehouses for every product on record, parallel to
+    // `productIDs`
+    void totals(vector<int>& productIDs, vector<int32_t>& quantities) const;
+    // Units of every product held at one warehouse
+    long long unitsAt(int warehouseID) const;
+    // The warehouse closest to `originWarehouse` holding at least
+    // `quantity`, the origin itself included; 0 if none does
+    int nearestWithStock(int productID, int quantity, int originWarehouse) const;
+
+    // Make each product's total match its quantity, adding or removing the
+    // difference at the default warehouse (and taking any shortfall from
+    // the others). Products not in `inventory` are emptied. Returns how
+    // many products changed.
+    size_t reconcile(const vector<Product>& inventory);
+
+    // Every non-zero cell
+    vector<StockLevel> levels() const;
+};
+
+template <>
+struct EntityTraits<Warehouse> {
+    static constexpr auto fields = make_tuple(
+        field("warehouseID", &Warehouse::warehouseID),
+        field("name", &Warehouse::name),
+        field("x", &Warehouse::x),
+        field("y", &Warehouse::y));
+
+    static int keyOf(const Warehouse& warehouse) { return warehouse.warehouseID; }
+};
+
+template <>
+struct EntityTraits<StockLevel> {
+    static constexpr auto fields = make_tuple(
+        field("productID", &StockLevel::productID),
+        field("warehouseID", &StockLevel::warehouseID),
+        field("quantity", &StockLevel::quantity));
+
+    static int keyOf(const StockLevel& level) { return level.productID; }
+};
+
+#endif